@@ -0,0 +1,72 @@
+#include "ImageWriter.h"
+#include "core/Logger.h"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "third_party/stb_image_write.h"
+
+#include <fstream>
+
+bool WriteImage(const std::string& path, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgba)
+{
+    const size_t dot = path.find_last_of('.');
+    const std::string ext = dot == std::string::npos ? "" : path.substr(dot);
+
+    if (ext == ".png" || ext == ".PNG")
+        return WritePNG(path, width, height, rgba);
+
+    return WritePPM(path, width, height, rgba);
+}
+
+bool WritePPM(const std::string& path, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgba)
+{
+    if (rgba.size() < size_t(width) * height * 4)
+    {
+        LOG_ERROR("WritePPM: pixel buffer too small for " + path);
+        return false;
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+    {
+        LOG_ERROR("WritePPM: cannot open " + path);
+        return false;
+    }
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+
+    std::vector<uint8_t> row(size_t(width) * 3);
+    for (uint32_t y = 0; y < height; y++)
+    {
+        const uint8_t* src = rgba.data() + size_t(y) * width * 4;
+        for (uint32_t x = 0; x < width; x++)
+        {
+            row[x * 3 + 0] = src[x * 4 + 0];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 2];
+        }
+        file.write(reinterpret_cast<const char*>(row.data()), (std::streamsize)row.size());
+    }
+
+    if (!file)
+    {
+        LOG_ERROR("WritePPM: write failed for " + path);
+        return false;
+    }
+    return true;
+}
+
+bool WritePNG(const std::string& path, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgba)
+{
+    if (rgba.size() < size_t(width) * height * 4)
+    {
+        LOG_ERROR("WritePNG: pixel buffer too small for " + path);
+        return false;
+    }
+
+    if (!stbi_write_png(path.c_str(), (int)width, (int)height, 4, rgba.data(), (int)(width * 4)))
+    {
+        LOG_ERROR("WritePNG: write failed for " + path);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Saves tightly packed 8-bit RGBA pixels (rows top to bottom).
+// The format follows the extension: ".png", anything else is binary PPM (P6,
+// alpha dropped). Returns false and logs on failure.
+bool WriteImage(const std::string& path, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgba);
+
+bool WritePPM(const std::string& path, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgba);
+bool WritePNG(const std::string& path, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgba);
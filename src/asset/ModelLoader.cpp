@@ -71,7 +71,9 @@ static void ProcessMesh(
 )
 {
     std::vector<Vertex3D> vertices;
+    std::vector<glm::vec3> positions; // split out for the depth pre-pass
     std::vector<uint32_t> indices;
+    AABB bounds;
 
     for (uint32_t i = 0; i < mesh->mNumVertices; i++)
     {
@@ -84,7 +86,9 @@ static void ProcessMesh(
         if (mesh->mTextureCoords[0])
             v.uv = { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y };
 
+        bounds.Expand(v.position);
         vertices.push_back(v);
+        positions.push_back(v.position);
     }
 
     for (uint32_t i = 0; i < mesh->mNumFaces; i++)
@@ -104,6 +108,8 @@ static void ProcessMesh(
         sizeof(uint32_t) * indices.size(),
         (uint32_t)indices.size()
     );
+    lm.mesh->SetLocalBounds(bounds);
+    lm.mesh->SetPositionStream(positions.data(), (uint32_t)positions.size());
 
     aiMaterial* mat = scene->mMaterials[mesh->mMaterialIndex];
 
@@ -114,9 +120,41 @@ static void ProcessMesh(
 }
 
 
+// Depth-first, so every parent is listed before its children
+static void CollectNodes(const aiNode* root, std::vector<LoadedNode>& out)
+{
+    std::vector<std::pair<const aiNode*, int32_t>> stack = { { root, -1 } };
+
+    while (!stack.empty())
+    {
+        auto [node, parent] = stack.back();
+        stack.pop_back();
+
+        aiVector3D scaling, position;
+        aiQuaternion rotation;
+        node->mTransformation.Decompose(scaling, rotation, position);
+
+        LoadedNode ln{};
+        ln.name = node->mName.C_Str();
+        ln.parent = parent;
+        ln.position = { position.x, position.y, position.z };
+        ln.rotation = glm::quat(rotation.w, rotation.x, rotation.y, rotation.z);
+        ln.scale = { scaling.x, scaling.y, scaling.z };
+        ln.meshes.assign(node->mMeshes, node->mMeshes + node->mNumMeshes);
+
+        const int32_t index = (int32_t)out.size();
+        out.push_back(std::move(ln));
+
+        for (uint32_t i = node->mNumChildren; i > 0; i--)
+            stack.push_back({ node->mChildren[i - 1], index });
+    }
+}
+
+
 std::vector<LoadedMesh> ModelLoader::LoadStaticModel(
     VulkanDevice* device,
-    const std::string& path
+    const std::string& path,
+    std::vector<LoadedNode>* nodes
 )
 {
     Assimp::Importer importer;
@@ -141,5 +179,8 @@ std::vector<LoadedMesh> ModelLoader::LoadStaticModel(
         ProcessMesh(scene->mMeshes[i], scene, device, baseDir, meshes);
     }
 
+    if (nodes)
+        CollectNodes(scene->mRootNode, *nodes);
+
     return meshes;
 }
\ No newline at end of file
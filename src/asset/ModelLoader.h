@@ -4,6 +4,8 @@
 #include <memory>
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstdint>
 
 class VulkanDevice;
 class Mesh;
@@ -18,11 +20,27 @@ struct LoadedMesh
     std::string normalPath;
 };
 
+// Node of the imported hierarchy (local TRS relative to the parent).
+// Nodes are listed parents first.
+struct LoadedNode
+{
+    std::string name;
+    int32_t parent = -1;
+
+    glm::vec3 position{ 0.0f };
+    glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+    glm::vec3 scale{ 1.0f };
+
+    std::vector<uint32_t> meshes; // indices into the returned meshes
+};
+
 class ModelLoader
 {
 public:
+    // nodes (optional) receives the scene's node hierarchy
     static std::vector<LoadedMesh> LoadStaticModel(
         VulkanDevice* device,
-        const std::string& path
+        const std::string& path,
+        std::vector<LoadedNode>* nodes = nullptr
     );
 };
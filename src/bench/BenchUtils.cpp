@@ -0,0 +1,96 @@
+#include "BenchUtils.h"
+
+#include "renderer/VulkanDevice.h"
+#include "renderer/VulkanProfiler.h"
+#include "core/Logger.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+double MillisecondsSince(BenchClock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+double NowSeconds()
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string Fixed(double v, int decimals)
+{
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    return buf;
+}
+
+// --- BenchGpuTimer ---
+
+BenchGpuTimer::BenchGpuTimer(VulkanDevice* device, uint32_t framesInFlight, const std::string& owner)
+    : m_Device(device)
+{
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(m_Device->GetPhysicalDevice(), &props);
+    m_TimestampPeriod = props.limits.timestampPeriod;
+    m_TimestampMask = VulkanProfiler::GetTimestampMask(m_Device);
+
+    if (props.limits.timestampComputeAndGraphics != VK_TRUE || m_TimestampMask == 0)
+    {
+        LOG_WARN(owner + ": timestamps not supported on graphics queues, GPU times unavailable");
+        return;
+    }
+
+    VkQueryPoolCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    info.queryCount = 2 * framesInFlight;
+
+    if (vkCreateQueryPool(m_Device->GetHandle(), &info, nullptr, &m_QueryPool) != VK_SUCCESS)
+        throw std::runtime_error("BenchGpuTimer: failed to create timestamp query pool");
+}
+
+BenchGpuTimer::~BenchGpuTimer()
+{
+    if (m_QueryPool)
+        vkDestroyQueryPool(m_Device->GetHandle(), m_QueryPool, nullptr);
+}
+
+void BenchGpuTimer::WriteStart(VkCommandBuffer cmd, uint32_t frameIndex)
+{
+    if (!m_QueryPool)
+        return;
+
+    vkCmdResetQueryPool(cmd, m_QueryPool, 2 * frameIndex, 2);
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_QueryPool, 2 * frameIndex);
+}
+
+void BenchGpuTimer::WriteEnd(VkCommandBuffer cmd, uint32_t frameIndex)
+{
+    if (m_QueryPool)
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_QueryPool, 2 * frameIndex + 1);
+}
+
+bool BenchGpuTimer::Read(uint32_t frameIndex, double& gpuMs) const
+{
+    if (!m_QueryPool)
+        return false;
+
+    uint64_t ticks[2] = {};
+    VkResult result = vkGetQueryPoolResults(
+        m_Device->GetHandle(),
+        m_QueryPool,
+        2 * frameIndex,
+        2,
+        sizeof(ticks),
+        ticks,
+        sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT);
+
+    if (result != VK_SUCCESS)
+        return false;
+
+    const uint64_t delta = VulkanProfiler::TimestampDelta(ticks[0], ticks[1], m_TimestampMask);
+    gpuMs = double(delta) * m_TimestampPeriod * 1.0e-6;
+    return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <chrono>
+#include <string>
+#include <cstdint>
+
+class VulkanDevice;
+
+// Helpers shared by the benchmarks
+
+using BenchClock = std::chrono::high_resolution_clock;
+
+double MillisecondsSince(BenchClock::time_point start);
+
+// Seconds since the first call, on a steady clock (frame timing; headless
+// runs never initialize GLFW, so no glfwGetTime())
+double NowSeconds();
+
+// v with a fixed number of decimals (log lines, JSON)
+std::string Fixed(double v, int decimals = 2);
+
+// GPU time of a frame: two timestamps per frame slot around everything the
+// frame records, read back once the slot comes around again. Timestamps are
+// masked to the graphics queue's valid bits and may wrap once.
+class BenchGpuTimer
+{
+public:
+    // owner: prefix of the warning when the graphics queue has no timestamps
+    BenchGpuTimer(VulkanDevice* device, uint32_t framesInFlight, const std::string& owner);
+    ~BenchGpuTimer();
+
+    bool IsSupported() const { return m_QueryPool != VK_NULL_HANDLE; }
+
+    // Outside render passes; no-ops when unsupported
+    void WriteStart(VkCommandBuffer cmd, uint32_t frameIndex);
+    void WriteEnd(VkCommandBuffer cmd, uint32_t frameIndex);
+
+    // After the slot's frame wait. false: unsupported or no result
+    bool Read(uint32_t frameIndex, double& gpuMs) const;
+
+private:
+    VulkanDevice* m_Device = nullptr;
+    VkQueryPool m_QueryPool = VK_NULL_HANDLE; // 2 timestamps per frame slot
+    double   m_TimestampPeriod = 1.0;         // ns per tick
+    uint64_t m_TimestampMask = ~0ull;
+};
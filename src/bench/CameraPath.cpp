@@ -0,0 +1,156 @@
+#include "CameraPath.h"
+
+#include "renderer/Camera.h"
+#include "core/Logger.h"
+
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+template<typename T>
+static T CatmullRom(const T& p0, const T& p1, const T& p2, const T& p3, float u)
+{
+    const float u2 = u * u;
+    const float u3 = u2 * u;
+
+    return 0.5f * ((2.0f * p1) +
+        (p2 - p0) * u +
+        (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * u2 +
+        (3.0f * p1 - p0 - 3.0f * p2 + p3) * u3);
+}
+
+CameraPath CameraPath::Orbit(const glm::vec3& center, float radius, float height, float duration, uint32_t keyCount)
+{
+    CameraPath path;
+    keyCount = std::max(keyCount, 4u);
+
+    // Looking at the center from (sin a, h, cos a): yaw = -a, constant pitch
+    const float pitch = std::atan2(-height, radius);
+
+    for (uint32_t i = 0; i <= keyCount; i++)
+    {
+        const float a = glm::two_pi<float>() * float(i) / float(keyCount);
+
+        Key key;
+        key.time = duration * float(i) / float(keyCount);
+        key.position = center + glm::vec3(radius * std::sin(a), height, radius * std::cos(a));
+        key.yaw = -a;
+        key.pitch = pitch;
+        path.AddKey(key);
+    }
+
+    return path;
+}
+
+bool CameraPath::Load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        LOG_WARN("CameraPath: cannot open " + path);
+        return false;
+    }
+
+    std::vector<Key> keys;
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.resize(comment);
+
+        std::istringstream in(line);
+        Key key;
+        float yawDeg = 0.0f, pitchDeg = 0.0f;
+
+        if (!(in >> key.time >> key.position.x >> key.position.y >> key.position.z >> yawDeg >> pitchDeg))
+            continue; // blank or malformed
+
+        if (!keys.empty() && key.time < keys.back().time)
+        {
+            LOG_WARN("CameraPath: key times must increase in " + path);
+            return false;
+        }
+
+        key.yaw = glm::radians(yawDeg);
+        key.pitch = glm::radians(pitchDeg);
+        keys.push_back(key);
+    }
+
+    if (keys.empty())
+    {
+        LOG_WARN("CameraPath: no keys in " + path);
+        return false;
+    }
+
+    m_Keys = std::move(keys);
+    return true;
+}
+
+bool CameraPath::Save(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        LOG_WARN("CameraPath: cannot write " + path);
+        return false;
+    }
+
+    file << "# time x y z yawDegrees pitchDegrees\n";
+    for (const Key& key : m_Keys)
+    {
+        file << key.time << " "
+            << key.position.x << " " << key.position.y << " " << key.position.z << " "
+            << glm::degrees(key.yaw) << " " << glm::degrees(key.pitch) << "\n";
+    }
+
+    return true;
+}
+
+CameraPath::Key CameraPath::Sample(float time) const
+{
+    if (m_Keys.empty())
+        return {};
+
+    const float duration = GetDuration();
+    if (m_Keys.size() == 1 || duration <= 0.0f)
+        return m_Keys.front();
+
+    float t = time - std::floor(time / duration) * duration;
+    t = std::max(t, m_Keys.front().time);
+
+    // Segment [i, i + 1] containing t
+    auto next = std::upper_bound(m_Keys.begin(), m_Keys.end(), t,
+        [](float value, const Key& key) { return value < key.time; });
+
+    const size_t last = m_Keys.size() - 1;
+    const size_t i = std::min(size_t(std::max<ptrdiff_t>(next - m_Keys.begin() - 1, 0)), last - 1);
+
+    const Key& k0 = m_Keys[i > 0 ? i - 1 : i];
+    const Key& k1 = m_Keys[i];
+    const Key& k2 = m_Keys[i + 1];
+    const Key& k3 = m_Keys[std::min(i + 2, last)];
+
+    const float span = k2.time - k1.time;
+    const float u = span > 0.0f ? std::min((t - k1.time) / span, 1.0f) : 0.0f;
+
+    Key out;
+    out.time = t;
+    out.position = CatmullRom(k0.position, k1.position, k2.position, k3.position, u);
+    out.yaw = CatmullRom(k0.yaw, k1.yaw, k2.yaw, k3.yaw, u);
+    out.pitch = CatmullRom(k0.pitch, k1.pitch, k2.pitch, k3.pitch, u);
+    return out;
+}
+
+void CameraPath::Apply(Camera& camera, float time) const
+{
+    if (m_Keys.empty())
+        return;
+
+    const Key key = Sample(time);
+    camera.SetPosition(key.position);
+    camera.SetYawPitch(key.yaw, key.pitch);
+}
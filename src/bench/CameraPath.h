@@ -0,0 +1,43 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+class Camera;
+
+// Timed camera keyframes, sampled as a Catmull-Rom spline through the
+// positions (and yaw / pitch). Sampling past the last key wraps around,
+// so a path can drive any number of frames.
+// File format, one key per line ('#' starts a comment):
+//   time x y z yawDegrees pitchDegrees
+class CameraPath
+{
+public:
+    struct Key
+    {
+        float time = 0.0f;
+        glm::vec3 position{ 0.0f };
+        float yaw = 0.0f;   // radians
+        float pitch = 0.0f; // radians
+    };
+
+    // Scripted orbit around center, looking at it. Closed loop.
+    static CameraPath Orbit(const glm::vec3& center, float radius, float height, float duration, uint32_t keyCount = 16);
+
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+
+    // Keys must be added in increasing time
+    void AddKey(const Key& key) { m_Keys.push_back(key); }
+    void Clear() { m_Keys.clear(); }
+
+    bool IsEmpty() const { return m_Keys.empty(); }
+    size_t GetKeyCount() const { return m_Keys.size(); }
+    float GetDuration() const { return m_Keys.empty() ? 0.0f : m_Keys.back().time; }
+
+    Key Sample(float time) const;
+    void Apply(Camera& camera, float time) const;
+
+private:
+    std::vector<Key> m_Keys;
+};
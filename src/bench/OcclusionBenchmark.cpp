@@ -0,0 +1,421 @@
+#include "OcclusionBenchmark.h"
+#include "BenchUtils.h"
+
+#include "renderer/culling/SoftwareOcclusion.h"
+#include "renderer/Camera.h"
+#include "renderer/Frustum.h"
+#include "core/ThreadPool.h"
+#include "core/Logger.h"
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+// --- Synthetic scene ---
+
+static constexpr int   CITY_BLOCKS = 24;      // blocks per side
+static constexpr float BLOCK_SPACING = 16.0f; // street grid
+static constexpr int   OBJECT_COUNT = 30000;
+static constexpr int   TIMING_ITERATIONS = 20;
+
+struct BenchScene
+{
+    std::vector<AABB> buildings;
+    std::vector<OccluderMesh> buildingMeshes;
+    std::vector<AABB> objects;
+};
+
+static BenchScene BuildScene()
+{
+    BenchScene scene;
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> footprint(8.0f, 13.0f);
+    std::uniform_real_distribution<float> height(6.0f, 40.0f);
+
+    const float half = CITY_BLOCKS * BLOCK_SPACING * 0.5f;
+
+    for (int z = 0; z < CITY_BLOCKS; z++)
+    {
+        for (int x = 0; x < CITY_BLOCKS; x++)
+        {
+            glm::vec3 center(
+                -half + (x + 0.5f) * BLOCK_SPACING,
+                0.0f,
+                -half + (z + 0.5f) * BLOCK_SPACING
+            );
+            float w = footprint(rng) * 0.5f;
+            float d = footprint(rng) * 0.5f;
+
+            AABB box;
+            box.min = { center.x - w, 0.0f, center.z - d };
+            box.max = { center.x + w, height(rng), center.z + d };
+
+            scene.buildings.push_back(box);
+        }
+    }
+
+    // Meshes are built once the vector is final (occluders are referenced by pointer)
+    for (const AABB& box : scene.buildings)
+        scene.buildingMeshes.push_back(OccluderMesh::FromAABB(box));
+
+    std::uniform_real_distribution<float> position(-half, half);
+    std::uniform_real_distribution<float> size(0.3f, 2.5f);
+    std::uniform_real_distribution<float> lift(0.0f, 4.0f);
+
+    while ((int)scene.objects.size() < OBJECT_COUNT)
+    {
+        glm::vec3 p(position(rng), lift(rng), position(rng));
+        glm::vec3 e(size(rng), size(rng), size(rng));
+
+        AABB box;
+        box.min = p;
+        box.max = p + e;
+
+        // Keep objects out of the buildings (those would be trivially hidden)
+        int cx = std::clamp(int((p.x + half) / BLOCK_SPACING), 0, CITY_BLOCKS - 1);
+        int cz = std::clamp(int((p.z + half) / BLOCK_SPACING), 0, CITY_BLOCKS - 1);
+        const AABB& b = scene.buildings[cz * CITY_BLOCKS + cx];
+
+        bool overlaps =
+            box.max.x > b.min.x && box.min.x < b.max.x &&
+            box.max.z > b.min.z && box.min.z < b.max.z &&
+            box.min.y < b.max.y;
+
+        if (!overlaps)
+            scene.objects.push_back(box);
+    }
+
+    return scene;
+}
+
+// Street-level viewpoints (streets run along multiples of BLOCK_SPACING)
+static std::vector<Camera> BuildViews()
+{
+    std::vector<Camera> views;
+
+    const float positions[][3] = {
+        {   0.0f, 1.8f,    0.0f },
+        {  32.0f, 1.8f,  -80.0f },
+        { -64.0f, 1.8f,   40.0f },
+        {  96.0f, 1.8f,   96.0f },
+        {   0.0f, 25.0f, 150.0f },
+        { -150.0f, 60.0f, -150.0f },
+    };
+    const float yaws[] = { 0.0f, 0.7f, 1.571f, 2.4f, 3.1f, 3.93f };
+
+    for (const auto& p : positions)
+    {
+        for (float yaw : yaws)
+        {
+            Camera cam;
+            cam.SetPosition({ p[0], p[1], p[2] });
+            cam.SetYawPitch(yaw, p[1] > 10.0f ? -0.35f : 0.0f);
+            cam.SetPerspective(glm::radians(60.0f), 0.1f, 1000.0f);
+            views.push_back(cam);
+        }
+    }
+
+    return views;
+}
+
+// --- Exact reference ---
+
+// Scalar double-precision z-buffer at the culler's resolution. A box counts
+// as visible if any of its own fragments passes a LESS test against the
+// occluders, i.e. what the GPU would produce for the bounding box.
+class ReferenceRasterizer
+{
+public:
+    ReferenceRasterizer(uint32_t width, uint32_t height)
+        : m_Width(width), m_Height(height), m_Depth(size_t(width) * height, DBL_MAX) {}
+
+    void Clear() { std::fill(m_Depth.begin(), m_Depth.end(), DBL_MAX); }
+
+    // write = depth update, otherwise returns true on the first passing fragment
+    bool DrawBox(const AABB& box, const glm::mat4& viewProj, bool write)
+    {
+        OccluderMesh mesh = OccluderMesh::FromAABB(box);
+
+        glm::dvec4 clip[8];
+        for (int i = 0; i < 8; i++)
+        {
+            glm::vec4 c = viewProj * glm::vec4(mesh.positions[i], 1.0f);
+            clip[i] = glm::dvec4(c.x, c.y, c.z, c.w);
+        }
+
+        bool anyVisible = false;
+        for (size_t i = 0; i < mesh.indices.size(); i += 3)
+        {
+            glm::dvec4 tri[3] = { clip[mesh.indices[i]], clip[mesh.indices[i + 1]], clip[mesh.indices[i + 2]] };
+            if (DrawTriangle(tri, write))
+            {
+                anyVisible = true;
+                if (!write)
+                    return true;
+            }
+        }
+        return anyVisible;
+    }
+
+private:
+    bool DrawTriangle(const glm::dvec4 in[3], bool write)
+    {
+        // Clip against near (z >= 0) and far (z <= w); sides are handled by the screen clamp
+        glm::dvec4 poly[5] = { in[0], in[1], in[2] };
+        glm::dvec4 next[5];
+        int count = 3;
+
+        for (int plane = 0; plane < 2 && count >= 3; plane++)
+        {
+            int n = 0;
+            for (int i = 0; i < count; i++)
+            {
+                const glm::dvec4& a = poly[i];
+                const glm::dvec4& b = poly[(i + 1) % count];
+                double da = plane == 0 ? a.z : a.w - a.z;
+                double db = plane == 0 ? b.z : b.w - b.z;
+
+                if (da >= 0.0) next[n++] = a;
+                if ((da >= 0.0) != (db >= 0.0)) next[n++] = a + (b - a) * (da / (da - db));
+            }
+            count = n;
+            for (int i = 0; i < count; i++) poly[i] = next[i];
+        }
+
+        bool anyPassed = false;
+        for (int i = 2; i < count; i++)
+        {
+            if (DrawClipped(poly[0], poly[i - 1], poly[i], write))
+            {
+                anyPassed = true;
+                if (!write)
+                    return true;
+            }
+        }
+        return anyPassed;
+    }
+
+    bool DrawClipped(const glm::dvec4& c0, const glm::dvec4& c1, const glm::dvec4& c2, bool write)
+    {
+        glm::dvec3 s[3];
+        const glm::dvec4* c[3] = { &c0, &c1, &c2 };
+        for (int i = 0; i < 3; i++)
+        {
+            s[i] = glm::dvec3(
+                (c[i]->x / c[i]->w * 0.5 + 0.5) * m_Width,
+                (c[i]->y / c[i]->w * 0.5 + 0.5) * m_Height,
+                c[i]->z / c[i]->w
+            );
+        }
+
+        double area = (s[1].x - s[0].x) * (s[2].y - s[0].y) - (s[2].x - s[0].x) * (s[1].y - s[0].y);
+        if (std::fabs(area) < 1e-12)
+            return false;
+
+        // Clamp in double first: unclipped sides can project far off screen
+        auto clampX = [this](double v) { return std::clamp(v, -1.0, double(m_Width)); };
+        auto clampY = [this](double v) { return std::clamp(v, -1.0, double(m_Height)); };
+
+        int x0 = std::max(0, (int)std::ceil(clampX(std::min({ s[0].x, s[1].x, s[2].x })) - 0.5));
+        int x1 = std::min((int)m_Width - 1, (int)std::floor(clampX(std::max({ s[0].x, s[1].x, s[2].x })) - 0.5));
+        int y0 = std::max(0, (int)std::ceil(clampY(std::min({ s[0].y, s[1].y, s[2].y })) - 0.5));
+        int y1 = std::min((int)m_Height - 1, (int)std::floor(clampY(std::max({ s[0].y, s[1].y, s[2].y })) - 0.5));
+
+        bool anyPassed = false;
+
+        for (int y = y0; y <= y1; y++)
+        {
+            for (int x = x0; x <= x1; x++)
+            {
+                double px = x + 0.5, py = y + 0.5;
+
+                // Barycentrics, sign-normalized by the area
+                double w0 = ((s[1].x - px) * (s[2].y - py) - (s[2].x - px) * (s[1].y - py)) / area;
+                double w1 = ((s[2].x - px) * (s[0].y - py) - (s[0].x - px) * (s[2].y - py)) / area;
+                double w2 = 1.0 - w0 - w1;
+                if (w0 < 0.0 || w1 < 0.0 || w2 < 0.0)
+                    continue;
+
+                double z = w0 * s[0].z + w1 * s[1].z + w2 * s[2].z;
+                double& d = m_Depth[size_t(y) * m_Width + x];
+
+                if (write)
+                {
+                    d = std::min(d, z);
+                }
+                else if (z < d)
+                {
+                    return true;
+                }
+                anyPassed = true;
+            }
+        }
+        return write && anyPassed;
+    }
+
+private:
+    uint32_t m_Width = 0;
+    uint32_t m_Height = 0;
+    std::vector<double> m_Depth;
+};
+
+struct ThroughputResult
+{
+    double rasterMsMean = 0.0;
+    double rasterMsMin = DBL_MAX;
+    double testMsMean = 0.0;
+    uint64_t trianglesRasterized = 0;
+    uint64_t tests = 0;
+};
+
+static ThroughputResult MeasureThroughput(
+    SoftwareOcclusionCuller& culler,
+    const BenchScene& scene,
+    const std::vector<Camera>& views,
+    float aspect)
+{
+    ThroughputResult result;
+    uint32_t frames = 0;
+    volatile uint32_t sink = 0;
+
+    for (const Camera& cam : views)
+    {
+        glm::mat4 viewProj = cam.GetProjection(aspect) * cam.GetView();
+        Frustum frustum = Frustum::FromViewProjection(viewProj);
+
+        for (int it = 0; it < TIMING_ITERATIONS; it++)
+        {
+            auto start = BenchClock::now();
+
+            culler.BeginFrame(viewProj);
+            for (const OccluderMesh& mesh : scene.buildingMeshes)
+                culler.AddOccluder(&mesh, glm::mat4(1.0f));
+            culler.Rasterize();
+
+            double rasterMs = MillisecondsSince(start);
+
+            start = BenchClock::now();
+            uint32_t visible = 0;
+            uint32_t tested = 0;
+            for (const AABB& box : scene.objects)
+            {
+                if (!frustum.IntersectsAABB(box))
+                    continue;
+                tested++;
+                visible += culler.IsVisible(box) ? 1u : 0u;
+            }
+            double testMs = MillisecondsSince(start);
+            sink = sink + visible;
+
+            result.rasterMsMean += rasterMs;
+            result.rasterMsMin = std::min(result.rasterMsMin, rasterMs);
+            result.testMsMean += testMs;
+            result.trianglesRasterized += culler.GetStats().trianglesRasterized;
+            result.tests += tested;
+            frames++;
+        }
+    }
+
+    result.rasterMsMean /= frames;
+    result.testMsMean /= frames;
+    return result;
+}
+
+static void LogThroughput(const std::string& label, const ThroughputResult& r, uint32_t frames)
+{
+    double trisPerFrame = double(r.trianglesRasterized) / frames;
+    double testsPerFrame = double(r.tests) / frames;
+
+    LOG_INFO(label + ": raster " + Fixed(r.rasterMsMean, 3) + " ms mean / " + Fixed(r.rasterMsMin, 3) +
+        " ms min, " + Fixed(trisPerFrame / (r.rasterMsMean * 1000.0), 2) + " Mtri/s; test " +
+        Fixed(r.testMsMean, 3) + " ms for " + Fixed(testsPerFrame, 0) + " boxes, " +
+        Fixed(testsPerFrame / (r.testMsMean * 1000.0), 2) + " Mtests/s");
+}
+
+int RunOcclusionBenchmark(int argc, char** argv)
+{
+    uint32_t width = 320;
+    uint32_t height = 180;
+
+    if (argc >= 4)
+    {
+        width = (uint32_t)std::max(8, std::atoi(argv[2]));
+        height = (uint32_t)std::max(4, std::atoi(argv[3]));
+    }
+
+    BenchScene scene = BuildScene();
+    std::vector<Camera> views = BuildViews();
+
+    ThreadPool pool;
+    SoftwareOcclusionCuller culler(width, height);
+    const float aspect = float(culler.GetWidth()) / float(culler.GetHeight());
+    const uint32_t frames = uint32_t(views.size()) * TIMING_ITERATIONS;
+
+    LOG_INFO("Software occlusion benchmark: " + std::to_string(culler.GetWidth()) + "x" +
+        std::to_string(culler.GetHeight()) + ", " + std::to_string(scene.buildings.size()) + " occluders (" +
+        std::to_string(scene.buildings.size() * 12) + " tris), " + std::to_string(scene.objects.size()) +
+        " objects, " + std::to_string(views.size()) + " views x " + std::to_string(TIMING_ITERATIONS));
+
+    // --- Throughput ---
+    culler.SetThreadPool(nullptr);
+    LogThroughput("1 thread", MeasureThroughput(culler, scene, views, aspect), frames);
+
+    culler.SetThreadPool(&pool);
+    LogThroughput("Thread pool (" + std::to_string(pool.GetThreadCount()) + ")",
+        MeasureThroughput(culler, scene, views, aspect), frames);
+
+    // --- Accuracy vs. exact per-pixel reference ---
+    ReferenceRasterizer reference(culler.GetWidth(), culler.GetHeight());
+
+    uint64_t inFrustum = 0;
+    uint64_t exactOccluded = 0;
+    uint64_t culled = 0;
+    uint64_t falseCulls = 0;  // culled but visible: would pop
+    uint64_t missedCulls = 0; // kept but hidden: wasted draws
+
+    for (const Camera& cam : views)
+    {
+        glm::mat4 viewProj = cam.GetProjection(aspect) * cam.GetView();
+        Frustum frustum = Frustum::FromViewProjection(viewProj);
+
+        culler.BeginFrame(viewProj);
+        for (const OccluderMesh& mesh : scene.buildingMeshes)
+            culler.AddOccluder(&mesh, glm::mat4(1.0f));
+        culler.Rasterize();
+
+        reference.Clear();
+        for (const AABB& building : scene.buildings)
+            reference.DrawBox(building, viewProj, true);
+
+        for (const AABB& box : scene.objects)
+        {
+            if (!frustum.IntersectsAABB(box))
+                continue;
+
+            inFrustum++;
+
+            bool exactVisible = reference.DrawBox(box, viewProj, false);
+            bool kept = culler.IsVisible(box);
+
+            exactOccluded += exactVisible ? 0 : 1;
+            culled += kept ? 0 : 1;
+            falseCulls += (!kept && exactVisible) ? 1 : 0;
+            missedCulls += (kept && !exactVisible) ? 1 : 0;
+        }
+    }
+
+    double culledPct = inFrustum ? 100.0 * culled / inFrustum : 0.0;
+    double efficiency = exactOccluded ? 100.0 * (culled - falseCulls) / exactOccluded : 100.0;
+
+    LOG_INFO("Accuracy: " + std::to_string(inFrustum) + " tests, " + std::to_string(exactOccluded) +
+        " exactly occluded, " + std::to_string(culled) + " culled (" + Fixed(culledPct, 1) + "%), " +
+        std::to_string(falseCulls) + " false culls, " + std::to_string(missedCulls) +
+        " missed culls, " + Fixed(efficiency, 1) + "% of occluded objects culled");
+
+    return falseCulls == 0 ? 0 : 1;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// CPU-only benchmark of SoftwareOcclusionCuller on a synthetic city:
+// rasterization throughput (single thread vs. thread pool), test throughput,
+// and culling accuracy against an exact per-pixel reference.
+// Run with: VXR_Engine --bench-occlusion [width height]
+int RunOcclusionBenchmark(int argc, char** argv);
@@ -0,0 +1,199 @@
+#include "SceneBenchmark.h"
+#include "BenchUtils.h"
+
+#include "core/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+struct Distribution
+{
+    double min = 0.0, mean = 0.0, p50 = 0.0, p95 = 0.0, p99 = 0.0;
+    size_t count = 0;
+};
+
+// Nearest-rank percentiles
+static Distribution Summarize(std::vector<double> samples)
+{
+    Distribution d;
+    d.count = samples.size();
+    if (samples.empty())
+        return d;
+
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+    for (double v : samples)
+        sum += v;
+
+    auto percentile = [&](double p)
+    {
+        size_t rank = (size_t)std::ceil(p * 0.01 * samples.size());
+        return samples[std::min(std::max(rank, size_t(1)), samples.size()) - 1];
+    };
+
+    d.min = samples.front();
+    d.mean = sum / samples.size();
+    d.p50 = percentile(50.0);
+    d.p95 = percentile(95.0);
+    d.p99 = percentile(99.0);
+    return d;
+}
+
+static std::string JsonEscape(const std::string& s)
+{
+    std::string out;
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+static void WriteDistribution(std::ofstream& file, const char* name, const Distribution& d, bool last = false)
+{
+    file << "    \"" << name << "\": { "
+        << "\"count\": " << d.count
+        << ", \"min\": " << Fixed(d.min, 4)
+        << ", \"mean\": " << Fixed(d.mean, 4)
+        << ", \"p50\": " << Fixed(d.p50, 4)
+        << ", \"p95\": " << Fixed(d.p95, 4)
+        << ", \"p99\": " << Fixed(d.p99, 4)
+        << " }" << (last ? "\n" : ",\n");
+}
+
+SceneBenchmark::SceneBenchmark(
+    VulkanDevice* device,
+    uint32_t framesInFlight,
+    const SceneBenchmarkSettings& settings,
+    const CameraPath& path)
+    : m_Settings(settings), m_Path(path), m_GpuTimer(device, framesInFlight, "Scene benchmark")
+{
+    m_Slots.resize(framesInFlight);
+
+    m_CpuMs.reserve(m_Settings.measureFrames);
+    m_FrameMs.reserve(m_Settings.measureFrames);
+    m_GpuMs.reserve(m_Settings.measureFrames);
+    m_DrawCalls.reserve(m_Settings.measureFrames);
+}
+
+void SceneBenchmark::Collect(uint32_t frameIndex)
+{
+    Slot& slot = m_Slots[frameIndex];
+    if (!slot.pending)
+        return;
+
+    slot.pending = false;
+    double gpuMs = 0.0;
+    if (slot.measured && m_GpuTimer.Read(frameIndex, gpuMs))
+        m_GpuMs.push_back(gpuMs);
+}
+
+void SceneBenchmark::BeginFrame(uint32_t frameIndex)
+{
+    Collect(frameIndex);
+}
+
+void SceneBenchmark::ApplyCamera(Camera& camera) const
+{
+    // Simulated time only: the path position depends on the frame number
+    m_Path.Apply(camera, float(m_FrameCounter) * m_Settings.timestep);
+}
+
+void SceneBenchmark::WriteStart(VkCommandBuffer cmd, uint32_t frameIndex)
+{
+    m_GpuTimer.WriteStart(cmd, frameIndex);
+}
+
+void SceneBenchmark::WriteEnd(VkCommandBuffer cmd, uint32_t frameIndex)
+{
+    m_GpuTimer.WriteEnd(cmd, frameIndex);
+
+    Slot& slot = m_Slots[frameIndex];
+    slot.pending = true;
+    slot.measured = IsMeasured();
+}
+
+void SceneBenchmark::EndFrame(double cpuMs, uint32_t drawCalls)
+{
+    const double now = NowSeconds();
+
+    if (IsMeasured())
+    {
+        m_CpuMs.push_back(cpuMs);
+        m_DrawCalls.push_back(double(drawCalls));
+
+        // The first measured frame's interval still spans a warmup frame: fine
+        if (m_LastEndTime >= 0.0)
+            m_FrameMs.push_back((now - m_LastEndTime) * 1.0e3);
+    }
+
+    m_LastEndTime = now;
+    m_FrameCounter++;
+}
+
+bool SceneBenchmark::WriteJson() const
+{
+    std::ofstream file(m_Settings.outputPath);
+    if (!file)
+    {
+        LOG_ERROR("Scene benchmark: cannot write " + m_Settings.outputPath);
+        return false;
+    }
+
+    file << "{\n";
+    file << "  \"benchmark\": \"scene\",\n";
+    file << "  \"config\": {\n";
+    file << "    \"warmupFrames\": " << m_Settings.warmupFrames << ",\n";
+    file << "    \"measureFrames\": " << m_Settings.measureFrames << ",\n";
+    file << "    \"timestep\": " << Fixed(m_Settings.timestep, 6) << ",\n";
+    file << "    \"cameraPath\": \"" << JsonEscape(m_Settings.cameraPath.empty() ? "orbit" : m_Settings.cameraPath) << "\",\n";
+    file << "    \"gpuTimestamps\": " << (m_GpuTimer.IsSupported() ? "true" : "false");
+
+    for (const auto& [key, value] : m_Config)
+        file << ",\n    \"" << JsonEscape(key) << "\": \"" << JsonEscape(value) << "\"";
+
+    file << "\n  },\n";
+    file << "  \"results\": {\n";
+    WriteDistribution(file, "cpuMs", Summarize(m_CpuMs));
+    WriteDistribution(file, "frameMs", Summarize(m_FrameMs));
+    WriteDistribution(file, "gpuMs", Summarize(m_GpuMs));
+    WriteDistribution(file, "drawCalls", Summarize(m_DrawCalls), true);
+    file << "  }\n";
+    file << "}\n";
+
+    return file.good();
+}
+
+void SceneBenchmark::Report()
+{
+    for (uint32_t i = 0; i < m_Slots.size(); i++)
+        Collect(i);
+
+    LOG_INFO("Scene benchmark: " + std::to_string(m_CpuMs.size()) + " measured frames at a " +
+        Fixed(m_Settings.timestep * 1.0e3, 2) + " ms timestep");
+
+    auto log = [](const std::string& name, const Distribution& d, int decimals)
+    {
+        if (d.count == 0)
+        {
+            LOG_WARN(name + ": no samples");
+            return;
+        }
+
+        LOG_INFO(name + ": min " + Fixed(d.min, decimals) + ", mean " + Fixed(d.mean, decimals) +
+            ", p50 " + Fixed(d.p50, decimals) + ", p95 " + Fixed(d.p95, decimals) +
+            ", p99 " + Fixed(d.p99, decimals));
+    };
+
+    log("CPU ms", Summarize(m_CpuMs), 3);
+    log("Frame ms", Summarize(m_FrameMs), 3);
+    log("GPU ms", Summarize(m_GpuMs), 3);
+    log("Draw calls", Summarize(m_DrawCalls), 0);
+
+    if (WriteJson())
+        LOG_INFO("Scene benchmark: results written to " + m_Settings.outputPath);
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "BenchUtils.h"
+#include "CameraPath.h"
+
+class VulkanDevice;
+class Camera;
+
+struct SceneBenchmarkSettings
+{
+    std::string cameraPath;                    // keyframe file; empty: scripted orbit around the scene
+    std::string outputPath = "bench_scene.json";
+    uint32_t warmupFrames = 60;
+    uint32_t measureFrames = 600;
+    float timestep = 1.0f / 60.0f;             // simulated seconds per frame
+};
+
+// Repeatable whole-frame benchmark, driven by Application (--bench-scene).
+// The camera follows a CameraPath at a fixed simulated timestep, so every
+// run renders the same frames regardless of how fast they complete. Per
+// measured frame it records CPU time (record + submit, without the frame
+// slot wait), frame-to-frame time, GPU time (timestamps around the frame's
+// commands) and draw calls; Report() logs min / mean / p50 / p95 / p99 and
+// writes them as JSON for comparing builds.
+// Run with: VXR_Engine --bench-scene [frames] [out.json] [--camera-path file] [--scene model]
+class SceneBenchmark
+{
+public:
+    SceneBenchmark(
+        VulkanDevice* device,
+        uint32_t framesInFlight,
+        const SceneBenchmarkSettings& settings,
+        const CameraPath& path);
+
+    bool IsFinished() const { return m_FrameCounter >= m_Settings.warmupFrames + m_Settings.measureFrames; }
+
+    // Fixed delta time for everything simulated this frame
+    float GetTimestep() const { return m_Settings.timestep; }
+
+    // Extra key / value pairs written under "config" (scene, resolution, ...)
+    void Describe(const std::string& key, const std::string& value) { m_Config.emplace_back(key, value); }
+
+    // After the slot's frame wait: collects that slot's previous GPU time
+    void BeginFrame(uint32_t frameIndex);
+
+    // Places the camera for the frame about to be recorded
+    void ApplyCamera(Camera& camera) const;
+
+    // Around everything the frame records (outside render passes)
+    void WriteStart(VkCommandBuffer cmd, uint32_t frameIndex);
+    void WriteEnd(VkCommandBuffer cmd, uint32_t frameIndex);
+
+    // After submit. drawCalls: every draw recorded, depth pre-pass included
+    void EndFrame(double cpuMs, uint32_t drawCalls);
+
+    // After vkDeviceWaitIdle: collects the remaining slots, logs and writes the JSON
+    void Report();
+
+private:
+    struct Slot
+    {
+        bool pending = false;
+        bool measured = false;
+    };
+
+    bool IsMeasured() const { return m_FrameCounter >= m_Settings.warmupFrames; }
+    void Collect(uint32_t frameIndex);
+    bool WriteJson() const;
+
+private:
+    SceneBenchmarkSettings m_Settings;
+    CameraPath m_Path;
+
+    BenchGpuTimer m_GpuTimer;
+
+    std::vector<Slot> m_Slots;
+    uint32_t m_FrameCounter = 0;
+    double m_LastEndTime = -1.0; // seconds, previous EndFrame()
+
+    std::vector<double> m_CpuMs;
+    std::vector<double> m_FrameMs;
+    std::vector<double> m_GpuMs;
+    std::vector<double> m_DrawCalls;
+
+    std::vector<std::pair<std::string, std::string>> m_Config;
+};
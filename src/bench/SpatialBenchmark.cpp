@@ -0,0 +1,381 @@
+#include "SpatialBenchmark.h"
+#include "BenchUtils.h"
+
+#include "renderer/SceneBVH.h"
+#include "renderer/Camera.h"
+#include "renderer/Frustum.h"
+#include "core/Logger.h"
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+// --- Synthetic scene ---
+
+static constexpr float OBJECT_SPACING = 10.0f; // world grows with the object count
+static constexpr float BVH_MARGIN = 0.5f;
+
+static constexpr int FRUSTUM_QUERIES = 200;
+static constexpr int POINT_QUERIES = 100000;  // rays, spheres, boxes, k-nearest
+static constexpr int VERIFY_QUERIES = 100;
+static constexpr uint32_t NEAREST_K = 8;
+
+struct SpatialScene
+{
+    float worldSize = 0.0f;
+    std::vector<AABB> boxes;
+};
+
+static SpatialScene BuildScene(uint32_t count)
+{
+    SpatialScene scene;
+    scene.worldSize = OBJECT_SPACING * std::cbrt(float(count));
+
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> position(0.0f, scene.worldSize);
+    std::uniform_real_distribution<float> size(0.5f, 3.0f);
+
+    scene.boxes.resize(count);
+    for (AABB& box : scene.boxes)
+    {
+        box.min = { position(rng), position(rng), position(rng) };
+        box.max = box.min + glm::vec3(size(rng), size(rng), size(rng));
+    }
+
+    return scene;
+}
+
+static void LogQueries(const std::string& label, int queries, double ms, uint64_t results)
+{
+    LOG_INFO(label + ": " + Fixed(queries / (ms / 1000.0), 0) + " queries/s (" +
+        Fixed(ms * 1000.0 / queries, 2) + " us each, " + Fixed(double(results) / queries, 1) + " results avg)");
+}
+
+// --- Brute force references ---
+
+static bool Overlaps(const AABB& a, const AABB& b)
+{
+    return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+           a.min.y <= b.max.y && b.min.y <= a.max.y &&
+           a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+static float DistanceSq(const AABB& box, const glm::vec3& p)
+{
+    glm::vec3 d = glm::max(glm::max(box.min - p, p - box.max), glm::vec3(0.0f));
+    return glm::dot(d, d);
+}
+
+static float RayBox(const AABB& box, const Ray& ray, float maxT)
+{
+    float enter = 0.0f;
+    float exit = maxT;
+    for (int a = 0; a < 3; a++)
+    {
+        float inv = 1.0f / ray.direction[a];
+        float t0 = (box.min[a] - ray.origin[a]) * inv;
+        float t1 = (box.max[a] - ray.origin[a]) * inv;
+        enter = std::max(enter, std::min(t0, t1));
+        exit = std::min(exit, std::max(t0, t1));
+    }
+    return enter <= exit ? enter : FLT_MAX;
+}
+
+static bool SameSet(std::vector<uint32_t> a, std::vector<uint32_t> b)
+{
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+
+int RunSpatialBenchmark(int argc, char** argv)
+{
+    uint32_t count = 1000000;
+    if (argc >= 3)
+        count = (uint32_t)std::max(1, std::atoi(argv[2]));
+
+    SpatialScene scene = BuildScene(count);
+    const float worldSize = scene.worldSize;
+
+    std::vector<uint32_t> ids(count);
+    for (uint32_t i = 0; i < count; i++)
+        ids[i] = i;
+
+    LOG_INFO("BVH benchmark: " + std::to_string(count) + " objects in a " + Fixed(worldSize, 0) + "^3 world");
+
+    // --- Build ---
+    SceneBVH bvh(BVH_MARGIN);
+
+    auto start = BenchClock::now();
+    bvh.Build(scene.boxes, ids);
+    LOG_INFO("Build: " + Fixed(MillisecondsSince(start), 1) + " ms, height " + std::to_string(bvh.GetHeight()));
+
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> position(0.0f, worldSize);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2832f);
+
+    auto randomDirection = [&]()
+    {
+        glm::vec3 d;
+        do { d = { unit(rng), unit(rng), unit(rng) }; } while (glm::dot(d, d) < 0.01f || glm::dot(d, d) > 1.0f);
+        return glm::normalize(d);
+    };
+
+    uint32_t mismatches = 0;
+    std::vector<uint32_t> result;
+    std::vector<uint32_t> expected;
+
+    // --- Frustum ---
+    {
+        std::vector<Frustum> frusta;
+        for (int i = 0; i < FRUSTUM_QUERIES; i++)
+        {
+            Camera cam;
+            cam.SetPosition({ position(rng), position(rng), position(rng) });
+            cam.SetYawPitch(angle(rng), unit(rng) * 0.6f);
+            cam.SetPerspective(glm::radians(60.0f), 0.1f, 300.0f);
+            frusta.push_back(Frustum::FromViewProjection(cam.GetProjection(16.0f / 9.0f) * cam.GetView()));
+        }
+
+        uint64_t total = 0;
+        start = BenchClock::now();
+        for (const Frustum& f : frusta)
+        {
+            result.clear();
+            bvh.QueryFrustum(f, result);
+            total += result.size();
+        }
+        double bvhMs = MillisecondsSince(start);
+        LogQueries("Frustum (BVH)", FRUSTUM_QUERIES, bvhMs, total);
+
+        const int linearQueries = 10;
+        std::vector<std::vector<uint32_t>> linearResults(linearQueries);
+
+        start = BenchClock::now();
+        for (int i = 0; i < linearQueries; i++)
+        {
+            for (uint32_t id = 0; id < count; id++)
+            {
+                if (frusta[i].IntersectsAABB(scene.boxes[id]))
+                    linearResults[i].push_back(id);
+            }
+        }
+        double linearMs = MillisecondsSince(start);
+        LOG_INFO("Frustum (linear scan): " + Fixed(linearQueries / (linearMs / 1000.0), 0) + " queries/s, BVH is " +
+            Fixed((linearMs / linearQueries) / (bvhMs / FRUSTUM_QUERIES), 1) + "x faster");
+
+        for (int i = 0; i < linearQueries; i++)
+        {
+            result.clear();
+            bvh.QueryFrustum(frusta[i], result);
+            mismatches += SameSet(result, linearResults[i]) ? 0 : 1;
+        }
+    }
+
+    // --- Ray ---
+    {
+        const float maxT = worldSize;
+        std::vector<Ray> rays(POINT_QUERIES);
+        for (Ray& r : rays)
+        {
+            r.origin = { position(rng), position(rng), position(rng) };
+            r.direction = randomDirection();
+        }
+
+        uint64_t hits = 0;
+        RayHit hit;
+        start = BenchClock::now();
+        for (const Ray& r : rays)
+            hits += bvh.RayCast(r, maxT, hit) ? 1 : 0;
+        LogQueries("Ray (closest hit)", POINT_QUERIES, MillisecondsSince(start), hits);
+
+        for (int i = 0; i < VERIFY_QUERIES; i++)
+        {
+            float best = FLT_MAX;
+            for (const AABB& box : scene.boxes)
+                best = std::min(best, RayBox(box, rays[i], maxT));
+
+            bvh.RayCast(rays[i], maxT, hit);
+            if (hit.t != best && !(best == FLT_MAX && hit.userData == UINT32_MAX))
+                mismatches++;
+        }
+    }
+
+    // --- Sphere / box overlap ---
+    {
+        const float radius = 15.0f;
+        std::vector<glm::vec3> centers(POINT_QUERIES);
+        for (glm::vec3& c : centers)
+            c = { position(rng), position(rng), position(rng) };
+
+        uint64_t total = 0;
+        start = BenchClock::now();
+        for (const glm::vec3& c : centers)
+        {
+            result.clear();
+            bvh.QuerySphere(c, radius, result);
+            total += result.size();
+        }
+        LogQueries("Sphere overlap (r " + Fixed(radius, 0) + ")", POINT_QUERIES, MillisecondsSince(start), total);
+
+        total = 0;
+        start = BenchClock::now();
+        for (const glm::vec3& c : centers)
+        {
+            AABB query;
+            query.min = c - glm::vec3(radius);
+            query.max = c + glm::vec3(radius);
+
+            result.clear();
+            bvh.QueryAABB(query, result);
+            total += result.size();
+        }
+        LogQueries("Box overlap (half " + Fixed(radius, 0) + ")", POINT_QUERIES, MillisecondsSince(start), total);
+
+        for (int i = 0; i < VERIFY_QUERIES; i++)
+        {
+            AABB query;
+            query.min = centers[i] - glm::vec3(radius);
+            query.max = centers[i] + glm::vec3(radius);
+
+            std::vector<uint32_t> sphereExpected;
+            expected.clear();
+            for (uint32_t id = 0; id < count; id++)
+            {
+                if (DistanceSq(scene.boxes[id], centers[i]) <= radius * radius)
+                    sphereExpected.push_back(id);
+                if (Overlaps(scene.boxes[id], query))
+                    expected.push_back(id);
+            }
+
+            result.clear();
+            bvh.QuerySphere(centers[i], radius, result);
+            mismatches += SameSet(result, sphereExpected) ? 0 : 1;
+
+            result.clear();
+            bvh.QueryAABB(query, result);
+            mismatches += SameSet(result, expected) ? 0 : 1;
+        }
+    }
+
+    // --- k-nearest ---
+    {
+        std::vector<glm::vec3> points(POINT_QUERIES);
+        for (glm::vec3& p : points)
+            p = { position(rng), position(rng), position(rng) };
+
+        std::vector<NearestHit> nearest;
+        uint64_t total = 0;
+        start = BenchClock::now();
+        for (const glm::vec3& p : points)
+        {
+            nearest.clear();
+            bvh.QueryNearest(p, NEAREST_K, nearest);
+            total += nearest.size();
+        }
+        LogQueries(std::to_string(NEAREST_K) + "-nearest", POINT_QUERIES, MillisecondsSince(start), total);
+
+        // Compare distances (ties may pick different objects)
+        std::vector<float> distances(count);
+        for (int i = 0; i < VERIFY_QUERIES; i++)
+        {
+            for (uint32_t id = 0; id < count; id++)
+                distances[id] = DistanceSq(scene.boxes[id], points[i]);
+
+            uint32_t k = std::min(NEAREST_K, count);
+            std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+
+            nearest.clear();
+            bvh.QueryNearest(points[i], NEAREST_K, nearest);
+            bool same = nearest.size() == k;
+            for (uint32_t j = 0; same && j < k; j++)
+                same = nearest[j].distanceSq == distances[j];
+            mismatches += same ? 0 : 1;
+        }
+    }
+
+    if (mismatches == 0)
+        LOG_INFO("Verification: all sampled queries match brute force");
+    else
+        LOG_WARN("Verification: " + std::to_string(mismatches) + " queries differ from brute force");
+
+    // --- Refit ---
+    // Small moves stay inside the fat leaf boxes (no tree change), large ones
+    // reinsert the leaf. Either way the cost tracks the number moved.
+    std::uniform_int_distribution<uint32_t> pick(0, count - 1);
+
+    const uint32_t moveCounts[] = { 1000, 10000, 100000 };
+    for (uint32_t moved : moveCounts)
+    {
+        if (moved > count)
+            break;
+
+        std::vector<uint32_t> targets(moved);
+        std::vector<AABB> jittered(moved);
+        std::vector<AABB> teleported(moved);
+        for (uint32_t i = 0; i < moved; i++)
+        {
+            uint32_t t = pick(rng);
+            targets[i] = t;
+
+            glm::vec3 offset = randomDirection() * (BVH_MARGIN * 0.5f);
+            jittered[i].min = scene.boxes[t].min + offset;
+            jittered[i].max = scene.boxes[t].max + offset;
+
+            glm::vec3 size = scene.boxes[t].max - scene.boxes[t].min;
+            teleported[i].min = { position(rng), position(rng), position(rng) };
+            teleported[i].max = teleported[i].min + size;
+        }
+
+        // Jitter within the margin
+        uint32_t jitterReinserts = 0;
+        start = BenchClock::now();
+        for (uint32_t i = 0; i < moved; i++)
+            jitterReinserts += bvh.Move(targets[i], jittered[i]) ? 1 : 0;
+        double jitterMs = MillisecondsSince(start);
+
+        // Teleports: always leave the fat box
+        start = BenchClock::now();
+        for (uint32_t i = 0; i < moved; i++)
+            bvh.Move(targets[i], teleported[i]);
+        double teleportMs = MillisecondsSince(start);
+
+        // Later picks of the same object overwrite earlier ones, like in the tree
+        for (uint32_t i = 0; i < moved; i++)
+            scene.boxes[targets[i]] = teleported[i];
+
+        LOG_INFO("Refit " + std::to_string(moved) + " moved: jitter " + Fixed(jitterMs, 3) + " ms (" +
+            Fixed(jitterMs * 1.0e6 / moved, 0) + " ns/object, " + std::to_string(jitterReinserts) + " reinserted), teleport " + Fixed(teleportMs, 3) + " ms (" +
+            Fixed(teleportMs * 1.0e6 / moved, 0) + " ns/object), height " + std::to_string(bvh.GetHeight()));
+    }
+
+    // Tree is still exact after all the moves
+    {
+        glm::vec3 c(worldSize * 0.5f);
+        AABB query;
+        query.min = c - glm::vec3(40.0f);
+        query.max = c + glm::vec3(40.0f);
+
+        expected.clear();
+        for (uint32_t id = 0; id < count; id++)
+        {
+            if (Overlaps(scene.boxes[id], query))
+                expected.push_back(id);
+        }
+
+        result.clear();
+        bvh.QueryAABB(query, result);
+        if (!SameSet(result, expected))
+        {
+            LOG_WARN("Verification: box query after refit differs from brute force");
+            mismatches++;
+        }
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// CPU-only benchmark of SceneBVH on random world boxes: build time, queries
+// per second for frustum / ray / sphere / box / k-nearest queries (checked
+// against brute force), and refit cost for small moves vs. reinsertions.
+// Run with: VXR_Engine --bench-bvh [objectCount]   (default 1000000)
+int RunSpatialBenchmark(int argc, char** argv);
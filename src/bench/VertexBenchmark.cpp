@@ -0,0 +1,106 @@
+#include "VertexBenchmark.h"
+#include "BenchUtils.h"
+
+#include "core/Logger.h"
+
+#include <algorithm>
+
+VertexBenchmark::VertexBenchmark(
+    VulkanDevice* device,
+    uint32_t framesInFlight,
+    const VertexBenchmarkSettings& settings,
+    const std::vector<std::string>& variantNames)
+    : m_Settings(settings), m_GpuTimer(device, framesInFlight, "Vertex benchmark")
+{
+    for (const std::string& name : variantNames)
+        m_Variants.push_back({ name, {}, 0 });
+
+    m_Slots.resize(framesInFlight);
+}
+
+void VertexBenchmark::Collect(uint32_t frameIndex)
+{
+    Slot& slot = m_Slots[frameIndex];
+    if (!slot.pending)
+        return;
+
+    slot.pending = false;
+    double gpuMs = 0.0;
+    if (!slot.measured || !m_GpuTimer.Read(frameIndex, gpuMs))
+        return;
+
+    Variant& variant = m_Variants[slot.variant];
+    variant.gpuMs.push_back(gpuMs);
+    variant.indices += slot.indices;
+}
+
+void VertexBenchmark::BeginFrame(uint32_t frameIndex)
+{
+    Collect(frameIndex);
+}
+
+void VertexBenchmark::WriteStart(VkCommandBuffer cmd, uint32_t frameIndex)
+{
+    m_GpuTimer.WriteStart(cmd, frameIndex);
+}
+
+void VertexBenchmark::WriteEnd(VkCommandBuffer cmd, uint32_t frameIndex, uint64_t indicesDrawn)
+{
+    m_GpuTimer.WriteEnd(cmd, frameIndex);
+
+    Slot& slot = m_Slots[frameIndex];
+    slot.pending = true;
+    slot.variant = GetVariant();
+    slot.measured = m_FrameCounter % FramesPerVariant() >= m_Settings.warmupFrames;
+    slot.indices = indicesDrawn;
+
+    m_FrameCounter++;
+}
+
+void VertexBenchmark::Report()
+{
+    for (uint32_t i = 0; i < m_Slots.size(); i++)
+        Collect(i);
+
+    LOG_INFO("Vertex benchmark: " + std::to_string(m_Settings.gridSize * m_Settings.gridSize) +
+        " model instances, " + std::to_string(m_Settings.measureFrames) + " measured frames per variant");
+
+    if (!m_GpuTimer.IsSupported())
+    {
+        LOG_WARN("Vertex benchmark: no GPU timestamps on this device, nothing to report");
+        return;
+    }
+
+    double baselineMs = 0.0;
+
+    for (size_t v = 0; v < m_Variants.size(); v++)
+    {
+        Variant& variant = m_Variants[v];
+        if (variant.gpuMs.empty())
+        {
+            LOG_WARN(variant.name + ": no GPU samples");
+            continue;
+        }
+
+        std::sort(variant.gpuMs.begin(), variant.gpuMs.end());
+
+        double sum = 0.0;
+        for (double ms : variant.gpuMs)
+            sum += ms;
+
+        const double mean = sum / variant.gpuMs.size();
+        const double median = variant.gpuMs[variant.gpuMs.size() / 2];
+        const double indicesPerFrame = double(variant.indices) / variant.gpuMs.size();
+
+        // Index count = vertex shader invocations without post-transform cache hits
+        std::string line = variant.name + ": GPU " + Fixed(mean, 3) + " ms mean / " + Fixed(median, 3) +
+            " ms median, " + Fixed(indicesPerFrame / (median * 1.0e3), 1) + " M indices/s";
+
+        if (v == 0)
+            baselineMs = median;
+        else if (baselineMs > 0.0)
+            line += " (" + Fixed(median / baselineMs, 2) + "x of " + m_Variants[0].name + ")";
+
+        LOG_INFO(line);
+    }
+}
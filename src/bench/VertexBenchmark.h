@@ -0,0 +1,74 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "BenchUtils.h"
+
+class VulkanDevice;
+
+struct VertexBenchmarkSettings
+{
+    uint32_t gridSize = 24;        // model instances per side
+    uint32_t warmupFrames = 60;    // per variant
+    uint32_t measureFrames = 300;  // per variant
+};
+
+// GPU vertex-throughput benchmark, driven by Application (--bench-vertex).
+// Application renders the loaded model as a grid of instances with culling
+// off, switching vertex shader variant every warmup + measure frames; this
+// class times the scene pass with timestamp queries and reports per variant.
+// Run with: VXR_Engine --bench-vertex [gridSize] [frames]
+class VertexBenchmark
+{
+public:
+    VertexBenchmark(
+        VulkanDevice* device,
+        uint32_t framesInFlight,
+        const VertexBenchmarkSettings& settings,
+        const std::vector<std::string>& variantNames);
+
+    // Variant the next recorded frame must use
+    uint32_t GetVariant() const { return m_FrameCounter / FramesPerVariant(); }
+
+    // All variants recorded
+    bool IsFinished() const { return GetVariant() >= m_Variants.size(); }
+
+    // After the slot's frame wait: collects that slot's previous timing
+    void BeginFrame(uint32_t frameIndex);
+
+    // Around everything the frame records (outside render passes)
+    void WriteStart(VkCommandBuffer cmd, uint32_t frameIndex);
+    void WriteEnd(VkCommandBuffer cmd, uint32_t frameIndex, uint64_t indicesDrawn);
+
+    // After vkDeviceWaitIdle: collects the remaining slots and logs results
+    void Report();
+
+private:
+    struct Variant
+    {
+        std::string name;
+        std::vector<double> gpuMs;
+        uint64_t indices = 0;
+    };
+
+    struct Slot
+    {
+        bool pending = false;
+        bool measured = false;
+        uint32_t variant = 0;
+        uint64_t indices = 0;
+    };
+
+    uint32_t FramesPerVariant() const { return m_Settings.warmupFrames + m_Settings.measureFrames; }
+    void Collect(uint32_t frameIndex);
+
+private:
+    VertexBenchmarkSettings m_Settings;
+    BenchGpuTimer m_GpuTimer;
+
+    std::vector<Slot> m_Slots;
+    std::vector<Variant> m_Variants;
+    uint32_t m_FrameCounter = 0;
+};
@@ -4,6 +4,7 @@
 #include "renderer/VulkanInstance.h"
 #include "renderer/VulkanDevice.h"
 #include "renderer/VulkanSwapchain.h"
+#include "renderer/VulkanOffscreenTarget.h"
 #include "renderer/VulkanDepthBuffer.h"
 #include "renderer/VulkanMSAAColorBuffer.h"
 #include "renderer/VulkanRenderPass.h"
@@ -11,6 +12,7 @@
 #include "renderer/VulkanCommandPool.h"
 #include "renderer/VulkanCommandBuffers.h"
 #include "renderer/VulkanSync.h"
+#include "renderer/VulkanTimeline.h"
 #include "renderer/pipeline/VulkanPipeline.h"
 #include "renderer/VulkanVertexBuffer.h"
 #include "renderer/Vertex.h"
@@ -18,27 +20,69 @@
 #include "renderer/UniformBufferObject.h"
 #include "renderer/VulkanUniformBuffers.h"
 #include "renderer/VulkanDescriptors.h"
+#include "renderer/VulkanLightStorage.h"
 #include "renderer/CameraUBO.h"
 #include "renderer/VulkanIndexBuffer.h"
 #include "renderer/Mesh.h"
 #include "renderer/PushConstants.h"
-#include "renderer/RenderObject.h"
 #include "renderer/Scene.h"
 #include "renderer/RenderQueue.h"
 #include "renderer/Camera.h"
 #include "input/CameraController.h"
 #include "asset/ModelLoader.h"
+#include "asset/ImageWriter.h"
 #include "renderer/VulkanTexture2D.h"
 #include "renderer/MaterialInstance.h"
+#include "renderer/VulkanDescriptorAllocator.h"
+#include "renderer/Frustum.h"
+#include "renderer/culling/VulkanGpuCulling.h"
+#include "renderer/culling/VulkanDepthPyramid.h"
+#include "renderer/culling/VulkanLightClusters.h"
+#include "renderer/culling/SoftwareOcclusion.h"
+#include "core/ThreadPool.h"
+#include "renderer/VulkanSecondaryCommandBuffers.h"
+#include "renderer/VulkanProfiler.h"
+#include "renderer/VulkanFrameStats.h"
+#include "renderer/pipeline/VulkanPipelineCache.h"
+#include "renderer/pipeline/VulkanStateCache.h"
 
 #include "lighting/LightFactory.h"
+#include "bench/BenchUtils.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <array>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <random>
+
+// Depth pre-pass pipeline of a lit pipeline: same layout and render pass,
+// no color writes. No fragment shader: the position-only stream.
+static GraphicsPipelineDesc DepthPrepassDesc(
+    const GraphicsPipelineDesc& lit,
+    const std::string& vertSpv,
+    const std::string& fragSpv)
+{
+    GraphicsPipelineDesc desc = lit;
+    desc.vertSpv = vertSpv;
+    desc.fragSpv = fragSpv;
+    desc.fragConstants.clear();
+    desc.colorWrite = VK_FALSE;
+    desc.vertexInput = fragSpv.empty() ? VertexInput::PositionOnly : VertexInput::Vertex3D;
+    return desc;
+}
+
+// The lit pipeline drawn after the pre-pass: only the pre-pass depth passes
+static GraphicsPipelineDesc DepthEqualDesc(const GraphicsPipelineDesc& lit)
+{
+    GraphicsPipelineDesc desc = lit;
+    desc.depthWrite = VK_FALSE;
+    desc.depthCompare = VK_COMPARE_OP_EQUAL;
+    return desc;
+}
 
 Application::Application()
 {
-    m_Window = new Window(1280, 720, "VXR Engine");
     Logger::Log("Application Initialized");
 }
 
@@ -113,9 +157,12 @@ void Application::Shutdown()
     // 1️⃣ Ensure GPU is idle
     vkDeviceWaitIdle(m_Device->GetHandle());
 
+    // Background pipeline compiles still use the render passes and set layouts
+    // destroyed below
+    m_Device->GetStateCache()->WaitForCompiles();
+
     // 2️⃣ Destroy scene + mesh ownership FIRST
-    m_Scene.Clear();          // if implemented
-    m_RenderObjects.clear();  // safe
+    m_Scene.Clear();
     m_OwnedMeshes.clear();    
 
     // Destroy runtime materials first (they reference textures via descriptor sets)
@@ -155,25 +202,59 @@ void Application::Shutdown()
     m_TransferCmdPool = nullptr;
 
     // 4️ Descriptor + uniform systems
+    delete m_LightClusters;
+    delete m_LightStorage;
+    m_LightClusters = nullptr;
+    m_LightStorage = nullptr;
+
     delete m_Descriptors;
     delete m_UniformBuffers;
     m_Descriptors = nullptr;
     m_UniformBuffers = nullptr;
 
     // 5️ Pipeline + render targets
-    delete m_Pipeline;
+    delete m_GpuCulling;
+    delete m_DepthPyramid;
+    delete m_LoadRenderPass;
+    m_GpuCulling = nullptr;
+    m_IndirectPipeline = nullptr;
+    m_IndirectDepthPrepassPipeline = nullptr;
+    m_IndirectDepthPrepassAlphaPipeline = nullptr;
+    m_IndirectDepthEqualPipeline = nullptr;
+    m_DepthPyramid = nullptr;
+    m_LoadRenderPass = nullptr;
+
+    delete m_SecondaryCommandBuffers;
+    delete m_SoftwareOcclusion;
+    delete m_WorkerPool;
+    m_SecondaryCommandBuffers = nullptr;
+    m_SoftwareOcclusion = nullptr;
+    m_WorkerPool = nullptr;
+
+    delete m_VertexBenchmark;
+    delete m_SceneBenchmark;
+    m_VertexBenchmark = nullptr;
+    m_ReferencePipeline = nullptr;
+    m_SceneBenchmark = nullptr;
+
+    // Pipelines belong to the device's state cache
     delete m_Framebuffers;
     delete m_RenderPass;
     delete m_MSAAColor;
     delete m_DepthBuffer;
     delete m_Swapchain;
+    delete m_Offscreen;
 
     m_Pipeline = nullptr;
+    m_DepthPrepassPipeline = nullptr;
+    m_DepthPrepassAlphaPipeline = nullptr;
+    m_DepthEqualPipeline = nullptr;
     m_Framebuffers = nullptr;
     m_RenderPass = nullptr;
     m_MSAAColor = nullptr;
     m_DepthBuffer = nullptr;
     m_Swapchain = nullptr;
+    m_Offscreen = nullptr;
 
     // 6️ Camera & input
     delete m_CameraController;
@@ -181,6 +262,27 @@ void Application::Shutdown()
     m_CameraController = nullptr;
     m_Camera = nullptr;
 
+    // Profiler before the device (query pool)
+    if (m_Device)
+        m_Device->SetProfiler(nullptr);
+    delete m_Profiler;
+    m_Profiler = nullptr;
+
+    if (m_Device)
+        m_Device->SetFrameStats(nullptr);
+    delete m_FrameStats;
+    m_FrameStats = nullptr;
+
+    // Saved last: pipelines created at any point of the run are in it
+    // (background compiles finished at the start of Shutdown)
+    if (m_PipelineCache)
+    {
+        m_PipelineCache->Save();
+        m_Device->SetPipelineCache(nullptr);
+    }
+    delete m_PipelineCache;
+    m_PipelineCache = nullptr;
+
     // 7️ Destroy device LAST
     delete m_Device;
     m_Device = nullptr;
@@ -204,12 +306,17 @@ void Application::Shutdown()
 
 void Application::Run()
 {
+    // Headless runs never create a window (or initialize GLFW)
+    if (!m_Headless)
+        m_Window = new Window(1280, 720, "VXR Engine");
+
     // 1) Instance
-    m_Instance = new VulkanInstance(true);
+    m_Instance = new VulkanInstance(true, m_Headless);
 
     // 2) Surface + Device
     // Store surface in a member so we can destroy it later correctly.
-    m_Surface = m_Window->CreateSurface(m_Instance->GetHandle());
+    if (!m_Headless)
+        m_Surface = m_Window->CreateSurface(m_Instance->GetHandle());
 
     m_Device = new VulkanDevice(
         m_Instance->GetHandle(),
@@ -217,7 +324,28 @@ void Application::Run()
     );
 
 	// Uniform buffers + descriptors
-    const uint32_t FRAMES_IN_FLIGHT = 2;
+    const uint32_t FRAMES_IN_FLIGHT = m_FramesInFlight;
+    LOG_INFO("Frames in flight: " + std::to_string(FRAMES_IN_FLIGHT));
+
+    // Before any upload, so load-time transfers show up in the trace
+    if (!m_ProfileTracePath.empty())
+    {
+        m_Profiler = new VulkanProfiler(m_Device, FRAMES_IN_FLIGHT);
+        m_Device->SetProfiler(m_Profiler);
+    }
+
+    // Before the first pipeline
+    m_PipelineCache = new VulkanPipelineCache(m_Device, m_PipelineCachePath);
+    m_Device->SetPipelineCache(m_PipelineCache);
+
+    if (m_CollectFrameStats)
+    {
+        m_FrameStats = new VulkanFrameStats(m_Device, FRAMES_IN_FLIGHT);
+        m_Device->SetFrameStats(m_FrameStats);
+
+        if (!m_FrameStatsPath.empty())
+            m_FrameStats->OpenCsv(m_FrameStatsPath);
+    }
 
     m_UniformBuffers = new VulkanUniformBuffers(
         m_Device,
@@ -231,21 +359,44 @@ void Application::Run()
         FRAMES_IN_FLIGHT
     );
 
+    // Light storage + froxel lists: set 0 bindings 1-4
+    m_LightStorage = new VulkanLightStorage(m_Device, FRAMES_IN_FLIGHT);
+    m_LightClusters = new VulkanLightClusters(m_Device, FRAMES_IN_FLIGHT, m_Descriptors->GetLayout());
+    for (uint32_t i = 0; i < FRAMES_IN_FLIGHT; i++)
+        m_Descriptors->WriteLights(i, m_LightStorage, m_LightClusters);
 
-    // 3) Swapchain
-    m_Swapchain = new VulkanSwapchain(
-        m_Instance->GetHandle(),
-        m_Device,
-        m_Surface,
-        m_Window->GetWidth(),
-        m_Window->GetHeight()
-    );
 
-    // Swapchain-derived formats
-    VkExtent2D extent = m_Swapchain->GetExtent();
-    VkFormat   colorFmt = m_Swapchain->GetImageFormat();
+    // 3) Swapchain, or one offscreen image per frame slot when headless
+    if (m_Headless)
+    {
+        m_Offscreen = new VulkanOffscreenTarget(
+            m_Device,
+            VK_FORMAT_R8G8B8A8_SRGB,
+            { m_HeadlessSettings.width, m_HeadlessSettings.height },
+            FRAMES_IN_FLIGHT
+        );
+    }
+    else
+    {
+        m_Swapchain = new VulkanSwapchain(
+            m_Instance->GetHandle(),
+            m_Device,
+            m_Surface,
+            m_Window->GetWidth(),
+            m_Window->GetHeight()
+        );
+    }
+
+    // Target-derived formats
+    VkExtent2D extent = GetTargetExtent();
+    VkFormat   colorFmt = m_Headless ? m_Offscreen->GetImageFormat() : m_Swapchain->GetImageFormat();
     VkFormat   depthFmt = m_Device->FindDepthFormat();
 
+    // Offscreen images stay readable by transfers after the pass
+    const VkImageLayout resolveLayout = m_Headless
+        ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+        : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
     // 4) Depth (MSAA aware)
     m_DepthBuffer = new VulkanDepthBuffer(m_Device, extent);
 
@@ -253,12 +404,13 @@ void Application::Run()
     m_MSAAColor = new VulkanMSAAColorBuffer(m_Device, colorFmt, extent);
 
     // 6) RenderPass
-    m_RenderPass = new VulkanRenderPass(m_Device, colorFmt, depthFmt);
+    m_RenderPass = new VulkanRenderPass(m_Device, colorFmt, depthFmt, RenderPassLoad::Clear, resolveLayout);
 
     // 7) Framebuffers
     m_Framebuffers = new VulkanFramebuffers(
         m_Device,
-        m_Swapchain,
+        m_Headless ? m_Offscreen->GetImageViews() : m_Swapchain->GetImageViews(),
+        extent,
         m_RenderPass,
         m_DepthBuffer,
         m_MSAAColor
@@ -270,22 +422,44 @@ void Application::Run()
     m_TransferCmdPool = new VulkanCommandPool(m_Device, CommandPoolType::Transfer);
 
 
-    m_MaterialPool = new VulkanMaterialDescriptors(m_Device, 128);
+    // Bindless: one set holds every material's textures + parameters
+    m_MaterialPool = new VulkanMaterialDescriptors(m_Device, MAX_MATERIALS);
 
-    // Pipeline layouts (ONLY set = 0 for now)
+    // Pipeline layouts
     std::vector<VkDescriptorSetLayout> layouts = {
         m_Descriptors->GetLayout(), // set = 0 (Camera UBO)
-        m_MaterialPool->GetLayout()  // set = 1 (Material textures)
+        m_MaterialPool->GetLayout()  // set = 1 (Material table)
     };
 
-    m_MaterialTemplate = new MaterialTemplate(
-        m_Device,
-        m_Swapchain,
-        m_RenderPass,
-        layouts,
-        "shaders/unlit3d.vert.spv",
-        "shaders/unlit3d.frag.spv"
-    );
+    // Lit pipeline (set0 + set1), shared through the state cache: the
+    // material template draws with it too
+    VulkanStateCache* states = m_Device->GetStateCache();
+
+    GraphicsPipelineDesc litDesc;
+    litDesc.renderPass = m_RenderPass->GetHandle();
+    litDesc.setLayouts = layouts;
+    litDesc.vertSpv = "shaders/lighting.vert.spv";
+    litDesc.fragSpv = "shaders/lighting.frag.spv";
+    m_Pipeline = states->GetGraphicsPipeline(litDesc);
+
+    m_MaterialTemplate = new MaterialTemplate(m_Device, m_Pipeline);
+
+    // Depth pre-pass variants (the vertex benchmark swaps lit pipelines itself)
+    if (m_RunVertexBenchmark)
+        m_UseDepthPrepass = false;
+
+    if (m_UseDepthPrepass)
+    {
+        const GraphicsPipelineDesc& lit = m_Pipeline->GetDesc();
+
+        m_DepthPrepassPipeline = states->GetGraphicsPipeline(
+            DepthPrepassDesc(lit, "shaders/depth_prepass.vert.spv", ""));
+        m_DepthPrepassAlphaPipeline = states->GetGraphicsPipeline(
+            DepthPrepassDesc(lit, "shaders/lighting.vert.spv", "shaders/depth_alpha.frag.spv"));
+        m_DepthEqualPipeline = states->GetGraphicsPipeline(DepthEqualDesc(lit));
+
+        LOG_INFO("Depth pre-pass enabled");
+    }
 
 
     // Default textures (1x1)
@@ -304,25 +478,54 @@ void Application::Run()
     );
 
 
+    // GPU culling path (needs firstInstance in indirect draws)
+    if (m_UseGpuCulling && m_Device->GetEnabledFeatures().drawIndirectFirstInstance)
+    {
+        // Hi-Z pyramid of the early-pass depth + a LOAD pass for the late draws
+        m_DepthPyramid = new VulkanDepthPyramid(m_Device, m_DepthBuffer);
+        m_LoadRenderPass = new VulkanRenderPass(m_Device, colorFmt, depthFmt, RenderPassLoad::Load, resolveLayout);
+
+        m_GpuCulling = new VulkanGpuCulling(m_Device, FRAMES_IN_FLIGHT, m_DepthPyramid);
+
+        std::vector<VkDescriptorSetLayout> indirectLayouts = {
+            m_Descriptors->GetLayout(),  // set = 0 (Scene UBO)
+            m_MaterialPool->GetLayout(), // set = 1 (Material table)
+            m_GpuCulling->GetLayout()    // set = 2 (Instances + visible list)
+        };
+
+        GraphicsPipelineDesc indirectDesc;
+        indirectDesc.renderPass = m_RenderPass->GetHandle();
+        indirectDesc.setLayouts = indirectLayouts;
+        indirectDesc.vertSpv = "shaders/lighting_indirect.vert.spv";
+        indirectDesc.fragSpv = "shaders/lighting.frag.spv";
+        m_IndirectPipeline = states->GetGraphicsPipeline(indirectDesc);
+
+        if (m_UseDepthPrepass)
+        {
+            const GraphicsPipelineDesc& lit = m_IndirectPipeline->GetDesc();
 
+            m_IndirectDepthPrepassPipeline = states->GetGraphicsPipeline(
+                DepthPrepassDesc(lit, "shaders/depth_prepass_indirect.vert.spv", ""));
+            m_IndirectDepthPrepassAlphaPipeline = states->GetGraphicsPipeline(
+                DepthPrepassDesc(lit, "shaders/lighting_indirect.vert.spv", "shaders/depth_alpha.frag.spv"));
+            m_IndirectDepthEqualPipeline = states->GetGraphicsPipeline(DepthEqualDesc(lit));
+        }
+    }
+    else
+    {
+        m_UseGpuCulling = false;
+        LOG_WARN("GPU culling disabled (drawIndirectFirstInstance unsupported). Using CPU draw path.");
+    }
 
-    // Create pipeline (use unlit3d shaders, set0 only)
-    m_Pipeline = new VulkanPipeline(
-        m_Device,
-        m_Swapchain,
-        m_RenderPass,
-        layouts,
-        //m_Descriptors->GetLayout(),
-        "shaders/lighting.vert.spv",
-        "shaders/lighting.frag.spv"
-    );
-
-
-    // Disable cursor for camera movement
-    GLFWwindow* wnd = m_Window->GetHandle();
+    // CPU draw path: coarse software depth buffer of the designated occluders
+    m_WorkerPool = new ThreadPool();
+    m_SoftwareOcclusion = new SoftwareOcclusionCuller(320, 180, m_WorkerPool);
+    m_SecondaryCommandBuffers = new VulkanSecondaryCommandBuffers(m_Device, m_WorkerPool, FRAMES_IN_FLIGHT);
 
+    // The CPU path executes its secondaries inside the frame's statistics query
+    if (m_FrameStats && m_FrameStats->CanQueryAcrossSecondaries())
+        m_SecondaryCommandBuffers->SetInheritedPipelineStatistics(m_FrameStats->GetPipelineStatisticFlags());
 
-    //glfwSetInputMode(wnd, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
 	// Camera setup
     m_Camera = new Camera();
@@ -330,20 +533,29 @@ void Application::Run()
     m_Camera->SetYawPitch(0.0f, 0.0f);
     m_Camera->SetPerspective(glm::radians(60.0f), 0.1f, 10000.0f);
 
-    m_LastTime = (float)glfwGetTime();
+    m_LastTime = NowSeconds();
 
 	// Camera controller 
     m_CameraController = new CameraController(m_Camera);
 
-    glfwSetWindowUserPointer(wnd, m_CameraController);
+    if (!m_Headless)
+    {
+        // Disable cursor for camera movement
+        GLFWwindow* wnd = m_Window->GetHandle();
 
-    glfwSetScrollCallback(wnd,
-        [](GLFWwindow* wnd, double, double yOffset)
-        {
-            auto* controller =
-                static_cast<CameraController*>(glfwGetWindowUserPointer(wnd));
-            controller->OnScroll(yOffset);
-        });
+
+        //glfwSetInputMode(wnd, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+        glfwSetWindowUserPointer(wnd, m_CameraController);
+
+        glfwSetScrollCallback(wnd,
+            [](GLFWwindow* wnd, double, double yOffset)
+            {
+                auto* controller =
+                    static_cast<CameraController*>(glfwGetWindowUserPointer(wnd));
+                controller->OnScroll(yOffset);
+            });
+    }
 
 
 	//  Mesh creation
@@ -356,16 +568,20 @@ void Application::Run()
     //    VkDeviceSize(TRIANGLE_INDICES.size() * sizeof(TRIANGLE_INDICES[0])),
     //    (uint32_t)TRIANGLE_INDICES.size()
     //);
+    std::vector<LoadedNode> loadedNodes;
     auto loadedMeshes = ModelLoader::LoadStaticModel(
         m_Device,
         //"C:/Users/onkar/Downloads/uploads_files_3053791_Matteuccia_Struthiopteris_FBX/Matteuccia_Struthiopteris_FBX/matteucia_struthiopteris_3.fbx"
         //"C:/Users/onkar/Downloads/6e48z1kc7r40-bugatti/bugatti/bugatti.obj"
-        "G:/VXR_Engine/assets/selene.fbx"
+        m_ScenePath
          //"C:/Users/onkar/Downloads/uploads_files_6647155_01_Street_Wear_Mesh_and_Textures/Skeleton_Meshes/FBX/bodyShapeAof2/Street_Wear_Combined_Mesh_A.fbx"
          //"C:/Users/onkar/Downloads/uploads_files_642137_goku+Low+Poly(v1)(1)/goku real4armature.obj"
         //"C:/Users/onkar/Downloads/wolf/WOLF.OBJ"
+        , &loadedNodes
     );
 
+    std::vector<MaterialInstance*> meshMaterials;
+
     for (auto& lm : loadedMeshes)
     {
         VulkanTexture2D* albedo =
@@ -389,152 +605,343 @@ void Application::Run()
         }
 
 
+        // Shading toggles this material needs (see ShaderFeatures)
+        ShaderFeatures features;
+        features.normalMapping = lm.normalPath.empty() ? VK_FALSE : VK_TRUE;
+        features.alphaTest = albedo->HasTransparency() ? VK_TRUE : VK_FALSE;
+
         MaterialInstance* mat = new MaterialInstance(
             m_Device,
             m_MaterialPool,
             m_MaterialTemplate,
             albedo->GetView(), albedo->GetSampler(),
-            normal->GetView(), normal->GetSampler()
+            normal->GetView(), normal->GetSampler(),
+            features
         );
 		m_RuntimeMaterials.push_back(mat);
-
-        RenderObject& obj = m_Scene.CreateObject();
-        obj.mesh = lm.mesh.get();
-        obj.material = mat;
-        obj.pipeline = m_Pipeline;
+        meshMaterials.push_back(mat);
 
         m_OwnedMeshes.push_back(std::move(lm.mesh));
     }
 
+    // Keep the imported node hierarchy instead of flattening it
+    const size_t firstMesh = m_OwnedMeshes.size() - loadedMeshes.size();
+    InstantiateModel(loadedNodes, firstMesh, meshMaterials, TransformStore::INVALID_ID);
+
+    if (m_RunVertexBenchmark)
+        SetupVertexBenchmark(loadedNodes, firstMesh, meshMaterials, layouts, FRAMES_IN_FLIGHT);
+    else if (m_RunSceneBenchmark)
+        SetupSceneBenchmark(FRAMES_IN_FLIGHT);
 
-    m_CommandBuffers = new VulkanCommandBuffers(
-        m_Device,
-        m_GraphicsCmdPool,
-        m_Swapchain,
-        m_RenderPass,
-        m_Framebuffers
-    );
-    
+
+    // One transient pool + primary buffer per frame slot
+    m_CommandBuffers = new VulkanCommandBuffers(m_Device, FRAMES_IN_FLIGHT);
 
     // 11) Sync
+    // Headless frames are never presented: no per-image semaphores
     m_Sync = new VulkanSync(
         m_Device,
-        2, // maxFramesInFlight
-        static_cast<uint32_t>(m_Swapchain->GetImageViews().size())
+        FRAMES_IN_FLIGHT,
+        m_Headless ? 0 : m_Swapchain->GetImageCount()
     );
 
 	// Lighting UBO setup
-    m_SceneUBO.lighting.sun = MakeSunLight();
+    m_LightStorage->SetSun(MakeSunLight());
 
-    m_SceneUBO.lighting.pointLightCount = 1;
-    m_SceneUBO.lighting.pointLights[0] =
-        MakePointLight({ 0, 2, 0 }, { 1, 0.8f, 0.6f }, 10.0f, 2.0f);
+    m_LightStorage->AddPointLight(MakePointLight({ 0, 2, 0 }, { 1, 0.8f, 0.6f }, 10.0f, 2.0f));
+    if (m_ExtraPointLights > 0)
+        SpawnPointLights(m_ExtraPointLights);
 
-    m_SceneUBO.lighting.spotLightCount = 0;
+    m_PipelineCache->LogCreationTime("startup");
 
     // Main loop
-    while (!m_Window->ShouldClose())
+    while (true)
     {
-        glfwPollEvents();
+        if (m_VertexBenchmark && m_VertexBenchmark->IsFinished())
+            break;
+        if (m_SceneBenchmark && m_SceneBenchmark->IsFinished())
+            break;
+
+        if (m_Headless)
+        {
+            // A benchmark decides its own length
+            if (!m_VertexBenchmark && !m_SceneBenchmark && m_FrameNumber >= m_HeadlessSettings.frameCount)
+                break;
+        }
+        else
+        {
+            if (m_Window->ShouldClose())
+                break;
+
+            glfwPollEvents();
+        }
+
         DrawFrame();
     }
 
     vkDeviceWaitIdle(m_Device->GetHandle());
+
+    // Readbacks of the last frames in flight
+    if (m_Offscreen)
+    {
+        for (uint32_t i = 0; i < m_Offscreen->GetImageCount(); i++)
+        {
+            if (m_Offscreen->IsReadbackPending(i))
+                SaveCapture(i);
+        }
+    }
+
+    if (m_VertexBenchmark)
+        m_VertexBenchmark->Report();
+    if (m_SceneBenchmark)
+        m_SceneBenchmark->Report();
+
+    if (m_Profiler)
+    {
+        m_Profiler->Flush();
+        m_Profiler->ExportChromeTrace(m_ProfileTracePath);
+    }
+
+    // Frames still in flight, oldest slot first
+    if (m_FrameStats)
+    {
+        for (uint32_t i = 0; i < m_FramesInFlight; i++)
+        {
+            uint32_t slot = (m_Sync->GetCurrentFrame() + i) % m_FramesInFlight;
+            m_FrameStats->Resolve(slot, m_GpuCulling ? m_GpuCulling->ReadStats(slot) : GpuCullingStats{});
+        }
+    }
+
+    if (m_FallbackFrames > 0)
+        LOG_INFO("Pipelines: " + std::to_string(m_FallbackFrames) + " frames drawn on fallback pipelines");
+
+    if (!m_CameraRecordFile.empty() && m_RecordedPath.Save(m_CameraRecordFile))
+        LOG_INFO("Camera path (" + std::to_string(m_RecordedPath.GetKeyCount()) + " keys) written to " + m_CameraRecordFile);
 }
 
-void Application::DrawFrame()
+void Application::SetFramesInFlight(uint32_t framesInFlight)
 {
-    // 1) CPU-GPU pacing: wait for this frame slot
-    VkFence& inFlightFence = m_Sync->GetInFlightFence();
+    m_FramesInFlight = std::min(std::max(framesInFlight, 1u), MAX_FRAMES_IN_FLIGHT);
+}
 
-    vkWaitForFences(
-        m_Device->GetHandle(),
-        1,
-        &inFlightFence,
-        VK_TRUE,
-        UINT64_MAX
-    );
+void Application::EnableHeadless(const HeadlessSettings& settings)
+{
+    m_Headless = true;
+    m_HeadlessSettings = settings;
+    m_HeadlessSettings.width = std::max(settings.width, 1u);
+    m_HeadlessSettings.height = std::max(settings.height, 1u);
+}
 
-    vkResetFences(m_Device->GetHandle(), 1, &inFlightFence);
+void Application::EnableVertexBenchmark(const VertexBenchmarkSettings& settings)
+{
+    m_RunVertexBenchmark = true;
+    m_VertexBenchmarkSettings = settings;
+}
 
-    // 2) Acquire swapchain image
-    uint32_t imageIndex = 0;
-    VkSemaphore& imageAvailable = m_Sync->GetImageAvailableSemaphore(); // per-frame
+void Application::EnableSceneBenchmark(const SceneBenchmarkSettings& settings)
+{
+    m_RunSceneBenchmark = true;
+    m_SceneBenchmarkSettings = settings;
+    m_SceneBenchmarkSettings.timestep = std::max(settings.timestep, 1.0e-4f);
+}
 
-    VkResult acquireResult = vkAcquireNextImageKHR(
-        m_Device->GetHandle(),
-        m_Swapchain->GetHandle(),
-        UINT64_MAX,
-        imageAvailable,
-        VK_NULL_HANDLE,
-        &imageIndex
-    );
+void Application::EnableFrameStats(const std::string& csvPath)
+{
+    m_CollectFrameStats = true;
+    m_FrameStatsPath = csvPath;
+}
 
-    if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR)
+const FrameStats* Application::GetLastFrameStats() const
+{
+    return m_FrameStats ? &m_FrameStats->GetLast() : nullptr;
+}
+
+void Application::SpawnPointLights(uint32_t count)
+{
+    m_Scene.Update();
+
+    AABB bounds;
+    for (const AABB& world : m_Scene.GetWorldBounds())
     {
-        LOG_WARN("Swapchain out of date (resize). Skipping frame.");
-        return;
+        if (world.IsValid())
+        {
+            bounds.Expand(world.min);
+            bounds.Expand(world.max);
+        }
     }
-    if (acquireResult != VK_SUCCESS && acquireResult != VK_SUBOPTIMAL_KHR)
+
+    if (!bounds.IsValid())
     {
-        LOG_ERROR("Failed to acquire swapchain image!");
-        return;
+        bounds.Expand(glm::vec3(-10.0f));
+        bounds.Expand(glm::vec3(10.0f));
     }
 
+    // Each light covers a few percent of the scene: dense enough to overlap,
+    // small enough that clusters only list a handful
+    const glm::vec3 size = bounds.max - bounds.min;
+    const float radius = 0.05f * std::max(std::max(size.x, size.y), size.z);
 
-    // --- Delta time
-    float now = (float)glfwGetTime();
-    float dt = now - m_LastTime;
-    m_LastTime = now;
+    std::mt19937 rng(1234u);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
 
-    m_CameraController->Update(m_Window->GetHandle(), dt);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        glm::vec3 position = bounds.min + size * glm::vec3(unit(rng), unit(rng), unit(rng));
+        glm::vec3 color(0.25f + 0.75f * unit(rng), 0.25f + 0.75f * unit(rng), 0.25f + 0.75f * unit(rng));
+        m_LightStorage->AddPointLight(MakePointLight(position, color, radius, 1.0f));
+    }
 
-    // --- Update uniform buffer (per-frame)
-    uint32_t frame = m_Sync->GetCurrentFrame();
+    LOG_INFO("Spawned " + std::to_string(count) + " point lights (radius " + std::to_string(radius) + ")");
+}
 
- //   CameraUBO ubo{};
+void Application::InstantiateModel(
+    const std::vector<LoadedNode>& nodes,
+    size_t firstMesh,
+    const std::vector<MaterialInstance*>& meshMaterials,
+    uint32_t parentNode)
+{
+    // Nodes are listed parents first
+    std::vector<uint32_t> nodeTransforms(nodes.size());
 
- //   ubo.view = m_Camera->GetView();
+    for (size_t n = 0; n < nodes.size(); n++)
+    {
+        const LoadedNode& ln = nodes[n];
 
- //   float aspect =
- //       (float)m_Swapchain->GetExtent().width /
- //       (float)m_Swapchain->GetExtent().height;
+        uint32_t parent = ln.parent < 0 ? parentNode : nodeTransforms[ln.parent];
+        nodeTransforms[n] = m_Scene.CreateNode(parent);
+        m_Scene.GetTransforms().SetLocal(nodeTransforms[n], ln.position, ln.rotation, ln.scale);
 
- //   ubo.proj = m_Camera->GetProjection(aspect);
-	////ubo.proj[1][1] *= -1; // Vulkan clip correction
+        for (uint32_t meshIndex : ln.meshes)
+        {
+            Entity entity = m_Scene.CreateObject(nodeTransforms[n]);
+            m_Scene.SetMesh(entity, m_OwnedMeshes[firstMesh + meshIndex].get());
+            m_Scene.SetMaterial(entity, meshMaterials[meshIndex], m_UseDepthPrepass ? m_DepthEqualPipeline : m_Pipeline);
+        }
+    }
+}
 
- //   m_UniformBuffers->Update(frame, &ubo, sizeof(ubo));
+void Application::SetupVertexBenchmark(
+    const std::vector<LoadedNode>& nodes,
+    size_t firstMesh,
+    const std::vector<MaterialInstance*>& meshMaterials,
+    const std::vector<VkDescriptorSetLayout>& layouts,
+    uint32_t framesInFlight)
+{
+    // Every instance goes through the vertex shader every frame
+    m_UseGpuCulling = false;
+    m_UseSoftwareOcclusion = false;
+    m_UseFrustumCulling = false;
+
+    GraphicsPipelineDesc referenceDesc;
+    referenceDesc.renderPass = m_RenderPass->GetHandle();
+    referenceDesc.setLayouts = layouts;
+    referenceDesc.vertSpv = "shaders/lighting_inverse.vert.spv";
+    referenceDesc.fragSpv = "shaders/lighting.frag.spv";
+    m_ReferencePipeline = m_Device->GetStateCache()->GetGraphicsPipeline(referenceDesc);
+
+    // Grid spacing from the already instantiated model
+    m_Scene.Update();
+
+    AABB bounds;
+    for (const AABB& world : m_Scene.GetWorldBounds())
+    {
+        if (world.IsValid())
+        {
+            bounds.Expand(world.min);
+            bounds.Expand(world.max);
+        }
+    }
 
-	// Update scene UBO (lighting info)
-	m_SceneUBO.view = m_Camera->GetView();
+    const glm::vec3 size = bounds.IsValid() ? bounds.max - bounds.min : glm::vec3(1.0f);
+    const float spacing = 1.25f * std::max(std::max(size.x, size.z), 0.01f);
+    const uint32_t grid = std::max(1u, m_VertexBenchmarkSettings.gridSize);
 
-    float aspect =
-        (float)m_Swapchain->GetExtent().width /
-		(float)m_Swapchain->GetExtent().height;
+    for (uint32_t z = 0; z < grid; z++)
+    {
+        for (uint32_t x = 0; x < grid; x++)
+        {
+            if (x == 0 && z == 0)
+                continue; // the original instance
 
-	m_SceneUBO.projection = m_Camera->GetProjection(aspect);
+            uint32_t cell = m_Scene.CreateNode();
+            m_Scene.GetTransforms().SetPosition(cell, { x * spacing, 0.0f, -(float)z * spacing });
+            InstantiateModel(nodes, firstMesh, meshMaterials, cell);
+        }
+    }
 
-	m_UniformBuffers->Update(frame, &m_SceneUBO, sizeof(m_SceneUBO));
+    // Far enough that fragment work stays small next to vertex work
+    const float width = grid * spacing;
+    m_Camera->SetPosition({ width * 0.5f, width * 0.75f, width * 0.75f });
+    m_Camera->SetYawPitch(0.0f, -0.6f);
 
+    m_VertexBenchmark = new VertexBenchmark(
+        m_Device,
+        framesInFlight,
+        m_VertexBenchmarkSettings,
+        { "Precomputed normal matrix", "Per-vertex inverse()" });
 
+    LOG_INFO("Vertex benchmark: " + std::to_string(m_Scene.GetObjectCount()) + " objects");
+}
 
-    // 3) Record this image's command buffer
-    VkCommandBuffer cmd = m_CommandBuffers->GetBuffers()[imageIndex];
+void Application::SetupSceneBenchmark(uint32_t framesInFlight)
+{
+    CameraPath path;
+    const std::string& pathFile = m_SceneBenchmarkSettings.cameraPath;
 
-    vkResetCommandBuffer(cmd, 0);
+    if (pathFile.empty() || !path.Load(pathFile))
+    {
+        if (!pathFile.empty())
+            LOG_WARN("Scene benchmark: falling back to the scripted orbit");
 
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        // Orbit sized from the loaded scene, one lap every 10 simulated seconds
+        m_Scene.Update();
 
-    if (vkBeginCommandBuffer(cmd, &beginInfo) != VK_SUCCESS)
-    {
-        LOG_ERROR("Failed to begin command buffer!");
-        return;
+        AABB bounds;
+        for (const AABB& world : m_Scene.GetWorldBounds())
+        {
+            if (world.IsValid())
+            {
+                bounds.Expand(world.min);
+                bounds.Expand(world.max);
+            }
+        }
+
+        const glm::vec3 center = bounds.IsValid() ? bounds.Center() : glm::vec3(0.0f);
+        const float radius = bounds.IsValid() ? std::max(glm::length(bounds.Extents()), 0.01f) : 1.0f;
+
+        path = CameraPath::Orbit(center, 2.0f * radius, 0.5f * radius, 10.0f);
     }
 
-    // Render pass begin
-    VkExtent2D extent = m_Swapchain->GetExtent();
+    m_SceneBenchmark = new SceneBenchmark(m_Device, framesInFlight, m_SceneBenchmarkSettings, path);
 
+    const VkExtent2D extent = GetTargetExtent();
+    m_SceneBenchmark->Describe("scene", m_ScenePath);
+    m_SceneBenchmark->Describe("objects", std::to_string(m_Scene.GetObjectCount()));
+    m_SceneBenchmark->Describe("resolution", std::to_string(extent.width) + "x" + std::to_string(extent.height));
+    m_SceneBenchmark->Describe("framesInFlight", std::to_string(framesInFlight));
+    m_SceneBenchmark->Describe("headless", m_Headless ? "true" : "false");
+    m_SceneBenchmark->Describe("culling",
+        !m_UseGpuCulling ? "cpu" : (m_UseOcclusionCulling ? "gpu+hiz" : "gpu"));
+    m_SceneBenchmark->Describe("depthPrepass", m_UseDepthPrepass ? "true" : "false");
+
+    LOG_INFO("Scene benchmark: " + std::to_string(m_Scene.GetObjectCount()) + " objects, " +
+        std::to_string(path.GetKeyCount()) + " camera keys");
+}
+
+VkExtent2D Application::GetTargetExtent() const
+{
+    return m_Headless ? m_Offscreen->GetExtent() : m_Swapchain->GetExtent();
+}
+
+void Application::BeginScenePass(
+    VkCommandBuffer cmd,
+    VulkanRenderPass* renderPass,
+    uint32_t imageIndex,
+    VkSubpassContents contents)
+{
+    VkExtent2D extent = GetTargetExtent();
+
+    // Ignored by a Load pass
     std::array<VkClearValue, 3> clears{};
     clears[0].color = { { 0.1f, 0.1f, 0.1f, 1.0f } }; // MSAA color attachment
     clears[1].depthStencil = { 1.0f, 0 };             // depth
@@ -543,14 +950,23 @@ void Application::DrawFrame()
 
     VkRenderPassBeginInfo rpBegin{};
     rpBegin.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    rpBegin.renderPass = m_RenderPass->GetHandle();
+    rpBegin.renderPass = renderPass->GetHandle();
     rpBegin.framebuffer = m_Framebuffers->GetFramebuffers()[imageIndex];
     rpBegin.renderArea.offset = { 0, 0 };
     rpBegin.renderArea.extent = extent;
     rpBegin.clearValueCount = static_cast<uint32_t>(clears.size());
     rpBegin.pClearValues = clears.data();
 
-    vkCmdBeginRenderPass(cmd, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(cmd, &rpBegin, contents);
+
+    // Secondary buffers set their own dynamic state
+    if (contents == VK_SUBPASS_CONTENTS_INLINE)
+        SetViewportAndScissor(cmd);
+}
+
+void Application::SetViewportAndScissor(VkCommandBuffer cmd)
+{
+    VkExtent2D extent = GetTargetExtent();
 
     VkViewport viewport{};
     viewport.x = 0.0f;
@@ -565,99 +981,281 @@ void Application::DrawFrame()
     scissor.offset = { 0, 0 };
     scissor.extent = extent;
     vkCmdSetScissor(cmd, 0, 1, &scissor);
+}
 
+void Application::RecordDrawCommands(
+    VkCommandBuffer cmd,
+    uint32_t frame,
+    const std::vector<RenderCommand>& commands,
+    uint32_t begin,
+    uint32_t end)
+{
+    PROFILE_CPU_ZONE(m_Profiler, "Record draws");
 
-	// draw meshes
-    RenderQueue renderQueue;
-    renderQueue.Clear();
+    SetViewportAndScissor(cmd);
 
-    for (const RenderObject& obj : m_Scene.GetObjects())
-    {
-        renderQueue.Submit(obj);
-    }
+    // Commands are sorted: only rebind when the pipeline changes. Set 1 is
+    // the bindless material table, the same for every draw.
+    VulkanPipeline* boundPipeline = nullptr;
+
+    // Counted locally, reported once per chunk
+    uint32_t pipelineBinds = 0;
+    uint32_t descriptorBinds = 0;
+    uint64_t triangles = 0;
 
-    for (const RenderCommand& rc : renderQueue.GetCommands())
+    for (uint32_t i = begin; i < end; i++)
     {
-        vkCmdBindPipeline(
-            cmd,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            rc.pipeline->GetHandle()
-        );
+        const RenderCommand& rc = commands[i];
 
-        //// Set 0 (global/per-frame)
-        VkDescriptorSet globalSet0 = m_Descriptors->GetSet(frame);
-        VkDescriptorSet materialSet1 = rc.materialSet;
+        if (rc.pipeline != boundPipeline)
+        {
+            pipelineBinds++;
+            descriptorBinds++;
+
+            vkCmdBindPipeline(
+                cmd,
+                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                rc.pipeline->GetHandle()
+            );
+
+            // Set 0 (global/per-frame), set 1 (material table)
+            VkDescriptorSet sets[] = { m_Descriptors->GetSet(frame), m_MaterialPool->GetSet() };
+
+            vkCmdBindDescriptorSets(
+                cmd,
+                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                rc.pipeline->GetLayout(),   // IMPORTANT: match the currently bound pipeline layout
+                0,
+                2,
+                sets,
+                0,
+                nullptr
+            );
+
+            boundPipeline = rc.pipeline;
+        }
 
-        VkDescriptorSet sets[] = { globalSet0, materialSet1 };
+        PushConstants pc{};
+        pc.model = rc.model;
+        SetNormalMatrix(pc, rc.normal);
+        pc.lights = rc.lights;
 
-        vkCmdBindDescriptorSets(
+        vkCmdPushConstants(
             cmd,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            rc.pipeline->GetLayout(),   // IMPORTANT: match the currently bound pipeline layout
-            0,
-            2,
-            sets,
+            rc.pipeline->GetLayout(),
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
             0,
-            nullptr
+            sizeof(PushConstants),
+            &pc
         );
 
-        
+        // The material index travels as the instance index (push constants are full)
+        rc.mesh->Draw(cmd, rc.materialIndex);
+        triangles += rc.mesh->GetIndexCount() / 3;
+    }
+
+    if (m_FrameStats)
+    {
+        const uint32_t draws = end - begin;
+        m_FrameStats->CountDraws(draws, draws, triangles);
+        m_FrameStats->CountPipelineBinds(pipelineBinds);
+        m_FrameStats->CountDescriptorBinds(descriptorBinds);
+        m_FrameStats->CountPushConstants(draws);
+    }
+}
+
+void Application::RecordDepthPrepass(
+    VkCommandBuffer cmd,
+    uint32_t frame,
+    const std::vector<RenderCommand>& commands,
+    uint32_t begin,
+    uint32_t end)
+{
+    // Opaque materials: positions only, no material reads. Alpha-tested ones:
+    // full stream + albedo, discarding exactly where the lit pass does.
+    VulkanPipeline* boundPipeline = nullptr;
+
+    uint32_t pipelineBinds = 0;
+    uint32_t descriptorBinds = 0;
+
+    for (uint32_t i = begin; i < end; i++)
+    {
+        const RenderCommand& rc = commands[i];
+        const bool alphaTest = rc.material->GetFeatures().alphaTest == VK_TRUE;
+        VulkanPipeline* pipeline = alphaTest ? m_DepthPrepassAlphaPipeline : m_DepthPrepassPipeline;
+
+        if (pipeline != boundPipeline)
+        {
+            pipelineBinds++;
+            descriptorBinds++;
+
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->GetHandle());
+
+            // Same layout as the lit pipelines: set 0 (global/per-frame), set 1 (material table)
+            VkDescriptorSet sets[] = { m_Descriptors->GetSet(frame), m_MaterialPool->GetSet() };
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->GetLayout(), 0, 2, sets, 0, nullptr);
+
+            boundPipeline = pipeline;
+        }
 
         PushConstants pc{};
-        pc.model = rc.model; 
+        pc.model = rc.model;
 
         vkCmdPushConstants(
             cmd,
-            rc.pipeline->GetLayout(),
+            pipeline->GetLayout(),
             VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
             0,
             sizeof(PushConstants),
             &pc
         );
 
-        rc.mesh->Draw(cmd);
+        if (alphaTest)
+            rc.mesh->Draw(cmd, rc.materialIndex);
+        else
+            rc.mesh->DrawPositions(cmd);
     }
 
+    if (m_FrameStats)
+    {
+        // Draw calls only: the same instances + triangles are counted once, by the lit pass
+        const uint32_t draws = end - begin;
+        m_FrameStats->CountDraws(draws, 0, 0);
+        m_FrameStats->CountPipelineBinds(pipelineBinds);
+        m_FrameStats->CountDescriptorBinds(descriptorBinds);
+        m_FrameStats->CountPushConstants(draws);
+    }
+}
 
+bool Application::RecreateSwapchain()
+{
+    // Minimized: nothing to present to until the window comes back
+    if (m_Window->GetWidth() == 0 || m_Window->GetHeight() == 0)
+        return false;
+
+    VulkanTimeline* timeline = m_Device->GetTimeline();
+
+    // Everything recorded so far references the old targets. Presents are
+    // invisible to the timeline (core Vulkan gives them no fence) and the last
+    // ones of the old swapchain may still wait on its render-finished
+    // semaphores. Presents are consumed in queue order, so once the new
+    // swapchain's first frames have gone around every slot (the submit
+    // FRAMES_IN_FLIGHT later has completed), its first present and every
+    // old one before it are done.
+    const uint64_t retireAt = timeline->GetSubmittedValue() + m_FramesInFlight;
+
+    VulkanSwapchain* oldSwapchain = m_Swapchain;
+    VulkanDepthBuffer* oldDepth = m_DepthBuffer;
+    VulkanMSAAColorBuffer* oldMSAA = m_MSAAColor;
+    VulkanFramebuffers* oldFramebuffers = m_Framebuffers;
+    VulkanDepthPyramid* oldPyramid = m_DepthPyramid;
 
+    m_Swapchain = new VulkanSwapchain(
+        m_Instance->GetHandle(),
+        m_Device,
+        m_Surface,
+        m_Window->GetWidth(),
+        m_Window->GetHeight(),
+        oldSwapchain->GetHandle()
+    );
 
-    vkCmdEndRenderPass(cmd);
+    // Render passes (and the pipelines built against them) stay valid as long
+    // as the surface format does; viewport + scissor are dynamic
+    if (m_Swapchain->GetImageFormat() != oldSwapchain->GetImageFormat())
+        throw std::runtime_error("Application: surface format changed on swapchain recreation");
 
-    if (vkEndCommandBuffer(cmd) != VK_SUCCESS)
+    VkExtent2D extent = m_Swapchain->GetExtent();
+
+    m_DepthBuffer = new VulkanDepthBuffer(m_Device, extent);
+    m_MSAAColor = new VulkanMSAAColorBuffer(m_Device, m_Swapchain->GetImageFormat(), extent);
+    m_Framebuffers = new VulkanFramebuffers(
+        m_Device,
+        m_Swapchain->GetImageViews(),
+        extent,
+        m_RenderPass,
+        m_DepthBuffer,
+        m_MSAAColor
+    );
+
+    if (m_GpuCulling)
     {
-        LOG_ERROR("Failed to record command buffer!");
-        return;
+        // Each culling set switches over when its slot comes around again
+        m_DepthPyramid = new VulkanDepthPyramid(m_Device, m_DepthBuffer);
+        m_GpuCulling->SetDepthPyramid(m_DepthPyramid);
     }
 
-    // 4) Submit
-    VkSemaphore waitSemaphores[] = { imageAvailable };
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    m_Sync->SetImageCount(m_Swapchain->GetImageCount());
+
+    timeline->Retire(retireAt, [oldSwapchain, oldDepth, oldMSAA, oldFramebuffers, oldPyramid]()
+        {
+            delete oldFramebuffers;
+            delete oldPyramid;
+            delete oldMSAA;
+            delete oldDepth;
+            delete oldSwapchain;
+        });
+
+    m_SwapchainDirty = false;
 
-    VkSemaphore& renderFinished = m_Sync->GetRenderFinishedSemaphore(imageIndex); // per-image
-    VkSemaphore signalSemaphores[] = { renderFinished };
+    LOG_INFO("Swapchain recreated: " + std::to_string(extent.width) + "x" + std::to_string(extent.height));
+    return true;
+}
 
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &cmd;
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = signalSemaphores;
+bool Application::AcquireImage(uint32_t& imageIndex)
+{
+    PROFILE_CPU_ZONE(m_Profiler, "Acquire");
 
-    if (vkQueueSubmit(
-        m_Device->GetGraphicsQueue(),
-        1,
-        &submitInfo,
-        inFlightFence
-    ) != VK_SUCCESS)
+    // Resize seen by the window, or the last present asked for it. Only this
+    // slot was waited on: the other frames in flight keep the old targets.
+    if (m_Window->ConsumeResized() || m_SwapchainDirty)
     {
-        LOG_ERROR("Failed to submit draw command buffer!");
-        return;
+        if (!RecreateSwapchain())
+        {
+            // Minimized: sleep until the window changes, then retry
+            m_SwapchainDirty = true;
+            glfwWaitEvents();
+            return false;
+        }
     }
 
-    // 5) Present
+    VkSemaphore& imageAvailable = m_Sync->GetImageAvailableSemaphore(); // per-frame
+
+    VkResult acquireResult = vkAcquireNextImageKHR(
+        m_Device->GetHandle(),
+        m_Swapchain->GetHandle(),
+        UINT64_MAX,
+        imageAvailable,
+        VK_NULL_HANDLE,
+        &imageIndex
+    );
+
+    if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR)
+    {
+        // The acquire semaphore was not signaled: recreate, and this slot
+        // renders with the new swapchain next frame
+        if (!RecreateSwapchain())
+            m_SwapchainDirty = true;
+        return false;
+    }
+
+    // Still presentable: draw this frame, recreate after presenting it
+    if (acquireResult == VK_SUBOPTIMAL_KHR)
+        m_SwapchainDirty = true;
+    if (acquireResult != VK_SUCCESS && acquireResult != VK_SUBOPTIMAL_KHR)
+    {
+        LOG_ERROR("Failed to acquire swapchain image!");
+        return false;
+    }
+
+    return true;
+}
+
+void Application::PresentImage(uint32_t imageIndex)
+{
+    PROFILE_CPU_ZONE(m_Profiler, "Present");
+
+    VkSemaphore signalSemaphores[] = { m_Sync->GetRenderFinishedSemaphore(imageIndex) }; // per-image
+
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
@@ -672,12 +1270,462 @@ void Application::DrawFrame()
 
     if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR)
     {
-        LOG_WARN("Swapchain out of date/suboptimal on present. Skipping.");
+        // Recreated at the start of the next frame
+        m_SwapchainDirty = true;
     }
     else if (presentResult != VK_SUCCESS)
     {
         LOG_ERROR("Failed to present swapchain image!");
     }
+}
+
+bool Application::ShouldCapture(uint64_t frameNumber) const
+{
+    const HeadlessSettings& settings = m_HeadlessSettings;
+
+    if (settings.capturePath.empty())
+        return false;
+
+    if (frameNumber + 1 == settings.frameCount)
+        return true;
+
+    return settings.captureInterval > 0 && (frameNumber + 1) % settings.captureInterval == 0;
+}
+
+void Application::SaveCapture(uint32_t imageIndex)
+{
+    PROFILE_CPU_ZONE(m_Profiler, "Save capture");
+
+    m_Offscreen->ReadPixels(imageIndex, m_CapturePixels);
+
+    // Numbered files when capturing more than the last frame
+    std::string path = m_HeadlessSettings.capturePath;
+    if (m_HeadlessSettings.captureInterval > 0)
+    {
+        char number[32];
+        std::snprintf(number, sizeof(number), "_%05llu", (unsigned long long)m_CaptureFrames[imageIndex]);
+
+        const size_t slash = path.find_last_of("/\\");
+        const size_t dot = path.find_last_of('.');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            path += number;
+        else
+            path.insert(dot, number);
+    }
+
+    VkExtent2D extent = m_Offscreen->GetExtent();
+    if (WriteImage(path, extent.width, extent.height, m_CapturePixels))
+        LOG_INFO("Frame " + std::to_string(m_CaptureFrames[imageIndex]) + " written to " + path);
+}
+
+void Application::DrawFrame()
+{
+    PROFILE_CPU_ZONE(m_Profiler, "Frame");
+
+    // 1) CPU-GPU pacing: wait for this frame slot's last timeline value
+    {
+        PROFILE_CPU_ZONE(m_Profiler, "Wait for frame");
+        m_Sync->WaitForFrame();
+    }
+
+    // The slot's transient descriptor sets are no longer read
+    m_Device->GetDescriptorAllocator()->ResetFrame(m_Sync->GetCurrentFrame());
+
+    // The slot's timestamps from its previous use are final now
+    if (m_Profiler)
+        m_Profiler->BeginFrame(m_Sync->GetCurrentFrame());
+
+    // Finishes the slot's previous frame (before culling clears its counters)
+    if (m_FrameStats)
+    {
+        const uint32_t slot = m_Sync->GetCurrentFrame();
+        m_FrameStats->Resolve(slot, m_UseGpuCulling ? m_GpuCulling->ReadStats(slot) : GpuCullingStats{});
+        m_FrameStats->BeginFrame(slot, m_FrameNumber);
+    }
+
+    // 2) Target image: acquired from the swapchain, or this slot's offscreen image
+    uint32_t imageIndex = 0;
+
+    if (m_Headless)
+    {
+        // One image per frame slot, free (and its readback landed) now that
+        // the slot was waited on
+        imageIndex = m_Sync->GetCurrentFrame();
+
+        if (m_Offscreen->IsReadbackPending(imageIndex))
+            SaveCapture(imageIndex);
+    }
+    else if (!AcquireImage(imageIndex))
+    {
+        return;
+    }
+
+
+    // --- Delta time
+    double now = NowSeconds();
+    float dt = float(now - m_LastTime);
+    m_LastTime = now;
+
+    // CPU frame cost from here through submit / present (not the slot wait or acquire)
+    const double cpuStart = now;
+
+    if (m_SceneBenchmark)
+    {
+        // Simulated time: the same frames every run, however fast they render
+        dt = m_SceneBenchmark->GetTimestep();
+        m_SceneBenchmark->ApplyCamera(*m_Camera);
+    }
+    else if (!m_VertexBenchmark && !m_Headless)
+    {
+        // The vertex benchmark keeps a fixed camera; headless has no input
+        m_CameraController->Update(m_Window->GetHandle(), dt);
+
+        if (!m_CameraRecordFile.empty())
+        {
+            const bool due = m_RecordedPath.IsEmpty() ||
+                m_CameraRecordTime - m_RecordedPath.GetDuration() >= CAMERA_RECORD_INTERVAL;
+
+            if (due)
+                m_RecordedPath.AddKey({ m_CameraRecordTime, m_Camera->GetPosition(), m_Camera->GetYaw(), m_Camera->GetPitch() });
+
+            m_CameraRecordTime += dt;
+        }
+    }
+
+    // --- Update uniform buffer (per-frame)
+    uint32_t frame = m_Sync->GetCurrentFrame();
+
+    // This slot's frame has completed: its secondary buffers can be reused
+    m_SecondaryCommandBuffers->BeginFrame(frame);
+
+    // Benchmark: collect this slot's timing, switch variant when due
+    if (m_VertexBenchmark)
+    {
+        m_VertexBenchmark->BeginFrame(frame);
+
+        uint32_t variant = m_VertexBenchmark->GetVariant();
+        if (variant != m_BenchmarkVariant)
+        {
+            VulkanPipeline* pipeline = variant == 0 ? m_Pipeline : m_ReferencePipeline;
+            for (Entity entity : m_Scene.GetEntities())
+                m_Scene.SetPipeline(entity, pipeline);
+
+            m_BenchmarkVariant = variant;
+        }
+    }
+
+    if (m_SceneBenchmark)
+        m_SceneBenchmark->BeginFrame(frame);
+
+ //   CameraUBO ubo{};
+
+ //   ubo.view = m_Camera->GetView();
+
+ //   float aspect =
+ //       (float)m_Swapchain->GetExtent().width /
+ //       (float)m_Swapchain->GetExtent().height;
+
+ //   ubo.proj = m_Camera->GetProjection(aspect);
+	////ubo.proj[1][1] *= -1; // Vulkan clip correction
+
+ //   m_UniformBuffers->Update(frame, &ubo, sizeof(ubo));
+
+	// Update scene UBO (camera only: lights are uploaded when they change)
+	m_SceneUBO.view = m_Camera->GetView();
+
+    VkExtent2D targetExtent = GetTargetExtent();
+    float aspect =
+        (float)targetExtent.width /
+		(float)targetExtent.height;
+
+	m_SceneUBO.projection = m_Camera->GetProjection(aspect);
+
+	m_UniformBuffers->Update(frame, &m_SceneUBO, sizeof(m_SceneUBO));
+
+    // Permutations sized for the current lights (no spot light code without spot lights)
+    m_SceneFeatures.pointLightLimit = ShaderFeatures::LightLimit(m_LightStorage->GetPointLightCount(), MAX_LIGHTS_PER_CLUSTER);
+    m_SceneFeatures.spotLightLimit = ShaderFeatures::LightLimit(m_LightStorage->GetSpotLightCount(), MAX_SPOT_LIGHTS);
+    m_SceneFeatures.objectLightLists = m_UseObjectLightLists ? VK_TRUE : VK_FALSE;
+
+
+
+    // 3) Record this frame slot's command buffer (its pool is reset in bulk)
+    VkCommandBuffer cmd = m_CommandBuffers->Begin(frame);
+
+    if (cmd == VK_NULL_HANDLE)
+    {
+        LOG_ERROR("Failed to begin command buffer!");
+        return;
+    }
+
+    if (m_VertexBenchmark)
+        m_VertexBenchmark->WriteStart(cmd, frame);
+    if (m_SceneBenchmark)
+        m_SceneBenchmark->WriteStart(cmd, frame);
+
+    // Pipeline statistics over culling + the scene passes. The CPU path runs
+    // its draws in secondaries: only with inherited queries.
+    if (m_FrameStats && (m_UseGpuCulling || m_FrameStats->CanQueryAcrossSecondaries()))
+        m_FrameStats->BeginQuery(cmd);
+
+    // World matrices of moved transforms (+ their BVH leaves), both draw paths
+    {
+        PROFILE_CPU_ZONE(m_Profiler, "Scene update");
+        m_Scene.Update();
+    }
+
+    // Changed lights, then point lights -> froxel lists (or, with object
+    // lists, CPU frustum culling), before anything binds this slot's set 0
+    const LightCuller* lightCuller = m_UseObjectLightLists ? &m_LightCuller : nullptr;
+    {
+        PROFILE_CPU_ZONE(m_Profiler, "Light clusters");
+
+        if (m_LightStorage->Prepare(frame))
+            m_Descriptors->WriteLights(frame, m_LightStorage, m_LightClusters);
+
+        // Object lists leave the clusters empty: a cluster pipeline drawn as
+        // a fallback meanwhile shades no point lights
+        m_LightClusters->Prepare(
+            frame,
+            m_UseObjectLightLists ? 0 : m_LightStorage->GetPointLightCount(),
+            m_SceneUBO.view,
+            m_SceneUBO.projection,
+            m_Camera->GetNear(),
+            m_Camera->GetFar(),
+            GetTargetExtent());
+
+        if (m_UseObjectLightLists)
+        {
+            m_LightCuller.Cull(
+                Frustum::FromViewProjection(m_SceneUBO.projection * m_SceneUBO.view),
+                m_LightStorage->GetPointLights(),
+                m_LightStorage->GetSpotLights());
+        }
+        else
+        {
+            m_LightClusters->RecordBuild(cmd, m_Descriptors->GetSet(frame));
+        }
+    }
+
+    // GPU culling runs before the render pass and fills the indirect draw list
+    // (early phase: frustum + last frame's visibility)
+    const bool occlusion = m_UseGpuCulling && m_UseOcclusionCulling;
+
+    if (m_UseGpuCulling)
+    {
+        m_GpuCulling->Prepare(
+            frame,
+            m_Scene,
+            m_UseDepthPrepass ? m_IndirectDepthEqualPipeline : m_IndirectPipeline,
+            m_SceneFeatures,
+            m_SceneUBO.view,
+            m_SceneUBO.projection,
+            m_Camera->GetNear(),
+            occlusion,
+            lightCuller
+        );
+        m_GpuCulling->RecordCull(cmd, frame, GpuCullPhase::Early);
+    }
+
+	// draw meshes
+    RenderQueue renderQueue;
+    renderQueue.Clear();
+
+    if (m_UseGpuCulling)
+    {
+        BeginScenePass(cmd, m_RenderPass, imageIndex);
+        if (m_UseDepthPrepass)
+        {
+            m_GpuCulling->RecordDepthDraws(cmd, frame, GpuCullPhase::Early, m_Descriptors->GetSet(frame), m_MaterialPool->GetSet(),
+                m_IndirectDepthPrepassPipeline, m_IndirectDepthPrepassAlphaPipeline);
+        }
+        m_GpuCulling->RecordDraws(cmd, frame, GpuCullPhase::Early, m_Descriptors->GetSet(frame), m_MaterialPool->GetSet());
+
+        // Late phase: Hi-Z from the early depth, then draw what became visible
+        if (occlusion)
+        {
+            vkCmdEndRenderPass(cmd);
+
+            m_DepthPyramid->Build(cmd);
+            m_GpuCulling->RecordCull(cmd, frame, GpuCullPhase::Late);
+
+            BeginScenePass(cmd, m_LoadRenderPass, imageIndex);
+            if (m_UseDepthPrepass)
+            {
+                m_GpuCulling->RecordDepthDraws(cmd, frame, GpuCullPhase::Late, m_Descriptors->GetSet(frame), m_MaterialPool->GetSet(),
+                    m_IndirectDepthPrepassPipeline, m_IndirectDepthPrepassAlphaPipeline);
+            }
+            m_GpuCulling->RecordDraws(cmd, frame, GpuCullPhase::Late, m_Descriptors->GetSet(frame), m_MaterialPool->GetSet());
+        }
+
+        vkCmdEndRenderPass(cmd);
+    }
+    else
+    {
+        PROFILE_CPU_ZONE(m_Profiler, "CPU cull + record");
+
+        glm::mat4 viewProj = m_SceneUBO.projection * m_SceneUBO.view;
+        Frustum frustum = Frustum::FromViewProjection(viewProj);
+
+        if (m_UseSoftwareOcclusion)
+        {
+            m_SoftwareOcclusion->BeginFrame(viewProj);
+
+            const std::vector<const OccluderMesh*>& occluders = m_Scene.GetOccluders();
+            const std::vector<glm::mat4>& world = m_Scene.GetWorldMatrices();
+
+            for (uint32_t i = 0; i < m_Scene.GetObjectCount(); i++)
+            {
+                if (occluders[i])
+                    m_SoftwareOcclusion->AddOccluder(occluders[i], world[i]);
+            }
+
+            m_SoftwareOcclusion->Rasterize();
+        }
+
+        // BVH frustum query, then the occlusion test on the survivors
+        m_VisibleObjects.clear();
+        if (m_UseFrustumCulling)
+        {
+            m_Scene.QueryFrustum(frustum, m_VisibleObjects);
+        }
+        else
+        {
+            for (uint32_t i = 0; i < m_Scene.GetObjectCount(); i++)
+                m_VisibleObjects.push_back(i);
+        }
+
+        const std::vector<const OccluderMesh*>& occluders = m_Scene.GetOccluders();
+        const std::vector<AABB>& bounds = m_Scene.GetWorldBounds();
+
+        for (uint32_t index : m_VisibleObjects)
+        {
+            // Occluders are not tested against themselves
+            if (m_UseSoftwareOcclusion && !occluders[index] && bounds[index].IsValid())
+            {
+                if (!m_SoftwareOcclusion->IsVisible(bounds[index]))
+                    continue;
+            }
+
+            renderQueue.Submit(m_Scene, index, m_SceneFeatures, lightCuller);
+        }
+
+        // Sorted queue split into chunks, recorded in parallel into secondary
+        // buffers and executed by the primary. With the depth pre-pass every
+        // command is recorded twice: depth as items [0, n), lit as [n, 2n).
+        // Chunks execute in order, so all depth draws come first.
+        renderQueue.Sort();
+        const std::vector<RenderCommand>& commands = renderQueue.GetCommands();
+
+        const uint32_t commandCount = static_cast<uint32_t>(commands.size());
+        const uint32_t prepassCount = m_UseDepthPrepass ? commandCount : 0;
+
+        const std::vector<VkCommandBuffer>& secondaries = m_SecondaryCommandBuffers->Record(
+            frame,
+            m_RenderPass->GetHandle(),
+            0,
+            m_Framebuffers->GetFramebuffers()[imageIndex],
+            prepassCount + commandCount,
+            [&](VkCommandBuffer secondary, uint32_t begin, uint32_t end)
+            {
+                if (begin < prepassCount)
+                    RecordDepthPrepass(secondary, frame, commands, begin, std::min(end, prepassCount));
+                if (end > prepassCount)
+                    RecordDrawCommands(secondary, frame, commands, std::max(begin, prepassCount) - prepassCount, end - prepassCount);
+            });
+
+        // Timestamps cannot go inside a secondary-contents pass: scope the whole pass
+        PROFILE_GPU_SCOPE(m_Profiler, cmd, "Scene pass");
+
+        BeginScenePass(cmd, m_RenderPass, imageIndex, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+        if (!secondaries.empty())
+            vkCmdExecuteCommands(cmd, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+
+        vkCmdEndRenderPass(cmd);
+    }
+
+    if (m_FrameStats)
+    {
+        m_FrameStats->EndQuery(cmd);
+
+        uint32_t instances = 0;
+        uint64_t triangles = 0;
+        for (const Mesh* mesh : m_Scene.GetMeshes())
+        {
+            if (!mesh)
+                continue;
+            instances++;
+            triangles += mesh->GetIndexCount() / 3;
+        }
+        m_FrameStats->CountSubmitted(instances, triangles);
+    }
+
+    if (m_VertexBenchmark)
+    {
+        uint64_t indices = 0;
+        for (const RenderCommand& rc : renderQueue.GetCommands())
+            indices += rc.mesh->GetIndexCount();
+
+        m_VertexBenchmark->WriteEnd(cmd, frame, indices);
+    }
+
+    // Pipelines compiling in the background: this frame drew around them
+    const bool onFallback = m_UseGpuCulling ? m_GpuCulling->IsOnFallback() : renderQueue.GetFallbackCount() > 0;
+    if (onFallback)
+    {
+        m_FallbackFrames++;
+        if (m_FrameStats)
+            m_FrameStats->MarkFallbackPipelines();
+    }
+
+    // Draw calls recorded: one indirect draw per batch and phase, or one per
+    // queued command. The depth pre-pass records each of them once more.
+    uint32_t drawCalls = static_cast<uint32_t>(renderQueue.GetCommands().size());
+    if (m_UseGpuCulling)
+        drawCalls = m_GpuCulling->GetBatchCount(frame) * (occlusion ? 2u : 1u);
+    if (m_UseDepthPrepass)
+        drawCalls *= 2;
+
+    if (m_SceneBenchmark)
+        m_SceneBenchmark->WriteEnd(cmd, frame);
+
+    // Copy out the resolved image; written to disk once this slot comes around
+    if (m_Headless && ShouldCapture(m_FrameNumber))
+    {
+        m_Offscreen->RecordReadback(cmd, imageIndex);
+        m_CaptureFrames[imageIndex] = m_FrameNumber;
+    }
+
+    if (vkEndCommandBuffer(cmd) != VK_SUCCESS)
+    {
+        LOG_ERROR("Failed to record command buffer!");
+        return;
+    }
+
+    // 4) Submit: waits for the acquire, signals present + the frame's timeline value
+    {
+        PROFILE_CPU_ZONE(m_Profiler, "Submit");
+
+        if (m_Headless)
+            m_Sync->SubmitFrame(cmd);
+        else
+            m_Sync->SubmitFrame(cmd, imageIndex);
+    }
+
+    if (m_Profiler)
+        m_Profiler->EndFrame();
+    if (m_FrameStats)
+        m_FrameStats->EndFrame(m_UseGpuCulling);
+
+    // 5) Present
+    if (!m_Headless)
+        PresentImage(imageIndex);
+
+    if (m_SceneBenchmark)
+        m_SceneBenchmark->EndFrame((NowSeconds() - cpuStart) * 1.0e3, drawCalls);
+
+    m_FrameNumber++;
 
     // 6) Advance frame slot
     m_Sync->AdvanceFrame();
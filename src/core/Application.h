@@ -4,13 +4,20 @@
 #include "renderer/MaterialTemplate.h"
 #include "renderer/VulkanMaterialDescriptors.h"
 #include "renderer/SceneUBO.h"
+#include "renderer/culling/LightCuller.h"
 #include "Window.h"
+#include "bench/VertexBenchmark.h"
+#include "bench/SceneBenchmark.h"
+#include "bench/CameraPath.h"
 #include <vector>
 #include <memory>
+#include <array>
+#include <string>
 
 class VulkanInstance;
 class VulkanDevice;
 class VulkanSwapchain;
+class VulkanOffscreenTarget;
 class VulkanDepthBuffer;
 class VulkanMSAAColorBuffer;
 class VulkanRenderPass;
@@ -24,11 +31,34 @@ class VulkanUniformBuffers;
 class VulkanDescriptors;
 class VulkanIndexBuffer;
 class Mesh;
-class RenderObject;
 class Camera;
 class CameraController;
 class MaterialInstance;
 class VulkanTexture2D;
+class VulkanGpuCulling;
+class VulkanLightStorage;
+class VulkanLightClusters;
+class VulkanDepthPyramid;
+class SoftwareOcclusionCuller;
+class ThreadPool;
+struct LoadedNode;
+class VulkanSecondaryCommandBuffers;
+class VulkanProfiler;
+class VulkanFrameStats;
+class VulkanPipelineCache;
+struct FrameStats;
+struct RenderCommand;
+
+// --headless: offscreen images instead of a window + swapchain; GLFW is never
+// initialized. Frames can be read back and saved.
+struct HeadlessSettings
+{
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    uint32_t frameCount = 300;    // ignored while a benchmark drives the run
+    std::string capturePath;      // empty: no readback. ".png", otherwise PPM
+    uint32_t captureInterval = 0; // 0: last frame only. N: every Nth frame too, numbered files
+};
 
 class Application {
 public:
@@ -44,9 +74,122 @@ public:
     //void DrawFrame(CameraUBO* ubo);
 
     void DrawFrame();
+
+    // CPU/GPU overlap vs. latency. Sizes every per-frame resource (UBOs,
+    // descriptor sets, sync objects, command pools, culling buffers).
+    // Clamped to [1, MAX_FRAMES_IN_FLIGHT]; call before Run().
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+    void SetFramesInFlight(uint32_t framesInFlight);
+
+    // --bench-vertex: replaces the interactive loop with the vertex throughput run
+    void EnableVertexBenchmark(const VertexBenchmarkSettings& settings);
+
+    // --bench-scene: camera follows a path at a fixed timestep, stats go to JSON
+    void EnableSceneBenchmark(const SceneBenchmarkSettings& settings);
+
+    // Call before Run()
+    void EnableHeadless(const HeadlessSettings& settings);
+
+    // Model loaded by Run()
+    void SetScenePath(const std::string& path) { m_ScenePath = path; }
+
+    // Interactive runs: saves the flown camera as a path for --bench-scene
+    void RecordCameraPath(const std::string& path) { m_CameraRecordFile = path; }
+
+    // --profile: GPU scopes + CPU zones for the whole run, Chrome trace JSON on exit
+    void EnableProfiler(const std::string& tracePath) { m_ProfileTracePath = tracePath; }
+
+    // --frame-stats: per-frame draw / bind / upload counters + pipeline
+    // statistics. csvPath: one row per frame; empty: GetLastFrameStats() only.
+    void EnableFrameStats(const std::string& csvPath);
+
+    // Most recent finished frame; null unless EnableFrameStats() was called
+    const FrameStats* GetLastFrameStats() const;
+
+    // Frames where a pipeline was still compiling in the background (drawn
+    // with its fallback, or skipped)
+    uint64_t GetFallbackFrameCount() const { return m_FallbackFrames; }
+
+    // Pipeline cache file, loaded at startup and saved at shutdown. Empty: in-memory only.
+    void SetPipelineCachePath(const std::string& path) { m_PipelineCachePath = path; }
+
+    // --lights N: N extra point lights scattered over the scene bounds
+    // (fixed seed, same lights every run), shaded through the light clusters
+    void SetExtraPointLights(uint32_t count) { m_ExtraPointLights = count; }
+
+    // --object-lights: CPU frustum light culling + per-object lists of the
+    // strongest lights instead of the light cluster compute pass
+    void SetObjectLightLists(bool enabled) { m_UseObjectLightLists = enabled; }
+
+    // --depth-prepass: depth only first (position-only stream), then the lit
+    // pass tests EQUAL without writing depth, so lighting runs once per
+    // visible pixel. Worth it on heavy overdraw; compare with --bench-scene.
+    void SetDepthPrepass(bool enabled) { m_UseDepthPrepass = enabled; }
+
+private:
+    // Begins a scene render pass on this image's framebuffer + sets viewport/scissor
+    // (inline contents only; secondary buffers set their own)
+    void BeginScenePass(
+        VkCommandBuffer cmd,
+        VulkanRenderPass* renderPass,
+        uint32_t imageIndex,
+        VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
+
+    void SetViewportAndScissor(VkCommandBuffer cmd);
+
+    // Swapchain or offscreen extent
+    VkExtent2D GetTargetExtent() const;
+
+    // Windowed: recreates the swapchain when needed, then acquires. False
+    // when this frame has to be skipped.
+    bool AcquireImage(uint32_t& imageIndex);
+    void PresentImage(uint32_t imageIndex);
+
+    // Headless readback
+    bool ShouldCapture(uint64_t frameNumber) const;
+    void SaveCapture(uint32_t imageIndex);
+
+    // Rebuilds the swapchain and everything sized by it without idling the
+    // device: replaced resources are retired on the timeline behind the
+    // frames in flight. False while the window is minimized (skip the frame).
+    bool RecreateSwapchain();
+
+    // --lights: random point lights inside the instantiated scene's bounds
+    void SpawnPointLights(uint32_t count);
+
+    // One transform node per imported node under parentNode, one object per mesh reference
+    void InstantiateModel(
+        const std::vector<LoadedNode>& nodes,
+        size_t firstMesh,
+        const std::vector<MaterialInstance*>& meshMaterials,
+        uint32_t parentNode);
+
+    void SetupVertexBenchmark(
+        const std::vector<LoadedNode>& nodes,
+        size_t firstMesh,
+        const std::vector<MaterialInstance*>& meshMaterials,
+        const std::vector<VkDescriptorSetLayout>& layouts,
+        uint32_t framesInFlight);
+
+    void SetupSceneBenchmark(uint32_t framesInFlight);
+
+    // Records commands[begin, end). Called from worker threads.
+    void RecordDrawCommands(
+        VkCommandBuffer cmd,
+        uint32_t frame,
+        const std::vector<RenderCommand>& commands,
+        uint32_t begin,
+        uint32_t end);
+
+    // Depth pre-pass of commands[begin, end). Called from worker threads.
+    void RecordDepthPrepass(
+        VkCommandBuffer cmd,
+        uint32_t frame,
+        const std::vector<RenderCommand>& commands,
+        uint32_t begin,
+        uint32_t end);
     
 public:
-    std::vector<RenderObject> m_RenderObjects;
     std::vector<std::unique_ptr<Mesh>> m_OwnedMeshes;
 
     std::vector<VulkanTexture2D*> m_RuntimeTextures;     // textures created with new
@@ -72,8 +215,19 @@ private:
 
     VulkanCommandBuffers* m_CommandBuffers = nullptr;
     VulkanSync* m_Sync = nullptr;
+    bool m_SwapchainDirty = false; // suboptimal / out of date on present
+
+    // Headless: replaces window, surface and swapchain
+    bool m_Headless = false;
+    HeadlessSettings m_HeadlessSettings;
+    VulkanOffscreenTarget* m_Offscreen = nullptr; // one image per frame slot
+    std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> m_CaptureFrames{}; // frame number read back, per image
+    std::vector<uint8_t> m_CapturePixels;
+
+    uint64_t m_FrameNumber = 0; // frames submitted
+    uint32_t m_FramesInFlight = 2;
     VkSurfaceKHR          m_Surface = VK_NULL_HANDLE;
-    VulkanPipeline* m_Pipeline = nullptr;
+    VulkanPipeline* m_Pipeline = nullptr; // state cache owned
     VulkanVertexBuffer* m_VertexBuffer = nullptr;
     VulkanUniformBuffers* m_UniformBuffers = nullptr;
     VulkanDescriptors* m_Descriptors = nullptr;
@@ -85,7 +239,8 @@ private:
     CameraController* m_CameraController = nullptr;
 
 	MaterialTemplate* m_MaterialTemplate = nullptr;
-	VulkanMaterialDescriptors* m_MaterialPool = nullptr;
+	VulkanMaterialDescriptors* m_MaterialPool = nullptr; // bindless material table (set 1)
+    static constexpr uint32_t MAX_MATERIALS = 16384;
 
     VulkanTexture2D* m_DefaultAlbedo = nullptr;
     VulkanTexture2D* m_DefaultNormal = nullptr;
@@ -93,7 +248,84 @@ private:
 
 	SceneUBO m_SceneUBO = {};
 
-    float   m_LastTime = 0.0f;
+    // Light limits of this frame's shader permutations (from m_LightStorage)
+    ShaderFeatures m_SceneFeatures;
+
+    // Lights (any number), uploaded when they change; point lights are
+    // binned per froxel by the light clusters
+    VulkanLightStorage* m_LightStorage = nullptr;
+    VulkanLightClusters* m_LightClusters = nullptr;
+    uint32_t m_ExtraPointLights = 0;
+
+    // Small scenes: lights culled on the CPU, MAX_OBJECT_LIGHTS per draw
+    LightCuller m_LightCuller;
+    bool m_UseObjectLightLists = false;
+
+    // Depth pre-pass (state cache owned). The lit pipelines become EQUAL
+    // variants; alpha-tested materials fill depth with their own discard.
+    bool m_UseDepthPrepass = false;
+    VulkanPipeline* m_DepthPrepassPipeline = nullptr;      // positions only
+    VulkanPipeline* m_DepthPrepassAlphaPipeline = nullptr; // full stream + alpha discard
+    VulkanPipeline* m_DepthEqualPipeline = nullptr;        // lit, after the pre-pass
+    VulkanPipeline* m_IndirectDepthPrepassPipeline = nullptr;
+    VulkanPipeline* m_IndirectDepthPrepassAlphaPipeline = nullptr;
+    VulkanPipeline* m_IndirectDepthEqualPipeline = nullptr;
+
+    // GPU-driven culling (compute cull -> indirect draws)
+    VulkanGpuCulling* m_GpuCulling = nullptr;
+    VulkanPipeline* m_IndirectPipeline = nullptr;
+    bool m_UseGpuCulling = true;
+
+    // Two-phase Hi-Z occlusion culling (needs GPU culling)
+    VulkanDepthPyramid* m_DepthPyramid = nullptr;
+    VulkanRenderPass* m_LoadRenderPass = nullptr; // late pass, keeps early color/depth
+    bool m_UseOcclusionCulling = true;
+
+    // CPU path: masked software occlusion before the RenderQueue
+    ThreadPool* m_WorkerPool = nullptr;
+    SoftwareOcclusionCuller* m_SoftwareOcclusion = nullptr;
+    bool m_UseSoftwareOcclusion = true;
+    std::vector<uint32_t> m_VisibleObjects; // BVH frustum query result, reused per frame
+
+    // CPU path: draws recorded in parallel on m_WorkerPool
+    VulkanSecondaryCommandBuffers* m_SecondaryCommandBuffers = nullptr;
+    bool m_UseFrustumCulling = true;
+
+    // --bench-vertex
+    bool m_RunVertexBenchmark = false;
+    VertexBenchmarkSettings m_VertexBenchmarkSettings;
+    VertexBenchmark* m_VertexBenchmark = nullptr;
+    VulkanPipeline* m_ReferencePipeline = nullptr; // per-vertex inverse() variant
+    uint32_t m_BenchmarkVariant = UINT32_MAX;
+
+    // --bench-scene
+    bool m_RunSceneBenchmark = false;
+    SceneBenchmarkSettings m_SceneBenchmarkSettings;
+    SceneBenchmark* m_SceneBenchmark = nullptr;
+
+    // --record-path: one key every CAMERA_RECORD_INTERVAL seconds
+    static constexpr float CAMERA_RECORD_INTERVAL = 0.25f;
+    std::string m_CameraRecordFile;
+    CameraPath m_RecordedPath;
+    float m_CameraRecordTime = 0.0f;
+
+    std::string m_ScenePath = "G:/VXR_Engine/assets/selene.fbx";
+
+    // --profile
+    std::string m_ProfileTracePath;
+    VulkanProfiler* m_Profiler = nullptr;
+
+    // --frame-stats
+    bool m_CollectFrameStats = false;
+    std::string m_FrameStatsPath;
+    VulkanFrameStats* m_FrameStats = nullptr;
+
+    uint64_t m_FallbackFrames = 0;
+
+    std::string m_PipelineCachePath = "pipeline_cache.bin";
+    VulkanPipelineCache* m_PipelineCache = nullptr;
+
+    double  m_LastTime = 0.0;
 
 	// Mouse input handling
     bool   m_FirstMouse = true;
@@ -0,0 +1,98 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(uint32_t workerCount)
+{
+    if (workerCount == 0)
+    {
+        uint32_t hw = std::thread::hardware_concurrency();
+        workerCount = hw > 1 ? hw - 1 : 0;
+    }
+
+    m_Workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++)
+        m_Workers.emplace_back(&ThreadPool::WorkerLoop, this, i + 1);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_WakeCv.notify_all();
+
+    for (std::thread& t : m_Workers)
+        t.join();
+}
+
+void ThreadPool::ParallelFor(uint32_t taskCount, const std::function<void(uint32_t, uint32_t)>& fn)
+{
+    if (taskCount == 0)
+        return;
+
+    // Nothing to share: run inline
+    if (m_Workers.empty() || taskCount == 1)
+    {
+        for (uint32_t i = 0; i < taskCount; i++)
+            fn(i, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Job = &fn;
+        m_TaskCount = taskCount;
+        m_NextTask.store(0, std::memory_order_relaxed);
+        m_ActiveWorkers = static_cast<uint32_t>(m_Workers.size());
+        m_Generation++;
+    }
+    m_WakeCv.notify_all();
+
+    RunTasks(0);
+
+    // Workers still hold a pointer to fn until they check out
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_DoneCv.wait(lock, [this] { return m_ActiveWorkers == 0; });
+    m_Job = nullptr;
+}
+
+void ThreadPool::RunTasks(uint32_t threadIndex)
+{
+    const std::function<void(uint32_t, uint32_t)>& fn = *m_Job;
+
+    for (;;)
+    {
+        uint32_t task = m_NextTask.fetch_add(1, std::memory_order_relaxed);
+        if (task >= m_TaskCount)
+            break;
+        fn(task, threadIndex);
+    }
+}
+
+void ThreadPool::WorkerLoop(uint32_t threadIndex)
+{
+    uint64_t seenGeneration = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WakeCv.wait(lock, [&] { return m_Stop || m_Generation != seenGeneration; });
+
+            if (m_Stop)
+                return;
+
+            seenGeneration = m_Generation;
+        }
+
+        RunTasks(threadIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_ActiveWorkers--;
+        }
+        m_DoneCv.notify_one();
+    }
+}
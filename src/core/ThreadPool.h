@@ -0,0 +1,47 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include <cstdint>
+
+// Small fork-join pool for per-frame CPU work (culling, command recording).
+// ParallelFor blocks until every task is done; the calling thread takes part
+// as thread index 0, workers are 1..GetThreadCount()-1.
+class ThreadPool
+{
+public:
+    // workerCount = 0 -> hardware_concurrency - 1
+    explicit ThreadPool(uint32_t workerCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Worker threads + the caller
+    uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Workers.size()) + 1; }
+
+    // fn(taskIndex, threadIndex) for every taskIndex in [0, taskCount)
+    void ParallelFor(uint32_t taskCount, const std::function<void(uint32_t, uint32_t)>& fn);
+
+private:
+    void WorkerLoop(uint32_t threadIndex);
+    void RunTasks(uint32_t threadIndex);
+
+private:
+    std::vector<std::thread> m_Workers;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_WakeCv;
+    std::condition_variable m_DoneCv;
+
+    // Current job (guarded by m_Mutex, except the atomics)
+    const std::function<void(uint32_t, uint32_t)>* m_Job = nullptr;
+    uint32_t m_TaskCount = 0;
+    uint64_t m_Generation = 0;
+    uint32_t m_ActiveWorkers = 0;
+    std::atomic<uint32_t> m_NextTask{ 0 };
+    bool m_Stop = false;
+};
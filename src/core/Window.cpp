@@ -17,6 +17,9 @@ Window::Window(int width, int height, const std::string& title)
         glfwTerminate();
         return;
     }
+
+    // Swapchain extents are in pixels, which differs from the window size on high-DPI
+    glfwGetFramebufferSize(m_Window, &m_Width, &m_Height);
 }
 
 Window::~Window()
@@ -30,6 +33,20 @@ bool Window::ShouldClose() const
     return glfwWindowShouldClose(m_Window);
 }
 
+bool Window::ConsumeResized()
+{
+    int width = 0;
+    int height = 0;
+    glfwGetFramebufferSize(m_Window, &width, &height);
+
+    if (width == m_Width && height == m_Height)
+        return false;
+
+    m_Width = width;
+    m_Height = height;
+    return true;
+}
+
 VkSurfaceKHR Window::CreateSurface(VkInstance instance)
 {
     if (glfwCreateWindowSurface(instance, m_Window, nullptr, &m_Surface) != VK_SUCCESS)
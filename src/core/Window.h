@@ -20,6 +20,10 @@ public:
     int GetWidth()  const { return m_Width; }
     int GetHeight() const { return m_Height; }
 
+    // Polls the framebuffer size; true once per change (width/height are
+    // updated). 0 x 0 while minimized. Call after glfwPollEvents().
+    bool ConsumeResized();
+
 private:
     GLFWwindow* m_Window = nullptr;
     VkSurfaceKHR m_Surface = VK_NULL_HANDLE;
@@ -2,5 +2,13 @@
 #include <stdint.h>
 
 // Must match shader constants
-constexpr uint32_t MAX_POINT_LIGHTS = 32;
+
+// Spot lights are not clustered: every fragment loops over at most this many
 constexpr uint32_t MAX_SPOT_LIGHTS = 16;
+
+// Point lights live in a storage buffer (no fixed count); each light
+// cluster lists at most this many of them
+constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 128;
+
+// Per-object light lists (LightCuller): one uvec4 of light entries per draw
+constexpr uint32_t MAX_OBJECT_LIGHTS = 4;
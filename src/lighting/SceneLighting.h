@@ -2,14 +2,12 @@
 #include "LightingTypes.h"
 #include "LightingLimits.h"
 
+// std430 header of the scene light buffer (set 0, binding 4); the spot
+// lights follow it. Point lights have their own buffer (binding 2).
 struct SceneLighting
 {
     DirectionalLight sun;
 
-    uint32_t pointLightCount;
     uint32_t spotLightCount;
-    glm::vec2 padding; // std140
-
-    PointLight pointLights[MAX_POINT_LIGHTS];
-    SpotLight  spotLights[MAX_SPOT_LIGHTS];
+    uint32_t padding[3]; // the spot light array starts 16-byte aligned
 };
@@ -1,7 +1,107 @@
 #include "core/Application.h"
+#include "bench/OcclusionBenchmark.h"
+#include "bench/SpatialBenchmark.h"
+
+#include <cstring>
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench-occlusion") == 0)
+        return RunOcclusionBenchmark(argc, argv);
+
+    if (argc > 1 && std::strcmp(argv[1], "--bench-bvh") == 0)
+        return RunSpatialBenchmark(argc, argv);
 
-int main() {
     Application app;
+
+    // --frames-in-flight N (any position)
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--frames-in-flight") == 0)
+            app.SetFramesInFlight((uint32_t)std::atoi(argv[i + 1]));
+    }
+
+    // --headless [--frames N] [--size W H] [--capture out.png|out.ppm] [--capture-every N]
+    // (any position, combines with the benchmarks below)
+    HeadlessSettings headless;
+    bool runHeadless = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--headless") == 0)
+            runHeadless = true;
+        else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            headless.frameCount = (uint32_t)std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 2 < argc)
+        {
+            headless.width = (uint32_t)std::atoi(argv[++i]);
+            headless.height = (uint32_t)std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+            headless.capturePath = argv[++i];
+        else if (std::strcmp(argv[i], "--capture-every") == 0 && i + 1 < argc)
+            headless.captureInterval = (uint32_t)std::atoi(argv[++i]);
+    }
+
+    if (runHeadless)
+        app.EnableHeadless(headless);
+
+    // --bench-vertex [gridSize] [framesPerVariant]
+    if (argc > 1 && std::strcmp(argv[1], "--bench-vertex") == 0)
+    {
+        VertexBenchmarkSettings settings;
+        if (argc > 2 && argv[2][0] != '-') settings.gridSize = (uint32_t)std::atoi(argv[2]);
+        if (argc > 3 && argv[3][0] != '-') settings.measureFrames = (uint32_t)std::atoi(argv[3]);
+        app.EnableVertexBenchmark(settings);
+    }
+
+    // --object-lights, --depth-prepass (any position)
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--object-lights") == 0)
+            app.SetObjectLightLists(true);
+        else if (std::strcmp(argv[i], "--depth-prepass") == 0)
+            app.SetDepthPrepass(true);
+    }
+
+    // --scene model, --record-path out.txt, --profile trace.json,
+    // --frame-stats out.csv, --pipeline-cache file|none, --lights N (any position)
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--scene") == 0)
+            app.SetScenePath(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--record-path") == 0)
+            app.RecordCameraPath(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--profile") == 0)
+            app.EnableProfiler(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--frame-stats") == 0)
+            app.EnableFrameStats(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--pipeline-cache") == 0)
+            app.SetPipelineCachePath(std::strcmp(argv[i + 1], "none") == 0 ? "" : argv[i + 1]);
+        else if (std::strcmp(argv[i], "--lights") == 0)
+            app.SetExtraPointLights((uint32_t)std::atoi(argv[i + 1]));
+    }
+
+    // --bench-scene [frames] [out.json] [--camera-path file] [--warmup N] [--timestep seconds]
+    if (argc > 1 && std::strcmp(argv[1], "--bench-scene") == 0)
+    {
+        SceneBenchmarkSettings settings;
+        if (argc > 2 && argv[2][0] != '-') settings.measureFrames = (uint32_t)std::atoi(argv[2]);
+        if (argc > 3 && argv[3][0] != '-') settings.outputPath = argv[3];
+
+        for (int i = 2; i + 1 < argc; i++)
+        {
+            if (std::strcmp(argv[i], "--camera-path") == 0)
+                settings.cameraPath = argv[i + 1];
+            else if (std::strcmp(argv[i], "--warmup") == 0)
+                settings.warmupFrames = (uint32_t)std::atoi(argv[i + 1]);
+            else if (std::strcmp(argv[i], "--timestep") == 0)
+                settings.timestep = (float)std::atof(argv[i + 1]);
+        }
+
+        app.EnableSceneBenchmark(settings);
+    }
+
     app.Run();
     return 0;
 }
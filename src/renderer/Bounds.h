@@ -0,0 +1,67 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cfloat>
+
+// Axis-aligned box in whatever space the owner uses (mesh-local or world).
+struct AABB
+{
+    glm::vec3 min{ FLT_MAX };
+    glm::vec3 max{ -FLT_MAX };
+
+    bool IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+    void Expand(const glm::vec3& p)
+    {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+
+    glm::vec3 Center() const { return (min + max) * 0.5f; }
+    glm::vec3 Extents() const { return (max - min) * 0.5f; }
+
+    // Conservative world-space box of this box transformed by m
+    AABB Transformed(const glm::mat4& m) const
+    {
+        glm::vec3 c = glm::vec3(m * glm::vec4(Center(), 1.0f));
+        glm::vec3 e = Extents();
+
+        glm::vec3 worldExt(
+            glm::abs(m[0][0]) * e.x + glm::abs(m[1][0]) * e.y + glm::abs(m[2][0]) * e.z,
+            glm::abs(m[0][1]) * e.x + glm::abs(m[1][1]) * e.y + glm::abs(m[2][1]) * e.z,
+            glm::abs(m[0][2]) * e.x + glm::abs(m[1][2]) * e.y + glm::abs(m[2][2]) * e.z
+        );
+
+        AABB out;
+        out.min = c - worldExt;
+        out.max = c + worldExt;
+        return out;
+    }
+};
+
+// xyz = center, w = radius
+struct BoundingSphere
+{
+    glm::vec3 center{ 0.0f };
+    float radius = 0.0f;
+
+    static BoundingSphere FromAABB(const AABB& box)
+    {
+        BoundingSphere s;
+        s.center = box.Center();
+        s.radius = glm::length(box.Extents());
+        return s;
+    }
+
+    // Conservative under non-uniform scale: radius uses the largest axis scale
+    BoundingSphere Transformed(const glm::mat4& m) const
+    {
+        float sx = glm::dot(glm::vec3(m[0]), glm::vec3(m[0]));
+        float sy = glm::dot(glm::vec3(m[1]), glm::vec3(m[1]));
+        float sz = glm::dot(glm::vec3(m[2]), glm::vec3(m[2]));
+
+        BoundingSphere s;
+        s.center = glm::vec3(m * glm::vec4(center, 1.0f));
+        s.radius = radius * glm::sqrt(glm::max(sx, glm::max(sy, sz)));
+        return s;
+    }
+};
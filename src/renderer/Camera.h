@@ -16,6 +16,9 @@ public:
         ClampPitch();
     }
 
+    float GetYaw() const { return m_Yaw; }
+    float GetPitch() const { return m_Pitch; }
+
     void AddYawPitch(float yawDelta, float pitchDelta)
     {
         m_Yaw += yawDelta;
@@ -30,6 +33,9 @@ public:
         m_Far = farZ;
     }
 
+    float GetNear() const { return m_Near; }
+    float GetFar() const { return m_Far; }
+
     // Matrices
     glm::mat4 GetView() const;
     glm::mat4 GetProjection(float aspect) const;
@@ -1,11 +1,8 @@
 #pragma once
 #include <glm/glm.hpp>
-#include "../lighting/SceneLighting.h"
 
 struct CameraUBO
 {
     glm::mat4 view;
     glm::mat4 proj;
-
-    SceneLighting lighting;
 };
@@ -0,0 +1,70 @@
+#include "EntityStore.h"
+
+#include <stdexcept>
+
+Entity EntityStore::Create()
+{
+    uint32_t slot;
+    if (m_FreeSlots.size() > MIN_FREE_SLOTS)
+    {
+        slot = m_FreeSlots.front();
+        m_FreeSlots.pop_front();
+    }
+    else
+    {
+        slot = static_cast<uint32_t>(m_Sparse.size());
+        if (slot >= MAX_ENTITIES)
+            throw std::runtime_error("EntityStore: out of entity slots");
+
+        m_Sparse.push_back(UINT32_MAX);
+        m_Generations.push_back(0);
+    }
+
+    Entity entity;
+    entity.handle = (static_cast<uint32_t>(m_Generations[slot]) << Entity::INDEX_BITS) | slot;
+
+    m_Sparse[slot] = static_cast<uint32_t>(m_Dense.size());
+    m_Dense.push_back(entity);
+
+    return entity;
+}
+
+uint32_t EntityStore::Destroy(Entity entity)
+{
+    const uint32_t slot = entity.GetSlot();
+    const uint32_t index = m_Sparse[slot];
+
+    // Swap-and-pop
+    const Entity last = m_Dense.back();
+    m_Dense[index] = last;
+    m_Sparse[last.GetSlot()] = index;
+    m_Dense.pop_back();
+
+    m_Sparse[slot] = UINT32_MAX;
+    m_Generations[slot] = static_cast<uint16_t>((m_Generations[slot] + 1) & Entity::GENERATION_MASK);
+    m_FreeSlots.push_back(slot);
+
+    return index;
+}
+
+bool EntityStore::IsAlive(Entity entity) const
+{
+    const uint32_t slot = entity.GetSlot();
+    return slot < m_Sparse.size()
+        && m_Sparse[slot] != UINT32_MAX
+        && m_Generations[slot] == entity.GetGeneration();
+}
+
+void EntityStore::Clear()
+{
+    // Generations survive, so handles from before the clear stay dead
+    for (const Entity& entity : m_Dense)
+    {
+        const uint32_t slot = entity.GetSlot();
+        m_Sparse[slot] = UINT32_MAX;
+        m_Generations[slot] = static_cast<uint16_t>((m_Generations[slot] + 1) & Entity::GENERATION_MASK);
+        m_FreeSlots.push_back(slot);
+    }
+
+    m_Dense.clear();
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <cstdint>
+
+// 32-bit generational handle: low bits index a slot, high bits count how many
+// times that slot has been reused, so a handle to a destroyed entity never
+// resolves to whatever took its place.
+struct Entity
+{
+    static constexpr uint32_t INDEX_BITS = 22;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+    uint32_t handle = UINT32_MAX;
+
+    uint32_t GetSlot() const { return handle & INDEX_MASK; }
+    uint32_t GetGeneration() const { return handle >> INDEX_BITS; }
+    bool IsNull() const { return handle == UINT32_MAX; }
+
+    bool operator==(const Entity& other) const { return handle == other.handle; }
+    bool operator!=(const Entity& other) const { return handle != other.handle; }
+};
+
+// Maps entity handles to a dense [0, count) index range.
+//  - the owner keeps its components in parallel arrays by dense index, so
+//    iteration is linear with no holes
+//  - Destroy() is swap-and-pop: the last entity moves into the freed dense
+//    index and the owner moves its components the same way
+//  - freed slots are reused FIFO and only once MIN_FREE_SLOTS are queued,
+//    which keeps the 10-bit generations from wrapping quickly
+class EntityStore
+{
+public:
+    static constexpr uint32_t MAX_ENTITIES = Entity::INDEX_MASK; // INDEX_MASK itself is reserved for null
+    static constexpr uint32_t MIN_FREE_SLOTS = 1024;
+
+    // The new entity's dense index is GetCount() - 1
+    Entity Create();
+
+    // Returns the dense index the entity occupied. Unless it was the last one,
+    // the entity that was at GetCount() (before the call) now lives there.
+    uint32_t Destroy(Entity entity);
+
+    bool IsAlive(Entity entity) const;
+
+    // Entity must be alive
+    uint32_t GetIndex(Entity entity) const { return m_Sparse[entity.GetSlot()]; }
+    Entity   GetEntity(uint32_t index) const { return m_Dense[index]; }
+
+    uint32_t GetCount() const { return static_cast<uint32_t>(m_Dense.size()); }
+    const std::vector<Entity>& GetEntities() const { return m_Dense; }
+
+    void Clear();
+
+private:
+    std::vector<Entity>   m_Dense;       // dense index -> handle
+    std::vector<uint32_t> m_Sparse;      // slot -> dense index, UINT32_MAX when free
+    std::vector<uint16_t> m_Generations; // slot -> current generation
+    std::deque<uint32_t>  m_FreeSlots;
+};
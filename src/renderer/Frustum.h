@@ -0,0 +1,58 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "Bounds.h"
+
+// Six world-space planes (xyz = normal pointing inside, w = distance).
+// Extracted for Vulkan clip space (depth 0..1).
+struct Frustum
+{
+    enum Plane { Left = 0, Right, Bottom, Top, Near, Far, Count };
+
+    glm::vec4 planes[Count];
+
+    static Frustum FromViewProjection(const glm::mat4& viewProj)
+    {
+        // Rows of the matrix (glm is column-major)
+        glm::vec4 r0(viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]);
+        glm::vec4 r1(viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]);
+        glm::vec4 r2(viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]);
+        glm::vec4 r3(viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]);
+
+        Frustum f;
+        f.planes[Left] = r3 + r0;
+        f.planes[Right] = r3 - r0;
+        f.planes[Bottom] = r3 + r1;
+        f.planes[Top] = r3 - r1;
+        f.planes[Near] = r2;
+        f.planes[Far] = r3 - r2;
+
+        for (glm::vec4& p : f.planes)
+            p /= glm::length(glm::vec3(p));
+
+        return f;
+    }
+
+    bool IntersectsSphere(const BoundingSphere& s) const
+    {
+        for (const glm::vec4& p : planes)
+        {
+            if (glm::dot(glm::vec3(p), s.center) + p.w < -s.radius)
+                return false;
+        }
+        return true;
+    }
+
+    bool IntersectsAABB(const AABB& box) const
+    {
+        const glm::vec3 c = box.Center();
+        const glm::vec3 e = box.Extents();
+
+        for (const glm::vec4& p : planes)
+        {
+            const float r = e.x * glm::abs(p.x) + e.y * glm::abs(p.y) + e.z * glm::abs(p.z);
+            if (glm::dot(glm::vec3(p), c) + p.w < -r)
+                return false;
+        }
+        return true;
+    }
+};
@@ -1,6 +1,8 @@
 #pragma once
 #include <vulkan/vulkan.h>
 
+#include "ShaderFeatures.h"
+
 class VulkanDevice;
 class VulkanMaterialDescriptors;
 class MaterialTemplate;
@@ -8,22 +10,38 @@ class MaterialTemplate;
 class MaterialInstance
 {
 public:
-    // You pass VkImageView + VkSampler for albedo and normal
+    // You pass VkImageView + VkSampler for albedo and normal; they join the
+    // pool's texture array and the material gets an entry in its table.
+    // features: the shading toggles it needs (normal map, alpha test)
     MaterialInstance(
         VulkanDevice* device,
         VulkanMaterialDescriptors* materialPool,
         MaterialTemplate* templ,
         VkImageView albedoView, VkSampler albedoSampler,
-        VkImageView normalView, VkSampler normalSampler);
+        VkImageView normalView, VkSampler normalSampler,
+        const ShaderFeatures& features = ShaderFeatures());
 
     ~MaterialInstance() = default;
 
-    VkDescriptorSet GetDescriptorSet() const { return m_Set1; }
+    // Entry in the material table (set 1, binding 1)
+    uint32_t GetIndex() const { return m_Index; }
     // convenience: RenderQueue wants pipeline
     class VulkanPipeline* GetPipeline() const;
 
+    const ShaderFeatures& GetFeatures() const { return m_Features; }
+
+    // base specialized for this material under the scene's light limits.
+    // Remembers the last answer: objects sharing a material hit it.
+    class VulkanPipeline* GetPermutation(class VulkanPipeline* base, const ShaderFeatures& sceneFeatures);
+
 private:
     VulkanDevice* m_Device = nullptr;
     MaterialTemplate* m_Template = nullptr;
-    VkDescriptorSet m_Set1 = VK_NULL_HANDLE;
+    uint32_t m_Index = 0;
+    ShaderFeatures m_Features;
+
+    // Last GetPermutation()
+    class VulkanPipeline* m_LastBase = nullptr;
+    ShaderFeatures m_LastScene;
+    class VulkanPipeline* m_LastPermutation = nullptr;
 };
@@ -1,54 +1,44 @@
 #include "MaterialTemplate.h"
 #include "renderer/VulkanDevice.h"
-#include "renderer/VulkanSwapchain.h"
-#include "renderer/VulkanRenderPass.h"
-#include "renderer/pipeline/VulkanPipeline.h"
+#include "renderer/pipeline/VulkanStateCache.h"
+#include "core/Logger.h"
 
 MaterialTemplate::MaterialTemplate(
     VulkanDevice* device,
-    VulkanSwapchain* swapchain,
-    VulkanRenderPass* renderPass,
-    //VkDescriptorSetLayout globalSetLayout,
-    std::vector<VkDescriptorSetLayout> layouts,
-    const std::string& vertSpv,
-    const std::string& fragSpv)
-    : m_Device(device)
+    VulkanPipeline* pipeline)
+    : m_Device(device), m_Pipeline(pipeline)
 {
-    // --- Set 1 layout: albedo + normal ---
-    VkDescriptorSetLayoutBinding albedo{};
-    albedo.binding = 0;
-    albedo.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    albedo.descriptorCount = 1;
-    albedo.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-    VkDescriptorSetLayoutBinding normal{};
-    normal.binding = 1;
-    normal.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    normal.descriptorCount = 1;
-    normal.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-    VkDescriptorSetLayoutBinding bindings[] = { albedo, normal };
-
-    VkDescriptorSetLayoutCreateInfo info{};
-    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    info.bindingCount = 2;
-    info.pBindings = bindings;
-
-    vkCreateDescriptorSetLayout(m_Device->GetHandle(), &info, nullptr, &m_MaterialSetLayout);
-
-    // Pipeline uses set0 + set1
-    //std::vector<VkDescriptorSetLayout> setLayouts = { globalSetLayout, m_MaterialSetLayout };
-
-    m_Pipeline = new VulkanPipeline(device, swapchain, renderPass, layouts/*globalSetLayout*/, vertSpv, fragSpv);
+    // Set 1 is the shared material table (VulkanMaterialDescriptors)
 }
 
 MaterialTemplate::~MaterialTemplate()
 {
-    if (m_Pipeline) { delete m_Pipeline; m_Pipeline = nullptr; }
+}
 
-    if (m_MaterialSetLayout != VK_NULL_HANDLE)
-    {
-        vkDestroyDescriptorSetLayout(m_Device->GetHandle(), m_MaterialSetLayout, nullptr);
-        m_MaterialSetLayout = VK_NULL_HANDLE;
-    }
+VulkanPipeline* MaterialTemplate::GetPermutation(VulkanPipeline* base, const ShaderFeatures& features)
+{
+    // Unspecialized: the base pipeline already is this permutation
+    if (!base || features == ShaderFeatures())
+        return base;
+
+    const auto key = std::make_pair(base, features.Pack());
+    auto it = m_Permutations.find(key);
+    if (it != m_Permutations.end())
+        return it->second;
+
+    // Same layout + render pass as base, so base is a valid fallback.
+    // Keyed by the whole description: the state cache (and the pipeline
+    // cache on disk) shares it with every other request of this permutation.
+    GraphicsPipelineDesc desc = base->GetDesc();
+    desc.fragConstants = features.ToConstants();
+
+    VulkanPipeline* permutation = m_Device->GetStateCache()->RequestGraphicsPipeline(desc, base);
+    m_Permutations.emplace(key, permutation);
+
+    LOG_INFO("MaterialTemplate: permutation " + std::to_string(m_Permutations.size()) +
+        " (point " + std::to_string(features.pointLightLimit) +
+        ", spot " + std::to_string(features.spotLightLimit) +
+        ", normal map " + std::to_string(features.normalMapping) +
+        ", alpha test " + std::to_string(features.alphaTest) + ")");
+    return permutation;
 }
@@ -1,33 +1,40 @@
 #pragma once
 #include <vulkan/vulkan.h>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "ShaderFeatures.h"
+
 class VulkanDevice;
-class VulkanSwapchain;
-class VulkanRenderPass;
 class VulkanPipeline;
 
 class MaterialTemplate
 {
 public:
+    // pipeline: the shared pipeline its materials are drawn with (not owned,
+    // built once by Application)
     MaterialTemplate(
         VulkanDevice* device,
-        VulkanSwapchain* swapchain,
-        VulkanRenderPass* renderPass,
-        //VkDescriptorSetLayout globalSetLayout, // set 0
-        std::vector<VkDescriptorSetLayout> layouts, 
-        const std::string& vertSpv,
-        const std::string& fragSpv);
+        VulkanPipeline* pipeline);
 
     ~MaterialTemplate();
 
     VulkanPipeline* GetPipeline() const { return m_Pipeline; }
-    VkDescriptorSetLayout GetMaterialSetLayout() const { return m_MaterialSetLayout; }
+
+    // base specialized with features. The first request of a permutation
+    // queues it on the state cache's compile threads and base draws until it
+    // is ready; later requests are a map lookup. base itself for the
+    // defaults. Main thread.
+    VulkanPipeline* GetPermutation(VulkanPipeline* base, const ShaderFeatures& features);
+
+    uint32_t GetPermutationCount() const { return static_cast<uint32_t>(m_Permutations.size()); }
 
 private:
     VulkanDevice* m_Device = nullptr;
     VulkanPipeline* m_Pipeline = nullptr;
 
-    VkDescriptorSetLayout m_MaterialSetLayout = VK_NULL_HANDLE; // set 1
+    // (base pipeline, ShaderFeatures::Pack()) -> permutation (state cache owned)
+    std::map<std::pair<VulkanPipeline*, uint32_t>, VulkanPipeline*> m_Permutations;
 };
@@ -17,8 +17,16 @@ Mesh::~Mesh()
 {
     delete m_IB;
     delete m_VB;
+    delete m_PositionVB;
     m_IB = nullptr;
     m_VB = nullptr;
+    m_PositionVB = nullptr;
+}
+
+void Mesh::SetPositionStream(const glm::vec3* positions, uint32_t vertexCount)
+{
+    delete m_PositionVB;
+    m_PositionVB = new VulkanVertexBuffer(m_Device, positions, VkDeviceSize(vertexCount) * sizeof(glm::vec3));
 }
 
 void Mesh::Bind(VkCommandBuffer cmd) const
@@ -30,8 +38,29 @@ void Mesh::Bind(VkCommandBuffer cmd) const
     vkCmdBindIndexBuffer(cmd, m_IB->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
 }
 
-void Mesh::Draw(VkCommandBuffer cmd) const
+void Mesh::Draw(VkCommandBuffer cmd, uint32_t firstInstance) const
 {
     Bind(cmd);
+    vkCmdDrawIndexed(cmd, m_IndexCount, 1, 0, 0, firstInstance);
+}
+
+void Mesh::BindPositions(VkCommandBuffer cmd) const
+{
+    if (!m_PositionVB)
+    {
+        Bind(cmd);
+        return;
+    }
+
+    VkBuffer vb = m_PositionVB->GetBuffer();
+    VkDeviceSize offsets[] = { 0 };
+    vkCmdBindVertexBuffers(cmd, 0, 1, &vb, offsets);
+
+    vkCmdBindIndexBuffer(cmd, m_IB->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+}
+
+void Mesh::DrawPositions(VkCommandBuffer cmd) const
+{
+    BindPositions(cmd);
     vkCmdDrawIndexed(cmd, m_IndexCount, 1, 0, 0, 0);
 }
@@ -2,6 +2,7 @@
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
 #include <cstdint>
+#include "Bounds.h"
 
 class VulkanDevice;
 class VulkanVertexBuffer;
@@ -19,10 +20,25 @@ public:
 
     // records commands only (no submit/present)
     void Bind(VkCommandBuffer cmd) const;
-    void Draw(VkCommandBuffer cmd) const;
+    // firstInstance: seen by the shaders as gl_InstanceIndex (lit pipelines:
+    // the material index)
+    void Draw(VkCommandBuffer cmd, uint32_t firstInstance = 0) const;
+
+    // Position-only copy of the vertex stream, split out at import, for
+    // depth-only passes (VertexInput::PositionOnly pipelines). Without one,
+    // Bind/DrawPositions() bind the full stream (Vertex3D pipelines only).
+    void SetPositionStream(const glm::vec3* positions, uint32_t vertexCount);
+    bool HasPositionStream() const { return m_PositionVB != nullptr; }
+
+    void BindPositions(VkCommandBuffer cmd) const;
+    void DrawPositions(VkCommandBuffer cmd) const;
 
     uint32_t GetIndexCount() const { return m_IndexCount; }
 
+    // Mesh-local bounds, filled by the loader (used by culling)
+    void SetLocalBounds(const AABB& bounds) { m_LocalBounds = bounds; }
+    const AABB& GetLocalBounds() const { return m_LocalBounds; }
+
 public:
     glm::mat4 Model = glm::mat4(1.0f);
     MaterialInstance* Material = nullptr;
@@ -31,7 +47,10 @@ private:
     VulkanDevice* m_Device = nullptr;
 
     VulkanVertexBuffer* m_VB = nullptr;
+    VulkanVertexBuffer* m_PositionVB = nullptr; // optional
     VulkanIndexBuffer* m_IB = nullptr;
 
     uint32_t m_IndexCount = 0;
+
+    AABB m_LocalBounds;
 };
@@ -3,7 +3,14 @@
 
 struct PushConstants
 {
-    glm::mat4 model;   // 64 bytes
-    //glm::vec4 tint;   // 16 bytes
-    // total = 80 bytes (safe)
+    glm::mat4 model;           // 64 bytes
+    glm::vec4 normalMatrix[3]; // 48 bytes, mat3 columns padded like GLSL (w unused)
+    glm::uvec4 lights;         // 16 bytes, LightCuller entries (OBJECT_LIGHT_LISTS only)
+    // total = 128 bytes (limit guaranteed by the spec: 128)
 };
+
+inline void SetNormalMatrix(PushConstants& pc, const glm::mat3& normal)
+{
+    for (int c = 0; c < 3; c++)
+        pc.normalMatrix[c] = glm::vec4(normal[c], 0.0f);
+}
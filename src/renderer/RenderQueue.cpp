@@ -1,27 +1,62 @@
 #include "RenderQueue.h"
-#include "RenderObject.h"
+#include "Scene.h"
 #include "MaterialInstance.h"   // REQUIRED
 #include "Mesh.h"               // REQUIRED
+#include "pipeline/VulkanPipeline.h"
+#include "culling/LightCuller.h"
+
+#include <algorithm>
 
 void RenderQueue::Clear()
 {
     m_Commands.clear();
+    m_FallbackCount = 0;
 }
 
-void RenderQueue::Submit(const RenderObject& obj)
+void RenderQueue::Submit(
+    const Scene& scene,
+    uint32_t index,
+    const ShaderFeatures& sceneFeatures,
+    const LightCuller* lightCuller)
 {
-    if (!obj.mesh || !obj.material)
+    Mesh* mesh = scene.GetMeshes()[index];
+    MaterialInstance* material = scene.GetMaterials()[index];
+    if (!mesh || !material)
         return;
 
+    VulkanPipeline* requested = material->GetPermutation(scene.GetPipelines()[index], sceneFeatures);
+    VulkanPipeline* pipeline = requested->GetDrawable();
+
+    if (pipeline != requested)
+    {
+        m_FallbackCount++;
+        if (!pipeline)
+            return;
+    }
+
     RenderCommand cmd{};
-    cmd.mesh = obj.mesh;
-    cmd.pipeline = obj.pipeline;
-    cmd.materialSet = obj.material->GetDescriptorSet();
-    cmd.model = obj.transform.ToMatrix();
+    cmd.mesh = mesh;
+    cmd.pipeline = pipeline;
+    cmd.material = material;
+    cmd.materialIndex = material->GetIndex();
+    cmd.model = scene.GetWorldMatrices()[index];
+    cmd.normal = scene.GetNormalMatrices()[index];
+    if (lightCuller)
+        cmd.lights = lightCuller->Select(scene.GetWorldBounds()[index]);
 
     m_Commands.push_back(cmd);
 }
 
+void RenderQueue::Sort()
+{
+    std::sort(m_Commands.begin(), m_Commands.end(),
+        [](const RenderCommand& a, const RenderCommand& b)
+        {
+            if (a.pipeline != b.pipeline)
+                return a.pipeline < b.pipeline;
+            return a.mesh < b.mesh;
+        });
+}
 
 const std::vector<RenderCommand>& RenderQueue::GetCommands() const
 {
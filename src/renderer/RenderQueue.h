@@ -3,27 +3,51 @@
 #include <glm/glm.hpp>
 #include <vulkan/vulkan.h>
 
+#include "ShaderFeatures.h"
+
 class Mesh;
 class VulkanPipeline;
 class MaterialInstance;
-struct RenderObject;
+class Scene;
+class LightCuller;
 
 struct RenderCommand
 {
     Mesh* mesh = nullptr;
     VulkanPipeline* pipeline = nullptr;
     glm::mat4 model;
+    glm::mat3 normal;
+    glm::uvec4 lights{ 0xFFFFFFFFu }; // LightCuller entries, none by default
 	MaterialInstance* material = nullptr;
-    VkDescriptorSet materialSet = VK_NULL_HANDLE;
+    uint32_t materialIndex = 0; // material table entry, drawn as firstInstance
 };
 
 class RenderQueue
 {
 public:
     void Clear();
-    void Submit(const RenderObject& obj);
+    // Object at a dense scene index; skipped without mesh or material.
+    // Its pipeline is the material's permutation of the scene pipeline under
+    // sceneFeatures. A pipeline still compiling is replaced by its fallback,
+    // or the object is skipped when there is none.
+    // lightCuller (optional, after its Cull()): picks the object's light list.
+    void Submit(
+        const Scene& scene,
+        uint32_t index,
+        const ShaderFeatures& sceneFeatures,
+        const LightCuller* lightCuller = nullptr);
+
+    // Groups commands by pipeline, then mesh, so consecutive draws (and each
+    // recording chunk) can skip redundant binds. Materials need no grouping:
+    // they all share set 1.
+    void Sort();
+
     const std::vector<RenderCommand>& GetCommands() const;
 
+    // Objects since Clear() whose pipeline was not ready (fallback or skipped)
+    uint32_t GetFallbackCount() const { return m_FallbackCount; }
+
 private:
     std::vector<RenderCommand> m_Commands;
+    uint32_t m_FallbackCount = 0;
 };
@@ -1,17 +1,300 @@
 #include "Scene.h"
+#include "Mesh.h"
 
-RenderObject& Scene::CreateObject()
+#include <algorithm>
+
+// --- Objects ---
+
+Entity Scene::CreateObject(uint32_t parentTransform)
 {
-    m_Objects.emplace_back();
-    return m_Objects.back();
+    const Entity entity = m_Entities.Create();
+    const uint32_t index = m_Entities.GetIndex(entity);
+    const uint32_t transformId = CreateNode(parentTransform);
+
+    m_TransformIds.push_back(transformId);
+    m_World.emplace_back(1.0f);
+    m_Normal.emplace_back(1.0f);
+    m_Meshes.push_back(nullptr);
+    m_Materials.push_back(nullptr);
+    m_Pipelines.push_back(nullptr);
+    m_Occluders.push_back(nullptr);
+    m_Bounds.emplace_back();
+
+    m_Proxies.push_back(SceneBVH::INVALID_PROXY);
+    m_Dirty.push_back(0);
+    m_InUnbounded.push_back(0);
+    m_RenderQueued.push_back(0);
+
+    m_ObjectOfTransform[transformId] = index;
+
+    // Mesh is usually assigned after creation: picked up by the next update
+    MarkMoved(index);
+    MarkRenderChanged(index);
+    return entity;
 }
 
-const std::vector<RenderObject>& Scene::GetObjects() const
+void Scene::DestroyObject(Entity entity)
 {
-    return m_Objects;
+    if (!m_Entities.IsAlive(entity))
+        return;
+
+    const uint32_t index = m_Entities.GetIndex(entity);
+
+    if (m_Proxies[index] != SceneBVH::INVALID_PROXY)
+        m_BVH.Remove(m_Proxies[index]);
+    if (m_InUnbounded[index])
+        m_UnboundedChanged = true;
+
+    m_ObjectOfTransform[m_TransformIds[index]] = UINT32_MAX;
+    m_Transforms.Destroy(m_TransformIds[index]);
+
+    // Already listed: the consumer finds the handle dead either way
+    if (!m_RenderQueued[index])
+        PushRenderChange(entity);
+
+    m_Entities.Destroy(entity);
+
+    // Swap-and-pop every component the same way the entity store did
+    const uint32_t last = static_cast<uint32_t>(m_TransformIds.size()) - 1;
+    if (index != last)
+    {
+        m_TransformIds[index] = m_TransformIds[last];
+        m_World[index] = m_World[last];
+        m_Normal[index] = m_Normal[last];
+        m_Meshes[index] = m_Meshes[last];
+        m_Materials[index] = m_Materials[last];
+        m_Pipelines[index] = m_Pipelines[last];
+        m_Occluders[index] = m_Occluders[last];
+        m_Bounds[index] = m_Bounds[last];
+        m_Proxies[index] = m_Proxies[last];
+        m_Dirty[index] = m_Dirty[last];
+        m_InUnbounded[index] = m_InUnbounded[last];
+        m_RenderQueued[index] = m_RenderQueued[last];
+
+        // Back-references to the moved object
+        m_ObjectOfTransform[m_TransformIds[index]] = index;
+
+        if (m_Proxies[index] != SceneBVH::INVALID_PROXY)
+            m_BVH.SetUserData(m_Proxies[index], index);
+        if (m_InUnbounded[index])
+            m_UnboundedChanged = true;
+    }
+
+    m_TransformIds.pop_back();
+    m_World.pop_back();
+    m_Normal.pop_back();
+    m_Meshes.pop_back();
+    m_Materials.pop_back();
+    m_Pipelines.pop_back();
+    m_Occluders.pop_back();
+    m_Bounds.pop_back();
+    m_Proxies.pop_back();
+    m_Dirty.pop_back();
+    m_InUnbounded.pop_back();
+    m_RenderQueued.pop_back();
+}
+
+void Scene::SetMesh(Entity entity, Mesh* mesh)
+{
+    const uint32_t index = m_Entities.GetIndex(entity);
+    m_Meshes[index] = mesh;
+    MarkMoved(index); // bounds change with the mesh
+    MarkRenderChanged(index);
+}
+
+void Scene::SetMaterial(Entity entity, MaterialInstance* material, VulkanPipeline* pipeline)
+{
+    const uint32_t index = m_Entities.GetIndex(entity);
+    m_Materials[index] = material;
+    m_Pipelines[index] = pipeline;
+    MarkRenderChanged(index);
+}
+
+void Scene::SetPipeline(Entity entity, VulkanPipeline* pipeline)
+{
+    m_Pipelines[m_Entities.GetIndex(entity)] = pipeline;
+}
+
+void Scene::SetOccluder(Entity entity, const OccluderMesh* occluder)
+{
+    m_Occluders[m_Entities.GetIndex(entity)] = occluder;
+}
+
+void Scene::SetTransform(Entity entity, const Transform& transform)
+{
+    m_Transforms.SetLocal(
+        m_TransformIds[m_Entities.GetIndex(entity)],
+        transform.position,
+        transform.GetRotation(),
+        transform.scale);
+}
+
+uint32_t Scene::CreateNode(uint32_t parentTransform)
+{
+    uint32_t id = m_Transforms.Create(parentTransform);
+
+    if (id >= m_ObjectOfTransform.size())
+        m_ObjectOfTransform.resize(id + 1, UINT32_MAX);
+    m_ObjectOfTransform[id] = UINT32_MAX;
+
+    return id;
+}
+
+void Scene::MarkMoved(uint32_t index)
+{
+    if (m_Dirty[index])
+        return;
+
+    m_Dirty[index] = 1;
+    m_DirtyList.push_back(m_Entities.GetEntity(index));
+}
+
+void Scene::MarkRenderChanged(uint32_t index)
+{
+    if (m_RenderQueued[index])
+        return;
+
+    m_RenderQueued[index] = 1;
+    PushRenderChange(m_Entities.GetEntity(index));
+}
+
+void Scene::PushRenderChange(Entity entity)
+{
+    m_RenderChanges.push_back(entity);
+
+    // Nobody consuming (GPU culling off): dead handles would pile up with
+    // create / destroy churn. Drop the list, the consumer rebuilds instead.
+    if (m_RenderChanges.size() > 2 * size_t(m_Entities.GetCount()) + 4096)
+    {
+        m_RenderChanges.clear();
+        std::fill(m_RenderQueued.begin(), m_RenderQueued.end(), uint8_t(0));
+        m_RenderEpoch++;
+    }
+}
+
+void Scene::ClearRenderChanges()
+{
+    for (Entity entity : m_RenderChanges)
+    {
+        if (m_Entities.IsAlive(entity))
+            m_RenderQueued[m_Entities.GetIndex(entity)] = 0;
+    }
+    m_RenderChanges.clear();
+}
+
+// --- Per-frame update ---
+
+void Scene::Update()
+{
+    // Changed world matrices (dirty nodes and everything below them)
+    for (uint32_t id : m_Transforms.Update())
+    {
+        uint32_t index = m_ObjectOfTransform[id];
+        if (index == UINT32_MAX)
+            continue;
+
+        m_World[index] = m_Transforms.GetWorld(id);
+        m_Normal[index] = m_Transforms.GetNormalMatrix(id);
+        MarkMoved(index);
+        MarkRenderChanged(index);
+    }
+
+    UpdateSpatialIndex();
+}
+
+void Scene::UpdateSpatialIndex()
+{
+    for (Entity entity : m_DirtyList)
+    {
+        if (!m_Entities.IsAlive(entity))
+            continue; // destroyed after it was queued
+
+        const uint32_t index = m_Entities.GetIndex(entity);
+        m_Dirty[index] = 0;
+
+        const Mesh* mesh = m_Meshes[index];
+        uint32_t& proxy = m_Proxies[index];
+
+        if (!mesh || !mesh->GetLocalBounds().IsValid())
+        {
+            m_Bounds[index] = AABB();
+
+            if (proxy != SceneBVH::INVALID_PROXY)
+            {
+                m_BVH.Remove(proxy);
+                proxy = SceneBVH::INVALID_PROXY;
+            }
+            if (!m_InUnbounded[index])
+            {
+                m_InUnbounded[index] = 1;
+                m_UnboundedChanged = true;
+            }
+            continue;
+        }
+
+        m_Bounds[index] = mesh->GetLocalBounds().Transformed(m_World[index]);
+
+        if (m_InUnbounded[index])
+        {
+            m_InUnbounded[index] = 0;
+            m_UnboundedChanged = true;
+        }
+
+        if (proxy == SceneBVH::INVALID_PROXY)
+        {
+            proxy = m_BVH.Insert(m_Bounds[index], index);
+        }
+        else
+        {
+            m_BVH.Move(proxy, m_Bounds[index]);
+        }
+    }
+
+    m_DirtyList.clear();
+
+    // Rare (objects gaining or losing bounds, unbounded objects destroyed or
+    // relocated), so a full rescan is fine
+    if (m_UnboundedChanged)
+    {
+        m_Unbounded.clear();
+        for (uint32_t i = 0; i < (uint32_t)m_InUnbounded.size(); i++)
+        {
+            if (m_InUnbounded[i])
+                m_Unbounded.push_back(i);
+        }
+        m_UnboundedChanged = false;
+    }
+}
+
+void Scene::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& out) const
+{
+    out.insert(out.end(), m_Unbounded.begin(), m_Unbounded.end());
+    m_BVH.QueryFrustum(frustum, out);
 }
 
 void Scene::Clear()
 {
-    m_Objects.clear();   // or whatever container you store objects in
+    m_Entities.Clear();
+
+    m_TransformIds.clear();
+    m_World.clear();
+    m_Normal.clear();
+    m_Meshes.clear();
+    m_Materials.clear();
+    m_Pipelines.clear();
+    m_Occluders.clear();
+    m_Bounds.clear();
+
+    m_Transforms.Clear();
+    m_ObjectOfTransform.clear();
+    m_Proxies.clear();
+    m_Dirty.clear();
+    m_InUnbounded.clear();
+    m_DirtyList.clear();
+    m_Unbounded.clear();
+    m_UnboundedChanged = false;
+    m_RenderQueued.clear();
+    m_RenderChanges.clear();
+    m_RenderEpoch++;
+    m_BVH.Clear();
 }
@@ -1,15 +1,124 @@
 #pragma once
+#include <glm/glm.hpp>
 #include <vector>
-#include "RenderObject.h"
+#include <cstdint>
+#include "Bounds.h"
+#include "EntityStore.h"
+#include "SceneBVH.h"
+#include "Transform.h"
+#include "TransformStore.h"
 
+class Mesh;
+class MaterialInstance;
+class VulkanPipeline;
+struct OccluderMesh;
+
+// Renderable objects as entities with one dense array per component.
+// Component arrays are parallel and indexed by the dense object index,
+// which changes when another object is destroyed; hold on to the Entity.
 class Scene
 {
 public:
-    RenderObject& CreateObject();
-    const std::vector<RenderObject>& GetObjects() const;
+    // Each object gets its own transform node, optionally under a parent node
+    Entity CreateObject(uint32_t parentTransform = TransformStore::INVALID_ID);
+
+    // O(1): the last object is moved into the freed index (swap-and-pop).
+    // The object's transform node is destroyed with it; stale handles are ignored.
+    void DestroyObject(Entity entity);
+
+    bool IsAlive(Entity entity) const { return m_Entities.IsAlive(entity); }
+
+    uint32_t GetObjectCount() const { return m_Entities.GetCount(); }
+    uint32_t GetIndex(Entity entity) const { return m_Entities.GetIndex(entity); }
+    Entity   GetEntity(uint32_t index) const { return m_Entities.GetEntity(index); }
+    const std::vector<Entity>& GetEntities() const { return m_Entities.GetEntities(); }
+
+    // --- Component edits (entity must be alive) ---
+    void SetMesh(Entity entity, Mesh* mesh);
+    void SetMaterial(Entity entity, MaterialInstance* material, VulkanPipeline* pipeline);
+    void SetPipeline(Entity entity, VulkanPipeline* pipeline);
+
+    // Optional low-LOD proxy drawn into the software occlusion buffer
+    void SetOccluder(Entity entity, const OccluderMesh* occluder);
+
+    // Sets an object's local transform from its Euler form
+    void SetTransform(Entity entity, const Transform& transform);
+
+    // --- Component arrays, by dense index ---
+    const std::vector<uint32_t>&          GetTransformIds() const { return m_TransformIds; }
+    const std::vector<glm::mat4>&         GetWorldMatrices() const { return m_World; }   // after Update()
+    const std::vector<glm::mat3>&         GetNormalMatrices() const { return m_Normal; } // after Update()
+    const std::vector<Mesh*>&             GetMeshes() const { return m_Meshes; }
+    const std::vector<MaterialInstance*>& GetMaterials() const { return m_Materials; }
+    const std::vector<VulkanPipeline*>&   GetPipelines() const { return m_Pipelines; }
+    const std::vector<const OccluderMesh*>& GetOccluders() const { return m_Occluders; }
+
+    // World boxes, invalid for objects without mesh bounds. After Update().
+    const std::vector<AABB>& GetWorldBounds() const { return m_Bounds; }
+
+    // Transform node without an object (e.g. imported hierarchy groups)
+    uint32_t CreateNode(uint32_t parentTransform = TransformStore::INVALID_ID);
+
+    // Local transform edits go through the store; Update() picks them up
+    TransformStore& GetTransforms() { return m_Transforms; }
+
+    // Recomputes dirty world matrices, then applies queued inserts / moves to
+    // the BVH. Cost is proportional to what changed since the last call.
+    void Update();
+
+    // Dense object indices that may intersect the frustum. Objects without
+    // bounds are always returned. Requires Update().
+    void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& out) const;
+
+    // BVH userData is the dense object index
+    const SceneBVH& GetBVH() const { return m_BVH; }
+
+    // --- Render change tracking (one consumer: VulkanGpuCulling) ---
+    // Objects created, destroyed, moved (after Update()) or given another mesh
+    // or material since the last ClearRenderChanges(), once each. Destroyed
+    // objects stay listed by their dead handle. When GetRenderEpoch() changes
+    // the list was dropped (Clear(), or too many changes unconsumed): the
+    // consumer must rebuild from the component arrays.
+    const std::vector<Entity>& GetRenderChanges() const { return m_RenderChanges; }
+    uint32_t GetRenderEpoch() const { return m_RenderEpoch; }
+    void ClearRenderChanges();
 
     void Clear();
 
 private:
-    std::vector<RenderObject> m_Objects;
+    void MarkMoved(uint32_t index);
+    void MarkRenderChanged(uint32_t index);
+    void PushRenderChange(Entity entity);
+    void UpdateSpatialIndex();
+
+private:
+    EntityStore m_Entities;
+
+    // Components, by dense index
+    std::vector<uint32_t>          m_TransformIds;
+    std::vector<glm::mat4>         m_World;
+    std::vector<glm::mat3>         m_Normal;
+    std::vector<Mesh*>             m_Meshes;
+    std::vector<MaterialInstance*> m_Materials;
+    std::vector<VulkanPipeline*>   m_Pipelines;
+    std::vector<const OccluderMesh*> m_Occluders;
+    std::vector<AABB>              m_Bounds;
+
+    TransformStore m_Transforms;
+    std::vector<uint32_t> m_ObjectOfTransform; // by transform id, UINT32_MAX for plain nodes
+
+    // Spatial index bookkeeping, by dense index
+    std::vector<uint32_t> m_Proxies;   // INVALID_PROXY if not in the BVH
+    std::vector<uint8_t>  m_Dirty;     // queued in m_DirtyList
+    std::vector<Entity>   m_DirtyList; // handles: entries of destroyed objects are skipped
+    std::vector<uint8_t>  m_InUnbounded; // listed in m_Unbounded
+    std::vector<uint32_t> m_Unbounded;   // objects without a mesh / valid bounds
+    bool m_UnboundedChanged = false;
+
+    // Render change tracking
+    std::vector<uint8_t> m_RenderQueued;  // by dense index: listed in m_RenderChanges
+    std::vector<Entity>  m_RenderChanges; // dead handles = destroyed objects
+    uint32_t m_RenderEpoch = 0;
+
+    SceneBVH m_BVH;
 };
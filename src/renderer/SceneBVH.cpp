@@ -0,0 +1,771 @@
+#include "SceneBVH.h"
+
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+
+// --- Helpers ---
+
+namespace
+{
+    AABB Union(const AABB& a, const AABB& b)
+    {
+        AABB out;
+        out.min = glm::min(a.min, b.min);
+        out.max = glm::max(a.max, b.max);
+        return out;
+    }
+
+    float SurfaceArea(const AABB& box)
+    {
+        glm::vec3 d = box.max - box.min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    bool Contains(const AABB& outer, const AABB& inner)
+    {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+               inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+    }
+
+    bool Overlaps(const AABB& a, const AABB& b)
+    {
+        return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+               a.min.y <= b.max.y && b.min.y <= a.max.y &&
+               a.min.z <= b.max.z && b.min.z <= a.max.z;
+    }
+
+    float DistanceSq(const AABB& box, const glm::vec3& p)
+    {
+        glm::vec3 d = glm::max(glm::max(box.min - p, p - box.max), glm::vec3(0.0f));
+        return glm::dot(d, d);
+    }
+
+    // Entry distance of the ray into the box, or FLT_MAX on a miss
+    float RayBox(const AABB& box, const glm::vec3& origin, const glm::vec3& invDir, float maxT)
+    {
+        glm::vec3 t0 = (box.min - origin) * invDir;
+        glm::vec3 t1 = (box.max - origin) * invDir;
+        glm::vec3 tNear = glm::min(t0, t1);
+        glm::vec3 tFar = glm::max(t0, t1);
+
+        float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxT));
+
+        return enter <= exit ? enter : FLT_MAX;
+    }
+
+    // Depth-first traversal stack; spills to the heap only for very deep trees
+    class NodeStack
+    {
+    public:
+        void Push(int32_t node)
+        {
+            if (m_Size < INLINE)
+                m_Inline[m_Size] = node;
+            else
+                m_Spill.push_back(node);
+            m_Size++;
+        }
+
+        int32_t Pop()
+        {
+            m_Size--;
+            if (m_Size < INLINE)
+                return m_Inline[m_Size];
+
+            int32_t node = m_Spill.back();
+            m_Spill.pop_back();
+            return node;
+        }
+
+        bool Empty() const { return m_Size == 0; }
+
+    private:
+        static constexpr uint32_t INLINE = 64;
+        int32_t m_Inline[INLINE];
+        std::vector<int32_t> m_Spill;
+        uint32_t m_Size = 0;
+    };
+}
+
+// --- Construction ---
+
+SceneBVH::SceneBVH(float margin)
+    : m_Margin(margin)
+{
+}
+
+void SceneBVH::Clear()
+{
+    m_Nodes.clear();
+    m_Root = NULL_NODE;
+    m_FreeNode = NULL_NODE;
+
+    m_Proxies.clear();
+    m_FreeProxy = NULL_NODE;
+    m_ProxyCount = 0;
+}
+
+void SceneBVH::Build(const std::vector<AABB>& boxes, const std::vector<uint32_t>& userData)
+{
+    if (boxes.size() != userData.size())
+        throw std::runtime_error("SceneBVH: box and user data counts differ");
+
+    Clear();
+
+    const size_t count = boxes.size();
+    if (count == 0)
+        return;
+
+    m_Proxies.resize(count);
+    m_Nodes.reserve(count * 2 - 1);
+
+    std::vector<uint32_t> order(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        m_Proxies[i].box = boxes[i];
+        m_Proxies[i].userData = userData[i];
+        order[i] = (uint32_t)i;
+    }
+
+    m_ProxyCount = (uint32_t)count;
+    m_Root = BuildRange(order, 0, count);
+    m_Nodes[m_Root].parent = NULL_NODE;
+}
+
+// Nodes are allocated in depth-first order so that subtrees are contiguous
+int32_t SceneBVH::BuildRange(std::vector<uint32_t>& proxies, size_t begin, size_t end)
+{
+    int32_t node = AllocateNode();
+
+    if (end - begin == 1)
+    {
+        uint32_t proxy = proxies[begin];
+        m_Nodes[node].box = Fatten(m_Proxies[proxy].box);
+        m_Nodes[node].proxy = proxy;
+        m_Nodes[node].userData = m_Proxies[proxy].userData;
+        m_Proxies[proxy].node = node;
+        return node;
+    }
+
+    // Split at the median centroid along the widest centroid axis
+    AABB centroids;
+    for (size_t i = begin; i < end; i++)
+        centroids.Expand(m_Proxies[proxies[i]].box.Center());
+
+    glm::vec3 size = centroids.max - centroids.min;
+    int axis = 0;
+    if (size.y > size[axis]) axis = 1;
+    if (size.z > size[axis]) axis = 2;
+
+    size_t mid = begin + (end - begin) / 2;
+    std::nth_element(
+        proxies.begin() + begin, proxies.begin() + mid, proxies.begin() + end,
+        [&](uint32_t a, uint32_t b)
+        {
+            return m_Proxies[a].box.min[axis] + m_Proxies[a].box.max[axis] <
+                   m_Proxies[b].box.min[axis] + m_Proxies[b].box.max[axis];
+        });
+
+    int32_t left = BuildRange(proxies, begin, mid);
+    int32_t right = BuildRange(proxies, mid, end);
+
+    Node& n = m_Nodes[node];
+    n.child1 = left;
+    n.child2 = right;
+    n.box = Union(m_Nodes[left].box, m_Nodes[right].box);
+    n.height = 1 + std::max(m_Nodes[left].height, m_Nodes[right].height);
+
+    m_Nodes[left].parent = node;
+    m_Nodes[right].parent = node;
+    return node;
+}
+
+// --- Allocation ---
+
+int32_t SceneBVH::AllocateNode()
+{
+    int32_t node;
+    if (m_FreeNode != NULL_NODE)
+    {
+        node = m_FreeNode;
+        m_FreeNode = m_Nodes[node].parent;
+    }
+    else
+    {
+        node = (int32_t)m_Nodes.size();
+        m_Nodes.emplace_back();
+    }
+
+    m_Nodes[node] = Node{};
+    return node;
+}
+
+void SceneBVH::FreeNode(int32_t node)
+{
+    m_Nodes[node].parent = m_FreeNode;
+    m_Nodes[node].height = -1;
+    m_FreeNode = node;
+}
+
+uint32_t SceneBVH::AllocateProxy()
+{
+    uint32_t proxy;
+    if (m_FreeProxy != NULL_NODE)
+    {
+        proxy = (uint32_t)m_FreeProxy;
+        m_FreeProxy = m_Proxies[proxy].node;
+    }
+    else
+    {
+        proxy = (uint32_t)m_Proxies.size();
+        m_Proxies.emplace_back();
+    }
+
+    m_ProxyCount++;
+    return proxy;
+}
+
+AABB SceneBVH::Fatten(const AABB& box) const
+{
+    AABB fat;
+    fat.min = box.min - glm::vec3(m_Margin);
+    fat.max = box.max + glm::vec3(m_Margin);
+    return fat;
+}
+
+// --- Dynamic updates ---
+
+uint32_t SceneBVH::Insert(const AABB& box, uint32_t userData)
+{
+    uint32_t proxy = AllocateProxy();
+    int32_t leaf = AllocateNode();
+
+    m_Nodes[leaf].box = Fatten(box);
+    m_Nodes[leaf].proxy = proxy;
+    m_Nodes[leaf].userData = userData;
+
+    m_Proxies[proxy].box = box;
+    m_Proxies[proxy].node = leaf;
+    m_Proxies[proxy].userData = userData;
+
+    InsertLeaf(leaf);
+    return proxy;
+}
+
+void SceneBVH::Remove(uint32_t proxy)
+{
+    int32_t leaf = m_Proxies[proxy].node;
+
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+
+    m_Proxies[proxy].node = m_FreeProxy;
+    m_FreeProxy = (int32_t)proxy;
+    m_ProxyCount--;
+}
+
+bool SceneBVH::Move(uint32_t proxy, const AABB& box)
+{
+    Proxy& p = m_Proxies[proxy];
+    p.box = box;
+
+    // Still inside the fat box: the tree stays valid as is
+    if (Contains(m_Nodes[p.node].box, box))
+        return false;
+
+    RemoveLeaf(p.node);
+    m_Nodes[p.node].box = Fatten(box);
+    InsertLeaf(p.node);
+    return true;
+}
+
+void SceneBVH::InsertLeaf(int32_t leaf)
+{
+    if (m_Root == NULL_NODE)
+    {
+        m_Root = leaf;
+        m_Nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // Descend towards the sibling with the lowest surface area cost
+    const AABB leafBox = m_Nodes[leaf].box;
+    int32_t index = m_Root;
+
+    while (!m_Nodes[index].IsLeaf())
+    {
+        const Node& n = m_Nodes[index];
+
+        float area = SurfaceArea(n.box);
+        float combinedArea = SurfaceArea(Union(n.box, leafBox));
+
+        // Cost of a new parent here, and the growth pushed onto the ancestors
+        float cost = 2.0f * combinedArea;
+        float inheritance = 2.0f * (combinedArea - area);
+
+        auto childCost = [&](int32_t child)
+        {
+            const Node& c = m_Nodes[child];
+            float grown = SurfaceArea(Union(c.box, leafBox));
+            return (c.IsLeaf() ? grown : grown - SurfaceArea(c.box)) + inheritance;
+        };
+
+        float cost1 = childCost(n.child1);
+        float cost2 = childCost(n.child2);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? n.child1 : n.child2;
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = m_Nodes[sibling].parent;
+    int32_t newParent = AllocateNode();
+
+    m_Nodes[newParent].parent = oldParent;
+    m_Nodes[newParent].box = Union(leafBox, m_Nodes[sibling].box);
+    m_Nodes[newParent].height = m_Nodes[sibling].height + 1;
+    m_Nodes[newParent].child1 = sibling;
+    m_Nodes[newParent].child2 = leaf;
+
+    if (oldParent != NULL_NODE)
+    {
+        if (m_Nodes[oldParent].child1 == sibling)
+            m_Nodes[oldParent].child1 = newParent;
+        else
+            m_Nodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        m_Root = newParent;
+    }
+
+    m_Nodes[sibling].parent = newParent;
+    m_Nodes[leaf].parent = newParent;
+
+    FixUpwards(m_Nodes[leaf].parent);
+}
+
+void SceneBVH::RemoveLeaf(int32_t leaf)
+{
+    if (leaf == m_Root)
+    {
+        m_Root = NULL_NODE;
+        return;
+    }
+
+    int32_t parent = m_Nodes[leaf].parent;
+    int32_t grandParent = m_Nodes[parent].parent;
+    int32_t sibling = m_Nodes[parent].child1 == leaf ? m_Nodes[parent].child2 : m_Nodes[parent].child1;
+
+    if (grandParent != NULL_NODE)
+    {
+        if (m_Nodes[grandParent].child1 == parent)
+            m_Nodes[grandParent].child1 = sibling;
+        else
+            m_Nodes[grandParent].child2 = sibling;
+
+        m_Nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        FixUpwards(grandParent);
+    }
+    else
+    {
+        m_Root = sibling;
+        m_Nodes[sibling].parent = NULL_NODE;
+        FreeNode(parent);
+    }
+}
+
+void SceneBVH::FixUpwards(int32_t node)
+{
+    while (node != NULL_NODE)
+    {
+        node = Balance(node);
+
+        Node& n = m_Nodes[node];
+        n.height = 1 + std::max(m_Nodes[n.child1].height, m_Nodes[n.child2].height);
+        n.box = Union(m_Nodes[n.child1].box, m_Nodes[n.child2].box);
+
+        node = n.parent;
+    }
+}
+
+// AVL-style rotation: if one child is more than one level taller, its
+// taller grandchild stays and the other one swaps places with A.
+// Returns the node now at A's position.
+int32_t SceneBVH::Balance(int32_t iA)
+{
+    Node& A = m_Nodes[iA];
+    if (A.IsLeaf() || A.height < 2)
+        return iA;
+
+    int32_t iB = A.child1;
+    int32_t iC = A.child2;
+    Node& B = m_Nodes[iB];
+    Node& C = m_Nodes[iC];
+
+    int32_t balance = C.height - B.height;
+
+    // Rotate C up
+    if (balance > 1)
+    {
+        int32_t iF = C.child1;
+        int32_t iG = C.child2;
+        Node& F = m_Nodes[iF];
+        Node& G = m_Nodes[iG];
+
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        if (C.parent != NULL_NODE)
+        {
+            if (m_Nodes[C.parent].child1 == iA)
+                m_Nodes[C.parent].child1 = iC;
+            else
+                m_Nodes[C.parent].child2 = iC;
+        }
+        else
+        {
+            m_Root = iC;
+        }
+
+        if (F.height > G.height)
+        {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.box = Union(B.box, G.box);
+            C.box = Union(A.box, F.box);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        }
+        else
+        {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.box = Union(B.box, F.box);
+            C.box = Union(A.box, G.box);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+
+        return iC;
+    }
+
+    // Rotate B up
+    if (balance < -1)
+    {
+        int32_t iD = B.child1;
+        int32_t iE = B.child2;
+        Node& D = m_Nodes[iD];
+        Node& E = m_Nodes[iE];
+
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        if (B.parent != NULL_NODE)
+        {
+            if (m_Nodes[B.parent].child1 == iA)
+                m_Nodes[B.parent].child1 = iB;
+            else
+                m_Nodes[B.parent].child2 = iB;
+        }
+        else
+        {
+            m_Root = iB;
+        }
+
+        if (D.height > E.height)
+        {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.box = Union(C.box, E.box);
+            B.box = Union(A.box, D.box);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        }
+        else
+        {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.box = Union(C.box, D.box);
+            B.box = Union(A.box, E.box);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+uint32_t SceneBVH::GetHeight() const
+{
+    return m_Root == NULL_NODE ? 0 : (uint32_t)m_Nodes[m_Root].height;
+}
+
+// --- Queries ---
+
+void SceneBVH::CollectLeaves(int32_t node, std::vector<uint32_t>& out) const
+{
+    NodeStack stack;
+    stack.Push(node);
+
+    while (!stack.Empty())
+    {
+        const Node& n = m_Nodes[stack.Pop()];
+        if (n.IsLeaf())
+        {
+            out.push_back(n.userData);
+            continue;
+        }
+
+        stack.Push(n.child2);
+        stack.Push(n.child1);
+    }
+}
+
+void SceneBVH::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& out) const
+{
+    if (m_Root == NULL_NODE)
+        return;
+
+    constexpr uint32_t ALL_PLANES = (1u << Frustum::Count) - 1;
+
+    // Each entry carries the planes its ancestors did not fully pass
+    struct Entry { int32_t node; uint32_t planeMask; };
+    std::vector<Entry> stack;
+    stack.reserve(64);
+    stack.push_back({ m_Root, ALL_PLANES });
+
+    while (!stack.empty())
+    {
+        Entry e = stack.back();
+        stack.pop_back();
+
+        const Node& n = m_Nodes[e.node];
+        const AABB& box = n.IsLeaf() ? m_Proxies[n.proxy].box : n.box;
+
+        const glm::vec3 c = box.Center();
+        const glm::vec3 ext = box.Extents();
+
+        uint32_t mask = e.planeMask;
+        bool outside = false;
+
+        for (uint32_t i = 0; i < Frustum::Count; i++)
+        {
+            if (!(mask & (1u << i)))
+                continue;
+
+            const glm::vec4& p = frustum.planes[i];
+            const float r = ext.x * glm::abs(p.x) + ext.y * glm::abs(p.y) + ext.z * glm::abs(p.z);
+            const float d = glm::dot(glm::vec3(p), c) + p.w;
+
+            if (d < -r)
+            {
+                outside = true;
+                break;
+            }
+
+            if (d >= r)
+                mask &= ~(1u << i);
+        }
+
+        if (outside)
+            continue;
+
+        // Fully inside: take the whole subtree without further tests
+        if (mask == 0 || n.IsLeaf())
+        {
+            if (n.IsLeaf())
+                out.push_back(n.userData);
+            else
+                CollectLeaves(e.node, out);
+            continue;
+        }
+
+        stack.push_back({ n.child2, mask });
+        stack.push_back({ n.child1, mask });
+    }
+}
+
+void SceneBVH::QueryAABB(const AABB& box, std::vector<uint32_t>& out) const
+{
+    if (m_Root == NULL_NODE)
+        return;
+
+    NodeStack stack;
+    stack.Push(m_Root);
+
+    while (!stack.Empty())
+    {
+        const Node& n = m_Nodes[stack.Pop()];
+        if (!Overlaps(n.box, box))
+            continue;
+
+        if (n.IsLeaf())
+        {
+            const Proxy& p = m_Proxies[n.proxy];
+            if (Overlaps(p.box, box))
+                out.push_back(p.userData);
+            continue;
+        }
+
+        stack.Push(n.child2);
+        stack.Push(n.child1);
+    }
+}
+
+void SceneBVH::QuerySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const
+{
+    if (m_Root == NULL_NODE)
+        return;
+
+    const float radiusSq = radius * radius;
+
+    NodeStack stack;
+    stack.Push(m_Root);
+
+    while (!stack.Empty())
+    {
+        const Node& n = m_Nodes[stack.Pop()];
+        if (DistanceSq(n.box, center) > radiusSq)
+            continue;
+
+        if (n.IsLeaf())
+        {
+            const Proxy& p = m_Proxies[n.proxy];
+            if (DistanceSq(p.box, center) <= radiusSq)
+                out.push_back(p.userData);
+            continue;
+        }
+
+        stack.Push(n.child2);
+        stack.Push(n.child1);
+    }
+}
+
+bool SceneBVH::RayCast(
+    const Ray& ray,
+    float maxT,
+    RayHit& hit,
+    const std::function<float(uint32_t, float)>& refine) const
+{
+    hit = RayHit{};
+    if (m_Root == NULL_NODE)
+        return false;
+
+    // Division by zero gives +-inf, which the slab test handles
+    const glm::vec3 invDir = 1.0f / ray.direction;
+    float best = maxT;
+
+    NodeStack stack;
+    stack.Push(m_Root);
+
+    while (!stack.Empty())
+    {
+        const Node& n = m_Nodes[stack.Pop()];
+
+        if (n.IsLeaf())
+        {
+            const Proxy& p = m_Proxies[n.proxy];
+
+            float t = RayBox(p.box, ray.origin, invDir, best);
+            if (t == FLT_MAX)
+                continue;
+
+            if (refine)
+            {
+                t = refine(p.userData, t);
+                if (t < 0.0f || t > best)
+                    continue;
+            }
+
+            best = t;
+            hit.userData = p.userData;
+            hit.t = t;
+            continue;
+        }
+
+        // Visit the nearer child first so the far one is usually pruned
+        float t1 = RayBox(m_Nodes[n.child1].box, ray.origin, invDir, best);
+        float t2 = RayBox(m_Nodes[n.child2].box, ray.origin, invDir, best);
+
+        if (t1 <= t2)
+        {
+            if (t2 != FLT_MAX) stack.Push(n.child2);
+            if (t1 != FLT_MAX) stack.Push(n.child1);
+        }
+        else
+        {
+            if (t1 != FLT_MAX) stack.Push(n.child1);
+            if (t2 != FLT_MAX) stack.Push(n.child2);
+        }
+    }
+
+    return hit.userData != UINT32_MAX;
+}
+
+void SceneBVH::QueryNearest(const glm::vec3& p, uint32_t k, std::vector<NearestHit>& out) const
+{
+    if (m_Root == NULL_NODE || k == 0)
+        return;
+
+    // Best-first over node boxes; results kept in a max-heap of size k
+    using Candidate = std::pair<float, int32_t>;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> open;
+
+    auto farther = [](const NearestHit& a, const NearestHit& b) { return a.distanceSq < b.distanceSq; };
+    std::vector<NearestHit> best;
+    best.reserve(k + 1);
+
+    open.push({ DistanceSq(m_Nodes[m_Root].box, p), m_Root });
+
+    while (!open.empty())
+    {
+        auto [dist, node] = open.top();
+        open.pop();
+
+        if (best.size() == k && dist > best.front().distanceSq)
+            break;
+
+        const Node& n = m_Nodes[node];
+
+        if (n.IsLeaf())
+        {
+            const Proxy& proxy = m_Proxies[n.proxy];
+            float d = DistanceSq(proxy.box, p);
+
+            if (best.size() < k)
+            {
+                best.push_back({ proxy.userData, d });
+                std::push_heap(best.begin(), best.end(), farther);
+            }
+            else if (d < best.front().distanceSq)
+            {
+                std::pop_heap(best.begin(), best.end(), farther);
+                best.back() = { proxy.userData, d };
+                std::push_heap(best.begin(), best.end(), farther);
+            }
+            continue;
+        }
+
+        open.push({ DistanceSq(m_Nodes[n.child1].box, p), n.child1 });
+        open.push({ DistanceSq(m_Nodes[n.child2].box, p), n.child2 });
+    }
+
+    std::sort_heap(best.begin(), best.end(), farther);
+    out.insert(out.end(), best.begin(), best.end());
+}
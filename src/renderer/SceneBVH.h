@@ -0,0 +1,133 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cfloat>
+
+#include "Bounds.h"
+#include "Frustum.h"
+
+// t is measured in units of direction (it does not need to be normalized)
+struct Ray
+{
+    glm::vec3 origin{ 0.0f };
+    glm::vec3 direction{ 0.0f, 0.0f, -1.0f };
+};
+
+struct RayHit
+{
+    uint32_t userData = UINT32_MAX;
+    float t = FLT_MAX;
+};
+
+struct NearestHit
+{
+    uint32_t userData = UINT32_MAX;
+    float distanceSq = FLT_MAX; // point to box, 0 if inside
+};
+
+// Dynamic AABB tree over world bounds.
+//  - leaves hold a "fat" box (tight box + margin); a Move() that stays inside
+//    it is O(1), otherwise the leaf is removed and reinserted (O(log n)),
+//    so per-frame cost scales with the number of moved objects
+//  - insertion picks the sibling by surface-area cost, AVL rotations keep
+//    the tree balanced
+//  - Build() makes a top-down median-split tree for bulk loads
+// Queries test the tight box at the leaves, so results are exact for boxes.
+class SceneBVH
+{
+public:
+    static constexpr uint32_t INVALID_PROXY = UINT32_MAX;
+
+    explicit SceneBVH(float margin = 0.1f);
+
+    // Replaces the tree. Proxy i is created for boxes[i] / userData[i].
+    void Build(const std::vector<AABB>& boxes, const std::vector<uint32_t>& userData);
+
+    uint32_t Insert(const AABB& box, uint32_t userData);
+    void     Remove(uint32_t proxy);
+
+    // Returns true if the leaf had to be reinserted
+    bool Move(uint32_t proxy, const AABB& box);
+
+    void Clear();
+
+    // All queries append the userData of matching proxies
+    void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& out) const;
+    void QueryAABB(const AABB& box, std::vector<uint32_t>& out) const;
+    void QuerySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const;
+
+    // Closest box hit in [0, maxT]. refine(userData, boxT) can replace the box
+    // hit with an exact one (e.g. mesh triangles); return < 0 for a miss.
+    bool RayCast(
+        const Ray& ray,
+        float maxT,
+        RayHit& hit,
+        const std::function<float(uint32_t, float)>& refine = {}) const;
+
+    // k closest boxes to p, sorted by distance
+    void QueryNearest(const glm::vec3& p, uint32_t k, std::vector<NearestHit>& out) const;
+
+    const AABB& GetBounds(uint32_t proxy) const { return m_Proxies[proxy].box; }
+    uint32_t    GetUserData(uint32_t proxy) const { return m_Proxies[proxy].userData; }
+
+    // Re-targets a proxy without touching the tree (e.g. the owner was relocated)
+    void SetUserData(uint32_t proxy, uint32_t userData)
+    {
+        m_Proxies[proxy].userData = userData;
+        m_Nodes[m_Proxies[proxy].node].userData = userData;
+    }
+
+    uint32_t GetProxyCount() const { return m_ProxyCount; }
+    uint32_t GetHeight() const;
+
+private:
+    static constexpr int32_t NULL_NODE = -1;
+
+    struct Node
+    {
+        AABB box;                  // fat for leaves
+        int32_t parent = NULL_NODE; // next free node when unused
+        int32_t child1 = NULL_NODE;
+        int32_t child2 = NULL_NODE;
+        int32_t height = 0;        // leaf = 0, free = -1
+        uint32_t proxy = INVALID_PROXY;
+        uint32_t userData = 0;     // copy of the proxy's, saves a lookup in queries
+
+        bool IsLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    struct Proxy
+    {
+        AABB box;                  // tight
+        int32_t node = NULL_NODE;  // next free proxy when unused
+        uint32_t userData = 0;
+    };
+
+    int32_t AllocateNode();
+    void    FreeNode(int32_t node);
+    uint32_t AllocateProxy();
+
+    AABB Fatten(const AABB& box) const;
+
+    void    InsertLeaf(int32_t leaf);
+    void    RemoveLeaf(int32_t leaf);
+    int32_t Balance(int32_t node);
+    void    FixUpwards(int32_t node);
+
+    int32_t BuildRange(std::vector<uint32_t>& proxies, size_t begin, size_t end);
+
+    void CollectLeaves(int32_t node, std::vector<uint32_t>& out) const;
+
+private:
+    float m_Margin = 0.1f;
+
+    std::vector<Node> m_Nodes;
+    int32_t m_Root = NULL_NODE;
+    int32_t m_FreeNode = NULL_NODE;
+
+    std::vector<Proxy> m_Proxies;
+    int32_t m_FreeProxy = NULL_NODE;
+    uint32_t m_ProxyCount = 0;
+};
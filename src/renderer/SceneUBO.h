@@ -1,11 +1,10 @@
 #pragma once
 #include <glm/glm.hpp>
-#include "../lighting/SceneLighting.h"
 
+// Per-frame camera block (set 0, binding 0). Lights live in
+// VulkanLightStorage and are only uploaded when they change.
 struct SceneUBO
 {
     glm::mat4 view;
     glm::mat4 projection;
-
-    SceneLighting lighting;
 };
@@ -0,0 +1,57 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <cstdint>
+
+#include "../lighting/LightingLimits.h"
+
+// lighting.frag feature toggles. Each field is one specialization constant
+// (constant_id = field order), so a permutation only pays for the shading it
+// uses: light loops get a compile-time bound and disabled features are dead
+// code the driver removes. The defaults are the shader's own defaults, i.e.
+// the unspecialized pipeline.
+// Light limits and the light source come from the scene, the other toggles
+// from the material.
+struct ShaderFeatures
+{
+    uint32_t pointLightLimit = MAX_LIGHTS_PER_CLUSTER; // per cluster, 0: no point light loop
+    uint32_t spotLightLimit = MAX_SPOT_LIGHTS;          // 0: no spot light loop
+    VkBool32 normalMapping = VK_FALSE;                  // samples the material's normal texture
+    VkBool32 alphaTest = VK_FALSE;                      // discard where albedo alpha < 0.5
+    VkBool32 objectLightLists = VK_FALSE;               // the draw's LightCuller list instead of clusters
+
+    bool operator==(const ShaderFeatures& other) const = default;
+
+    // Constant values in constant_id order
+    std::vector<uint32_t> ToConstants() const
+    {
+        return { pointLightLimit, spotLightLimit, normalMapping, alphaTest, objectLightLists };
+    }
+
+    // Unique per permutation (limits fit in 8 bits)
+    uint32_t Pack() const
+    {
+        return pointLightLimit | (spotLightLimit << 8) | (normalMapping << 16) | (alphaTest << 17) |
+            (objectLightLists << 18);
+    }
+
+    // Material toggles with the scene's light limits
+    static ShaderFeatures Combine(const ShaderFeatures& material, const ShaderFeatures& scene)
+    {
+        ShaderFeatures features = material;
+        features.pointLightLimit = scene.pointLightLimit;
+        features.spotLightLimit = scene.spotLightLimit;
+        features.objectLightLists = scene.objectLightLists;
+        return features;
+    }
+
+    // Smallest power of two >= count (capped), so lights coming and going
+    // only switch between a handful of permutations
+    static uint32_t LightLimit(uint32_t count, uint32_t max)
+    {
+        uint32_t limit = count > 0 ? 1u : 0u;
+        while (limit < count && limit < max)
+            limit <<= 1;
+        return limit < max ? limit : max;
+    }
+};
@@ -1,7 +1,9 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 
+// Euler authoring form. Per-frame world matrices live in TransformStore.
 struct Transform
 {
     glm::vec3 position{ 0.0f };
@@ -18,4 +20,12 @@ struct Transform
         m = glm::scale(m, scale);
         return m;
     }
+
+    // Same rotation order as ToMatrix (X, then Y, then Z, applied right to left)
+    glm::quat GetRotation() const
+    {
+        return glm::angleAxis(rotation.x, glm::vec3(1, 0, 0)) *
+               glm::angleAxis(rotation.y, glm::vec3(0, 1, 0)) *
+               glm::angleAxis(rotation.z, glm::vec3(0, 0, 1));
+    }
 };
@@ -0,0 +1,431 @@
+#include "TransformStore.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TS_USE_SSE 1
+#endif
+
+// --- Matrix helpers ---
+
+// T * R * S, rotation from a unit quaternion (same layout as glm::mat3_cast)
+static glm::mat4 ComposeLocal(const glm::vec3& p, const glm::quat& q, const glm::vec3& s)
+{
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    glm::mat4 m(1.0f);
+    m[0] = glm::vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f) * s.x;
+    m[1] = glm::vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f) * s.y;
+    m[2] = glm::vec4(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f) * s.z;
+    m[3] = glm::vec4(p, 1.0f);
+    return m;
+}
+
+static inline void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
+{
+#ifdef TS_USE_SSE
+    const __m128 a0 = _mm_loadu_ps(&a[0][0]);
+    const __m128 a1 = _mm_loadu_ps(&a[1][0]);
+    const __m128 a2 = _mm_loadu_ps(&a[2][0]);
+    const __m128 a3 = _mm_loadu_ps(&a[3][0]);
+
+    for (int c = 0; c < 4; c++)
+    {
+        const float* col = &b[c][0];
+        __m128 r = _mm_mul_ps(a0, _mm_set1_ps(col[0]));
+        r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(col[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(col[2])));
+        r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(col[3])));
+        _mm_storeu_ps(&out[c][0], r);
+    }
+#else
+    out = a * b;
+#endif
+}
+
+glm::mat3 TransformStore::ComputeNormalMatrix(const glm::mat4& m)
+{
+    const glm::vec3 a(m[0]);
+    const glm::vec3 b(m[1]);
+    const glm::vec3 c(m[2]);
+
+    // inverse(M)^T = [b x c, c x a, a x b] / det(M); keep det's sign so
+    // mirrored transforms still get outward normals
+    const glm::vec3 bc = glm::cross(b, c);
+    const float sign = glm::dot(a, bc) < 0.0f ? -1.0f : 1.0f;
+
+    return glm::mat3(bc * sign, glm::cross(c, a) * sign, glm::cross(a, b) * sign);
+}
+
+// --- Hierarchy ---
+
+uint32_t TransformStore::Create(uint32_t parent)
+{
+    uint32_t id;
+    if (m_FreeId != INVALID_ID)
+    {
+        id = m_FreeId;
+        m_FreeId = m_Nodes[id].parent;
+    }
+    else
+    {
+        id = static_cast<uint32_t>(m_Nodes.size());
+        m_Nodes.emplace_back();
+    }
+
+    // Appending keeps parents ahead of children without a re-sort
+    const uint32_t slot = static_cast<uint32_t>(m_SlotIds.size());
+    m_Nodes[id].slot = slot;
+    m_Nodes[id].parent = parent;
+    m_Nodes[id].childCount = 0;
+
+    if (parent != INVALID_ID)
+        m_Nodes[parent].childCount++;
+
+    const float identity[LANE_COUNT] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+    for (int lane = 0; lane < LANE_COUNT; lane++)
+        m_Lanes[lane].push_back(identity[lane]);
+
+    m_ParentSlots.push_back(parent == INVALID_ID ? INVALID_ID : m_Nodes[parent].slot);
+    m_SlotIds.push_back(id);
+    m_Dirty.push_back(1);
+    m_World.emplace_back(1.0f);
+    m_Normal.emplace_back(1.0f);
+
+    return id;
+}
+
+void TransformStore::Destroy(uint32_t id)
+{
+    Node& node = m_Nodes[id];
+
+    // Promoting children to roots keeps parents-first order, no re-sort needed
+    if (node.childCount > 0)
+    {
+        for (uint32_t slot = 0; slot < m_SlotIds.size(); slot++)
+        {
+            uint32_t child = m_SlotIds[slot];
+            if (child != INVALID_ID && m_Nodes[child].parent == id)
+            {
+                m_Nodes[child].parent = INVALID_ID;
+                m_ParentSlots[slot] = INVALID_ID;
+                m_Dirty[slot] = 1;
+            }
+        }
+    }
+
+    if (node.parent != INVALID_ID)
+        m_Nodes[node.parent].childCount--;
+
+    // Leave a hole; Update() skips it until the next compaction
+    m_SlotIds[node.slot] = INVALID_ID;
+    m_Dirty[node.slot] = 0;
+    m_HoleCount++;
+
+    node.slot = INVALID_ID;
+    node.parent = m_FreeId;
+    node.childCount = 0;
+    m_FreeId = id;
+
+    if (m_HoleCount >= 64 && m_HoleCount * 4 >= m_SlotIds.size())
+        m_OrderDirty = true;
+}
+
+void TransformStore::SetParent(uint32_t id, uint32_t parent)
+{
+    for (uint32_t p = parent; p != INVALID_ID; p = m_Nodes[p].parent)
+    {
+        if (p == id)
+            throw std::runtime_error("TransformStore: parenting would create a cycle");
+    }
+
+    if (m_Nodes[id].parent != INVALID_ID)
+        m_Nodes[m_Nodes[id].parent].childCount--;
+    if (parent != INVALID_ID)
+        m_Nodes[parent].childCount++;
+
+    m_Nodes[id].parent = parent;
+    m_OrderDirty = true;
+    MarkDirty(id);
+}
+
+void TransformStore::SortByDepth()
+{
+    const uint32_t idCount = static_cast<uint32_t>(m_Nodes.size());
+
+    // Depth per id (parent chains may be out of order after SetParent)
+    std::vector<uint32_t> depth(idCount, INVALID_ID);
+    std::vector<uint32_t> chain;
+    uint32_t maxDepth = 0;
+
+    for (uint32_t id : m_SlotIds)
+    {
+        if (id == INVALID_ID)
+            continue;
+
+        chain.clear();
+        uint32_t n = id;
+        while (n != INVALID_ID && depth[n] == INVALID_ID)
+        {
+            chain.push_back(n);
+            n = m_Nodes[n].parent;
+        }
+
+        uint32_t d = n == INVALID_ID ? 0 : depth[n] + 1;
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+            depth[*it] = d++;
+
+        maxDepth = std::max(maxDepth, d);
+    }
+
+    // Stable counting sort of the live slots by depth
+    std::vector<uint32_t> offsets(maxDepth + 1, 0);
+    for (uint32_t id : m_SlotIds)
+    {
+        if (id != INVALID_ID)
+            offsets[depth[id] + 1]++;
+    }
+    for (uint32_t d = 1; d <= maxDepth; d++)
+        offsets[d] += offsets[d - 1];
+
+    uint32_t liveCount = offsets[maxDepth];
+    std::vector<uint32_t> order(liveCount); // new slot -> old slot
+    for (uint32_t slot = 0; slot < m_SlotIds.size(); slot++)
+    {
+        uint32_t id = m_SlotIds[slot];
+        if (id != INVALID_ID)
+            order[offsets[depth[id]]++] = slot;
+    }
+
+    auto permute = [&](auto& values)
+    {
+        std::remove_reference_t<decltype(values)> sorted(liveCount);
+        for (uint32_t i = 0; i < liveCount; i++)
+            sorted[i] = values[order[i]];
+        values.swap(sorted);
+    };
+
+    for (std::vector<float>& lane : m_Lanes)
+        permute(lane);
+    permute(m_SlotIds);
+    permute(m_Dirty);
+    permute(m_World);
+    permute(m_Normal);
+
+    for (uint32_t slot = 0; slot < liveCount; slot++)
+        m_Nodes[m_SlotIds[slot]].slot = slot;
+
+    m_ParentSlots.resize(liveCount);
+    for (uint32_t slot = 0; slot < liveCount; slot++)
+    {
+        uint32_t parent = m_Nodes[m_SlotIds[slot]].parent;
+        m_ParentSlots[slot] = parent == INVALID_ID ? INVALID_ID : m_Nodes[parent].slot;
+    }
+
+    m_OrderDirty = false;
+    m_HoleCount = 0;
+}
+
+void TransformStore::Clear()
+{
+    m_Nodes.clear();
+    m_FreeId = INVALID_ID;
+
+    for (std::vector<float>& lane : m_Lanes)
+        lane.clear();
+    m_ParentSlots.clear();
+    m_SlotIds.clear();
+    m_Dirty.clear();
+    m_World.clear();
+    m_Normal.clear();
+
+    m_OrderDirty = false;
+    m_HoleCount = 0;
+}
+
+// --- Local components ---
+
+void TransformStore::SetLocal(uint32_t id, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+    SetPosition(id, position);
+    SetRotation(id, rotation);
+    SetScale(id, scale);
+}
+
+void TransformStore::SetPosition(uint32_t id, const glm::vec3& position)
+{
+    const uint32_t slot = m_Nodes[id].slot;
+    m_Lanes[PX][slot] = position.x;
+    m_Lanes[PY][slot] = position.y;
+    m_Lanes[PZ][slot] = position.z;
+    m_Dirty[slot] = 1;
+}
+
+void TransformStore::SetRotation(uint32_t id, const glm::quat& rotation)
+{
+    const glm::quat q = glm::normalize(rotation);
+    const uint32_t slot = m_Nodes[id].slot;
+    m_Lanes[QX][slot] = q.x;
+    m_Lanes[QY][slot] = q.y;
+    m_Lanes[QZ][slot] = q.z;
+    m_Lanes[QW][slot] = q.w;
+    m_Dirty[slot] = 1;
+}
+
+void TransformStore::SetScale(uint32_t id, const glm::vec3& scale)
+{
+    const uint32_t slot = m_Nodes[id].slot;
+    m_Lanes[SX][slot] = scale.x;
+    m_Lanes[SY][slot] = scale.y;
+    m_Lanes[SZ][slot] = scale.z;
+    m_Dirty[slot] = 1;
+}
+
+glm::vec3 TransformStore::GetPosition(uint32_t id) const
+{
+    const uint32_t slot = m_Nodes[id].slot;
+    return { m_Lanes[PX][slot], m_Lanes[PY][slot], m_Lanes[PZ][slot] };
+}
+
+glm::quat TransformStore::GetRotation(uint32_t id) const
+{
+    const uint32_t slot = m_Nodes[id].slot;
+    return glm::quat(m_Lanes[QW][slot], m_Lanes[QX][slot], m_Lanes[QY][slot], m_Lanes[QZ][slot]);
+}
+
+glm::vec3 TransformStore::GetScale(uint32_t id) const
+{
+    const uint32_t slot = m_Nodes[id].slot;
+    return { m_Lanes[SX][slot], m_Lanes[SY][slot], m_Lanes[SZ][slot] };
+}
+
+// --- Batch update ---
+
+const std::vector<uint32_t>& TransformStore::Update()
+{
+    m_Changed.clear();
+
+    if (m_OrderDirty)
+        SortByDepth();
+
+    // Parents come first, so one forward pass pushes dirty flags down
+    m_DirtySlots.clear();
+    for (uint32_t slot = 0; slot < m_SlotIds.size(); slot++)
+    {
+        if (m_SlotIds[slot] == INVALID_ID)
+            continue; // hole
+
+        const uint32_t parent = m_ParentSlots[slot];
+        if (parent != INVALID_ID && m_Dirty[parent])
+            m_Dirty[slot] = 1;
+
+        if (m_Dirty[slot])
+            m_DirtySlots.push_back(slot);
+    }
+
+    if (m_DirtySlots.empty())
+        return m_Changed;
+
+    BuildLocalMatrices();
+    BuildWorldMatrices();
+
+    for (uint32_t slot : m_DirtySlots)
+    {
+        m_Dirty[slot] = 0;
+        m_Changed.push_back(m_SlotIds[slot]);
+    }
+
+    return m_Changed;
+}
+
+void TransformStore::BuildLocalMatrices()
+{
+    const size_t count = m_DirtySlots.size();
+    m_LocalScratch.resize(count);
+
+    size_t i = 0;
+
+#ifdef TS_USE_SSE
+    // 4 transforms per iteration, one SSE lane each
+    for (; i + 4 <= count; i += 4)
+    {
+        const uint32_t* s = &m_DirtySlots[i];
+
+        __m128 v[LANE_COUNT];
+        for (int lane = 0; lane < LANE_COUNT; lane++)
+        {
+            const float* src = m_Lanes[lane].data();
+            v[lane] = _mm_setr_ps(src[s[0]], src[s[1]], src[s[2]], src[s[3]]);
+        }
+
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+
+        const __m128 x = v[QX], y = v[QY], z = v[QZ], w = v[QW];
+        const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        // Column-major rows: col[c][r] for the 4 transforms
+        __m128 col[4][4];
+        col[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), v[SX]);
+        col[0][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), v[SX]);
+        col[0][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), v[SX]);
+        col[0][3] = _mm_setzero_ps();
+
+        col[1][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), v[SY]);
+        col[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), v[SY]);
+        col[1][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), v[SY]);
+        col[1][3] = _mm_setzero_ps();
+
+        col[2][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), v[SZ]);
+        col[2][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), v[SZ]);
+        col[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), v[SZ]);
+        col[2][3] = _mm_setzero_ps();
+
+        col[3][0] = v[PX];
+        col[3][1] = v[PY];
+        col[3][2] = v[PZ];
+        col[3][3] = one;
+
+        // Transpose each column from "row r of 4 transforms" to "column of transform k"
+        for (int c = 0; c < 4; c++)
+        {
+            _MM_TRANSPOSE4_PS(col[c][0], col[c][1], col[c][2], col[c][3]);
+            for (int k = 0; k < 4; k++)
+                _mm_storeu_ps(&m_LocalScratch[i + k][c][0], col[c][k]);
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        const uint32_t s = m_DirtySlots[i];
+        m_LocalScratch[i] = ComposeLocal(
+            { m_Lanes[PX][s], m_Lanes[PY][s], m_Lanes[PZ][s] },
+            glm::quat(m_Lanes[QW][s], m_Lanes[QX][s], m_Lanes[QY][s], m_Lanes[QZ][s]),
+            { m_Lanes[SX][s], m_Lanes[SY][s], m_Lanes[SZ][s] });
+    }
+}
+
+void TransformStore::BuildWorldMatrices()
+{
+    // Dirty slots are in storage order: a parent's world is final before its children
+    for (size_t i = 0; i < m_DirtySlots.size(); i++)
+    {
+        const uint32_t slot = m_DirtySlots[i];
+        const uint32_t parent = m_ParentSlots[slot];
+
+        if (parent == INVALID_ID)
+            m_World[slot] = m_LocalScratch[i];
+        else
+            Multiply(m_World[parent], m_LocalScratch[i], m_World[slot]);
+
+        m_Normal[slot] = ComputeNormalMatrix(m_World[slot]);
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include <cstdint>
+
+// Hierarchical transforms in structure-of-arrays form.
+//  - ids are stable handles; storage slots are kept sorted by depth so every
+//    parent is stored before its children (re-sorted lazily when the
+//    hierarchy changes)
+//  - destroying a node leaves a hole in its slot, compacted once holes make up
+//    a quarter of the storage, so leaf create/destroy stays O(1) amortized
+//  - local TRS is split into one float array per component, so Update()
+//    builds local matrices 4 at a time with SSE
+//  - setters flag the node dirty; Update() propagates flags down in one
+//    forward pass and recomputes world matrices for dirty subtrees only
+class TransformStore
+{
+public:
+    static constexpr uint32_t INVALID_ID = UINT32_MAX;
+
+    uint32_t Create(uint32_t parent = INVALID_ID);
+
+    // Children become roots (their local transform is kept).
+    // O(1) for leaves, O(n) for nodes with children.
+    void Destroy(uint32_t id);
+
+    // Throws on cycles
+    void     SetParent(uint32_t id, uint32_t parent);
+    uint32_t GetParent(uint32_t id) const { return m_Nodes[id].parent; }
+
+    void SetLocal(uint32_t id, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+    void SetPosition(uint32_t id, const glm::vec3& position);
+    void SetRotation(uint32_t id, const glm::quat& rotation);
+    void SetScale(uint32_t id, const glm::vec3& scale);
+
+    glm::vec3 GetPosition(uint32_t id) const;
+    glm::quat GetRotation(uint32_t id) const;
+    glm::vec3 GetScale(uint32_t id) const;
+
+    // Valid after Update()
+    const glm::mat4& GetWorld(uint32_t id) const { return m_World[m_Nodes[id].slot]; }
+
+    // Inverse-transpose of the world 3x3, up to scale (shaders renormalize)
+    const glm::mat3& GetNormalMatrix(uint32_t id) const { return m_Normal[m_Nodes[id].slot]; }
+
+    // Cofactor form of inverse(transpose(mat3(m))): three cross products, no divide
+    static glm::mat3 ComputeNormalMatrix(const glm::mat4& m);
+
+    // Recomputes dirty subtrees. Returns the ids whose world matrix changed.
+    const std::vector<uint32_t>& Update();
+
+    uint32_t GetCount() const { return static_cast<uint32_t>(m_SlotIds.size()) - m_HoleCount; }
+
+    void Clear();
+
+private:
+    // One float array per local component
+    enum Lane { PX, PY, PZ, QX, QY, QZ, QW, SX, SY, SZ, LANE_COUNT };
+
+    struct Node
+    {
+        uint32_t slot = INVALID_ID;   // INVALID_ID when free
+        uint32_t parent = INVALID_ID; // next free id when free
+        uint32_t childCount = 0;
+    };
+
+    void MarkDirty(uint32_t id) { m_Dirty[m_Nodes[id].slot] = 1; }
+
+    void SortByDepth();
+    void BuildLocalMatrices();
+    void BuildWorldMatrices();
+
+private:
+    std::vector<Node> m_Nodes; // by id
+    uint32_t m_FreeId = INVALID_ID;
+
+    // By slot
+    std::vector<float>     m_Lanes[LANE_COUNT];
+    std::vector<uint32_t>  m_ParentSlots;
+    std::vector<uint32_t>  m_SlotIds;
+    std::vector<uint8_t>   m_Dirty;
+    std::vector<glm::mat4> m_World;
+    std::vector<glm::mat3> m_Normal;
+
+    bool m_OrderDirty = false;
+    uint32_t m_HoleCount = 0; // destroyed slots not yet compacted
+
+    // Update() scratch
+    std::vector<uint32_t>  m_DirtySlots;
+    std::vector<glm::mat4> m_LocalScratch;
+    std::vector<uint32_t>  m_Changed;
+};
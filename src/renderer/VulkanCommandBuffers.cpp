@@ -1,81 +1,60 @@
 #include "VulkanCommandBuffers.h"
 #include "VulkanDevice.h"
-#include "VulkanCommandPool.h"
-#include "VulkanSwapchain.h"
-#include "VulkanRenderPass.h"
-#include "VulkanFramebuffers.h"
 #include "../core/Logger.h"
 
-VulkanCommandBuffers::VulkanCommandBuffers(
-    VulkanDevice* device,
-    VulkanCommandPool* commandPool,
-    VulkanSwapchain* swapchain,
-    VulkanRenderPass* renderPass,
-    VulkanFramebuffers* framebuffers)
+#include <stdexcept>
+#include <string>
+
+VulkanCommandBuffers::VulkanCommandBuffers(VulkanDevice* device, uint32_t framesInFlight)
     : m_Device(device)
 {
-    m_CommandBuffers.resize(swapchain->GetImageViews().size());
-
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.commandPool = commandPool->GetHandle();
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = static_cast<uint32_t>(m_CommandBuffers.size());
+    m_Frames.resize(framesInFlight);
 
-    if (vkAllocateCommandBuffers(
-        m_Device->GetHandle(),
-        &allocInfo,
-        m_CommandBuffers.data()) != VK_SUCCESS)
+    for (FrameCommands& frame : m_Frames)
     {
-        LOG_ERROR("Failed to allocate command buffers!");
-        return;
+        VkCommandPoolCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        info.queueFamilyIndex = m_Device->GetGraphicsQueueFamilyIndex();
+        info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        if (vkCreateCommandPool(m_Device->GetHandle(), &info, nullptr, &frame.pool) != VK_SUCCESS)
+            throw std::runtime_error("VulkanCommandBuffers: failed to create command pool");
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = frame.pool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(m_Device->GetHandle(), &allocInfo, &frame.buffer) != VK_SUCCESS)
+            throw std::runtime_error("VulkanCommandBuffers: failed to allocate command buffer");
     }
 
-    for (uint32_t i = 0; i < m_CommandBuffers.size(); i++)
+    LOG_INFO("Command buffers: " + std::to_string(framesInFlight) + " frame slot(s)");
+}
+
+VulkanCommandBuffers::~VulkanCommandBuffers()
+{
+    // Destroying a pool frees its buffer
+    for (FrameCommands& frame : m_Frames)
     {
-        RecordCommandBuffer(
-            m_CommandBuffers[i],
-            i,
-            swapchain,
-            renderPass,
-            framebuffers
-        );
+        if (frame.pool)
+            vkDestroyCommandPool(m_Device->GetHandle(), frame.pool, nullptr);
     }
-
-    LOG_INFO("Command buffers recorded.");
 }
 
-void VulkanCommandBuffers::RecordCommandBuffer(
-    VkCommandBuffer cmd,
-    uint32_t imageIndex,
-    VulkanSwapchain* swapchain,
-    VulkanRenderPass* renderPass,
-    VulkanFramebuffers* framebuffers)
+VkCommandBuffer VulkanCommandBuffers::Begin(uint32_t frameIndex)
 {
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-
-    vkBeginCommandBuffer(cmd, &beginInfo);
+    FrameCommands& frame = m_Frames[frameIndex];
 
-    VkClearValue clearValues[2];
-    clearValues[0].color = { {0.1f, 0.1f, 0.1f, 1.0f} };
-    clearValues[1].depthStencil = { 1.0f, 0 };
+    vkResetCommandPool(m_Device->GetHandle(), frame.pool, 0);
 
-    VkRenderPassBeginInfo rpBegin{};
-    rpBegin.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    rpBegin.renderPass = renderPass->GetHandle();
-    rpBegin.framebuffer = framebuffers->GetFramebuffers()[imageIndex];
-    rpBegin.renderArea.offset = { 0, 0 };
-    rpBegin.renderArea.extent = swapchain->GetExtent();
-    rpBegin.clearValueCount = 2;
-    rpBegin.pClearValues = clearValues;
-
-    vkCmdBeginRenderPass(cmd, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
-    vkCmdEndRenderPass(cmd);
+    if (vkBeginCommandBuffer(frame.buffer, &beginInfo) != VK_SUCCESS)
+        return VK_NULL_HANDLE;
 
-    if (vkEndCommandBuffer(cmd) != VK_SUCCESS)
-    {
-        LOG_ERROR("Failed to record command buffer!");
-    }
+    return frame.buffer;
 }
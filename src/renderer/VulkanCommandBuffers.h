@@ -1,35 +1,34 @@
 #pragma once
 #include <vulkan/vulkan.h>
 #include <vector>
+#include <cstdint>
 
 class VulkanDevice;
-class VulkanCommandPool;
-class VulkanSwapchain;
-class VulkanRenderPass;
-class VulkanFramebuffers;
 
+// Primary command buffers keyed by frame slot, not by swapchain image.
+// Each frame in flight owns a transient pool with one primary buffer; the
+// whole pool is reset at once when the slot comes around again, instead of
+// resetting individual buffers.
 class VulkanCommandBuffers
 {
 public:
-    VulkanCommandBuffers(
-        VulkanDevice* device,
-        VulkanCommandPool* commandPool,
-        VulkanSwapchain* swapchain,
-        VulkanRenderPass* renderPass,
-        VulkanFramebuffers* framebuffers
-    );
+    VulkanCommandBuffers(VulkanDevice* device, uint32_t framesInFlight);
+    ~VulkanCommandBuffers();
 
-    const std::vector<VkCommandBuffer>& GetBuffers() const { return m_CommandBuffers; }
+    // Resets this slot's pool and begins its buffer (one-time submit).
+    // The slot must have been waited on (VulkanSync::WaitForFrame).
+    VkCommandBuffer Begin(uint32_t frameIndex);
+
+    VkCommandBuffer GetBuffer(uint32_t frameIndex) const { return m_Frames[frameIndex].buffer; }
+    uint32_t GetFramesInFlight() const { return static_cast<uint32_t>(m_Frames.size()); }
 
 private:
-    VulkanDevice* m_Device = nullptr;
-    std::vector<VkCommandBuffer> m_CommandBuffers;
+    struct FrameCommands
+    {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        VkCommandBuffer buffer = VK_NULL_HANDLE;
+    };
 
-    void RecordCommandBuffer(
-        VkCommandBuffer cmd,
-        uint32_t imageIndex,
-        VulkanSwapchain* swapchain,
-        VulkanRenderPass* renderPass,
-        VulkanFramebuffers* framebuffers
-    );
+    VulkanDevice* m_Device = nullptr;
+    std::vector<FrameCommands> m_Frames;
 };
@@ -1,5 +1,6 @@
 #include "VulkanCommandPool.h"
 #include "VulkanDevice.h"
+#include "VulkanTimeline.h"
 #include "../core/Logger.h"
 
 VulkanCommandPool::VulkanCommandPool(VulkanDevice* device, CommandPoolType type)
@@ -23,12 +24,15 @@ VulkanCommandPool::VulkanCommandPool(VulkanDevice* device, CommandPoolType type)
 
 VulkanCommandPool::~VulkanCommandPool()
 {
+    // Destroying the pool frees pending buffers too (device is idle by now)
     if (m_CommandPool)
         vkDestroyCommandPool(m_Device->GetHandle(), m_CommandPool, nullptr);
 }
 
 VkCommandBuffer VulkanCommandPool::BeginSingleTimeCommands()
 {
+    FreeCompleted();
+
     VkCommandBufferAllocateInfo alloc{};
     alloc.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     alloc.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
@@ -47,21 +51,32 @@ VkCommandBuffer VulkanCommandPool::BeginSingleTimeCommands()
 }
 
 void VulkanCommandPool::EndSingleTimeCommands(VkCommandBuffer cmd)
+{
+    m_Device->GetTimeline()->Wait(SubmitSingleTimeCommands(cmd));
+    FreeCompleted();
+}
+
+uint64_t VulkanCommandPool::SubmitSingleTimeCommands(VkCommandBuffer cmd)
 {
     vkEndCommandBuffer(cmd);
 
-    VkSubmitInfo submit{};
-    submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submit.commandBufferCount = 1;
-    submit.pCommandBuffers = &cmd;
+    uint64_t value = m_Device->GetTimeline()->Submit({ cmd });
+    m_Pending.push_back({ value, cmd });
 
-    vkQueueSubmit(m_Device->GetGraphicsQueue(), 1, &submit, VK_NULL_HANDLE);
-    vkQueueWaitIdle(m_Device->GetGraphicsQueue());
+    return value;
+}
 
-    vkFreeCommandBuffers(
-        m_Device->GetHandle(),
-        m_CommandPool,
-        1,
-        &cmd
-    );
-}
\ No newline at end of file
+void VulkanCommandPool::FreeCompleted()
+{
+    VulkanTimeline* timeline = m_Device->GetTimeline();
+
+    size_t kept = 0;
+    for (const PendingCommands& pending : m_Pending)
+    {
+        if (timeline->IsComplete(pending.value))
+            vkFreeCommandBuffers(m_Device->GetHandle(), m_CommandPool, 1, &pending.cmd);
+        else
+            m_Pending[kept++] = pending;
+    }
+    m_Pending.resize(kept);
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include <vulkan/vulkan.h>
+#include <vector>
+#include <cstdint>
 
 class VulkanDevice;
 
@@ -18,10 +20,26 @@ public:
     VkCommandPool GetHandle() const { return m_CommandPool; }
 
     VkCommandBuffer BeginSingleTimeCommands();
+
+    // Submits on the device timeline and waits for this submit only
     void EndSingleTimeCommands(VkCommandBuffer cmd);
 
+    // Submits without waiting. Returns the timeline value to wait on / retire
+    // staging resources against; the buffer is freed once it has completed.
+    uint64_t SubmitSingleTimeCommands(VkCommandBuffer cmd);
+
+private:
+    void FreeCompleted();
+
 private:
     VulkanDevice* m_Device = nullptr;
     VkCommandPool m_CommandPool = VK_NULL_HANDLE;
     CommandPoolType m_Type;
+
+    struct PendingCommands
+    {
+        uint64_t value = 0;
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+    };
+    std::vector<PendingCommands> m_Pending; // submitted, not yet freed
 };
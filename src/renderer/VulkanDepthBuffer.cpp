@@ -8,6 +8,7 @@ VulkanDepthBuffer::VulkanDepthBuffer(VulkanDevice* device, VkExtent2D extent)
     m_Format = m_Device->FindDepthFormat();
 
     VkSampleCountFlagBits samples = m_Device->GetMSAASamples();
+    m_Samples = samples;
 
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -20,7 +21,8 @@ VulkanDepthBuffer::VulkanDepthBuffer(VulkanDevice* device, VkExtent2D extent)
     imageInfo.format = m_Format;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    // SAMPLED: the Hi-Z pyramid is built from this depth
+    imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
     imageInfo.samples = samples;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
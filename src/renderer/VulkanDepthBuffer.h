@@ -11,8 +11,11 @@ public:
     VulkanDepthBuffer(VulkanDevice* device, VkExtent2D extent);
     ~VulkanDepthBuffer();
 
+    VkImage     GetImage()     const { return m_Image; }
     VkImageView GetImageView() const { return m_ImageView; }
     VkFormat    GetFormat()    const { return m_Format; }
+    VkExtent2D  GetExtent()    const { return m_Extent; }
+    VkSampleCountFlagBits GetSamples() const { return m_Samples; }
 
 private:
     VulkanDevice* m_Device = nullptr;
@@ -23,4 +26,5 @@ private:
 
     VkFormat       m_Format = VK_FORMAT_UNDEFINED;
     VkExtent2D     m_Extent{};
+    VkSampleCountFlagBits m_Samples = VK_SAMPLE_COUNT_1_BIT;
 };
@@ -0,0 +1,168 @@
+#include "VulkanDescriptorAllocator.h"
+#include "VulkanDevice.h"
+#include "VulkanTimeline.h"
+#include "../core/Logger.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <stdexcept>
+#include <string>
+
+// Descriptors per set a pool is sized for, by type. A layout needing more
+// just fills its pools sooner.
+static constexpr std::array<std::pair<VkDescriptorType, uint32_t>, 5> POOL_RATIOS = { {
+    { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 },
+    { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 },
+    { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 },
+    { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1 },
+    { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1 },
+} };
+
+// Each new pool of a chain is 1.5x the last, up to MAX_SETS_PER_POOL
+static constexpr uint32_t FIRST_SETS_PER_POOL = 32;
+static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+
+VulkanDescriptorAllocator::VulkanDescriptorAllocator(VulkanDevice* device)
+    : m_Device(device)
+{
+}
+
+VulkanDescriptorAllocator::~VulkanDescriptorAllocator()
+{
+    VkDevice vkDevice = m_Device->GetHandle();
+
+    for (VkDescriptorPool pool : m_Persistent.pools)
+        vkDestroyDescriptorPool(vkDevice, pool, nullptr);
+
+    for (PoolChain& frame : m_Frames)
+    {
+        for (VkDescriptorPool pool : frame.pools)
+            vkDestroyDescriptorPool(vkDevice, pool, nullptr);
+    }
+}
+
+VkDescriptorPool VulkanDescriptorAllocator::CreatePool(uint32_t maxSets) const
+{
+    std::array<VkDescriptorPoolSize, POOL_RATIOS.size()> sizes{};
+    for (size_t i = 0; i < POOL_RATIOS.size(); i++)
+    {
+        sizes[i].type = POOL_RATIOS[i].first;
+        sizes[i].descriptorCount = POOL_RATIOS[i].second * maxSets;
+    }
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(sizes.size());
+    poolInfo.pPoolSizes = sizes.data();
+    poolInfo.maxSets = maxSets;
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    if (vkCreateDescriptorPool(m_Device->GetHandle(), &poolInfo, nullptr, &pool) != VK_SUCCESS)
+        throw std::runtime_error("VulkanDescriptorAllocator: failed to create descriptor pool");
+
+    return pool;
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::AllocateFrom(PoolChain& chain, VkDescriptorSetLayout layout)
+{
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &layout;
+
+    // Current pool first, then the next ones of the chain (transient chains
+    // keep theirs across resets), then a new one. A full pool is not tried
+    // again until its chain is reset.
+    while (true)
+    {
+        bool created = false;
+        if (chain.current == chain.pools.size())
+        {
+            chain.setsPerPool = chain.setsPerPool == 0
+                ? FIRST_SETS_PER_POOL
+                : std::min(chain.setsPerPool + chain.setsPerPool / 2, MAX_SETS_PER_POOL);
+
+            chain.pools.push_back(CreatePool(chain.setsPerPool));
+            created = true;
+        }
+
+        allocInfo.descriptorPool = chain.pools[chain.current];
+
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        VkResult result = vkAllocateDescriptorSets(m_Device->GetHandle(), &allocInfo, &set);
+        if (result == VK_SUCCESS)
+            return set;
+
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+            throw std::runtime_error("VulkanDescriptorAllocator: failed to allocate descriptor set");
+
+        // A fresh pool that cannot hold one set never will
+        if (created)
+            throw std::runtime_error("VulkanDescriptorAllocator: set layout exceeds the pool sizes");
+
+        chain.current++;
+    }
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::Allocate(VkDescriptorSetLayout layout)
+{
+    auto it = m_FreeSets.find(layout);
+    if (it != m_FreeSets.end() && !it->second.empty())
+    {
+        VkDescriptorSet set = it->second.back();
+        it->second.pop_back();
+        return set;
+    }
+
+    const size_t poolCount = m_Persistent.pools.size();
+    VkDescriptorSet set = AllocateFrom(m_Persistent, layout);
+
+    if (m_Persistent.pools.size() != poolCount)
+        LOG_INFO("Descriptor allocator: persistent pool " + std::to_string(m_Persistent.pools.size()) +
+            " (" + std::to_string(m_Persistent.setsPerPool) + " sets)");
+
+    return set;
+}
+
+void VulkanDescriptorAllocator::Free(VkDescriptorSetLayout layout, VkDescriptorSet set)
+{
+    if (set == VK_NULL_HANDLE)
+        return;
+
+    VulkanTimeline* timeline = m_Device->GetTimeline();
+    timeline->Retire(timeline->GetSubmittedValue(), [this, layout, set]()
+        {
+            m_FreeSets[layout].push_back(set);
+        });
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::AllocateTransient(uint32_t frameIndex, VkDescriptorSetLayout layout)
+{
+    if (frameIndex >= m_Frames.size())
+        m_Frames.resize(frameIndex + 1);
+
+    return AllocateFrom(m_Frames[frameIndex], layout);
+}
+
+void VulkanDescriptorAllocator::ResetFrame(uint32_t frameIndex)
+{
+    if (frameIndex >= m_Frames.size())
+        return;
+
+    PoolChain& frame = m_Frames[frameIndex];
+    const uint32_t used = std::min(frame.current + 1, static_cast<uint32_t>(frame.pools.size()));
+
+    for (uint32_t i = 0; i < used; i++)
+        vkResetDescriptorPool(m_Device->GetHandle(), frame.pools[i], 0);
+
+    frame.current = 0;
+}
+
+uint32_t VulkanDescriptorAllocator::GetPoolCount() const
+{
+    size_t count = m_Persistent.pools.size();
+    for (const PoolChain& frame : m_Frames)
+        count += frame.pools.size();
+    return static_cast<uint32_t>(count);
+}
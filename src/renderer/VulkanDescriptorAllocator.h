@@ -0,0 +1,60 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+class VulkanDevice;
+
+// Growable descriptor set allocator, owned by VulkanDevice:
+//  - persistent sets come from a chain of pools: when the current pool runs
+//    out a bigger one is appended, so allocation never fails for lack of room
+//    and needs no up-front count
+//  - Free() recycles a set: once the GPU is done with it, it goes to its
+//    layout's free list and the next Allocate() of that layout reuses it, so
+//    pools do not need FREE_DESCRIPTOR_SET and never fragment
+//  - transient sets belong to a frame slot; ResetFrame() releases them all
+//    with one vkResetDescriptorPool per pool, keeping the pools for reuse
+// Every path is O(1) per set. Not for UPDATE_AFTER_BIND layouts (those need
+// their own pool, see VulkanMaterialDescriptors). Main thread only.
+class VulkanDescriptorAllocator
+{
+public:
+    explicit VulkanDescriptorAllocator(VulkanDevice* device);
+    ~VulkanDescriptorAllocator();
+
+    // A recycled set keeps its old descriptors: write every binding used
+    VkDescriptorSet Allocate(VkDescriptorSetLayout layout);
+
+    // set goes back to layout's free list after the work submitted so far
+    // has completed. Do not record it again.
+    void Free(VkDescriptorSetLayout layout, VkDescriptorSet set);
+
+    // Valid until the slot's next ResetFrame()
+    VkDescriptorSet AllocateTransient(uint32_t frameIndex, VkDescriptorSetLayout layout);
+
+    // After the slot's frame wait (its last use of the sets has completed)
+    void ResetFrame(uint32_t frameIndex);
+
+    uint32_t GetPoolCount() const;
+
+private:
+    // Chain of pools sized by POOL_RATIOS x setsPerPool
+    struct PoolChain
+    {
+        std::vector<VkDescriptorPool> pools; // last one is current
+        uint32_t current = 0;                // transient chains rewind this on reset
+        uint32_t setsPerPool = 0;
+    };
+
+    VkDescriptorPool CreatePool(uint32_t maxSets) const;
+    VkDescriptorSet AllocateFrom(PoolChain& chain, VkDescriptorSetLayout layout);
+
+private:
+    VulkanDevice* m_Device = nullptr;
+
+    PoolChain m_Persistent;
+    std::vector<PoolChain> m_Frames; // grows with the slot indices used
+
+    std::unordered_map<VkDescriptorSetLayout, std::vector<VkDescriptorSet>> m_FreeSets;
+};
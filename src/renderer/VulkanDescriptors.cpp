@@ -1,57 +1,60 @@
 #include "VulkanDescriptors.h"
 #include "VulkanDevice.h"
+#include "VulkanDescriptorAllocator.h"
 #include "VulkanUniformBuffers.h"
+#include "VulkanLightStorage.h"
+#include "culling/VulkanLightClusters.h"
+#include "pipeline/VulkanStateCache.h"
 #include "../core/Logger.h"
 
+#include <array>
+
 VulkanDescriptors::VulkanDescriptors(VulkanDevice* device, VulkanUniformBuffers* ubo, uint32_t framesInFlight)
     : m_Device(device), m_UBO(ubo)
 {
     VkDevice vkDevice = m_Device->GetHandle();
 
-    // 1) Layout: set=0 binding=0 uniform buffer
-    VkDescriptorSetLayoutBinding uboBinding{};
-    uboBinding.binding = 0;
-    uboBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    uboBinding.descriptorCount = 1;
-    uboBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-
+    // 1) Layout: set=0 binding=0 camera uniform buffer, bindings 1-3 light
+    //    clusters (also read / written by the cluster build compute pass),
+    //    binding 4 sun + spot lights
+    std::array<VkDescriptorSetLayoutBinding, 5> bindings{};
 
-    VkDescriptorSetLayoutCreateInfo layoutInfo{};
-    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = 1;
-    layoutInfo.pBindings = &uboBinding;
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    if (vkCreateDescriptorSetLayout(vkDevice, &layoutInfo, nullptr, &m_Layout) != VK_SUCCESS)
-        LOG_ERROR("Failed to create descriptor set layout!");
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    // 2) Pool (one UBO descriptor per frame)
-    VkDescriptorPoolSize poolSize{};
-    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSize.descriptorCount = framesInFlight;
+    bindings[2].binding = 2;
+    bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[2].descriptorCount = 1;
+    bindings[2].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    VkDescriptorPoolCreateInfo poolInfo{};
-    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = 1;
-    poolInfo.pPoolSizes = &poolSize;
-    poolInfo.maxSets = framesInFlight;
+    bindings[3].binding = 3;
+    bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[3].descriptorCount = 1;
+    bindings[3].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    if (vkCreateDescriptorPool(vkDevice, &poolInfo, nullptr, &m_Pool) != VK_SUCCESS)
-        LOG_ERROR("Failed to create descriptor pool!");
+    bindings[4].binding = 4;
+    bindings[4].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[4].descriptorCount = 1;
+    bindings[4].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    // 3) Allocate sets (one per frame)
-    std::vector<VkDescriptorSetLayout> layouts(framesInFlight, m_Layout);
+    // Shared through the state cache (not destroyed here)
+    m_Layout = m_Device->GetStateCache()->GetSetLayout({ bindings.begin(), bindings.end() });
 
-    VkDescriptorSetAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = m_Pool;
-    allocInfo.descriptorSetCount = framesInFlight;
-    allocInfo.pSetLayouts = layouts.data();
+    // 2) Sets (one per frame)
+    VulkanDescriptorAllocator* allocator = m_Device->GetDescriptorAllocator();
 
     m_Sets.resize(framesInFlight);
-    if (vkAllocateDescriptorSets(vkDevice, &allocInfo, m_Sets.data()) != VK_SUCCESS)
-        LOG_ERROR("Failed to allocate descriptor sets!");
+    for (uint32_t i = 0; i < framesInFlight; i++)
+        m_Sets[i] = allocator->Allocate(m_Layout);
 
-    // 4) Write each set to point to that frame's UBO buffer
+    // 3) Write each set to point to that frame's UBO buffer
     for (uint32_t i = 0; i < framesInFlight; i++)
     {
         VkDescriptorBufferInfo bufferInfo{};
@@ -73,10 +76,34 @@ VulkanDescriptors::VulkanDescriptors(VulkanDevice* device, VulkanUniformBuffers*
     LOG_INFO("Descriptor layout + per-frame descriptor sets created.");
 }
 
-VulkanDescriptors::~VulkanDescriptors()
+void VulkanDescriptors::WriteLights(uint32_t frameIndex, const VulkanLightStorage* lights, const VulkanLightClusters* clusters)
 {
-    VkDevice vkDevice = m_Device->GetHandle();
+    std::array<VkDescriptorBufferInfo, 4> infos{};
+    infos[0].buffer = clusters->GetUniformBuffer(frameIndex);
+    infos[1].buffer = lights->GetPointLightBuffer(frameIndex);
+    infos[2].buffer = clusters->GetClusterBuffer(frameIndex);
+    infos[3].buffer = lights->GetSceneLightBuffer(frameIndex);
+
+    std::array<VkWriteDescriptorSet, 4> writes{};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        infos[i].offset = 0;
+        infos[i].range = VK_WHOLE_SIZE;
+
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = m_Sets[frameIndex];
+        writes[i].dstBinding = i + 1;
+        writes[i].descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &infos[i];
+    }
+
+    vkUpdateDescriptorSets(m_Device->GetHandle(), (uint32_t)writes.size(), writes.data(), 0, nullptr);
+}
 
-    if (m_Pool) vkDestroyDescriptorPool(vkDevice, m_Pool, nullptr);
-    if (m_Layout) vkDestroyDescriptorSetLayout(vkDevice, m_Layout, nullptr);
+VulkanDescriptors::~VulkanDescriptors()
+{
+    VulkanDescriptorAllocator* allocator = m_Device->GetDescriptorAllocator();
+    for (VkDescriptorSet set : m_Sets)
+        allocator->Free(m_Layout, set);
 }
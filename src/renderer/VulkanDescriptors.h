@@ -5,6 +5,8 @@
 
 class VulkanDevice;
 class VulkanUniformBuffers;
+class VulkanLightStorage;
+class VulkanLightClusters;
 
 class VulkanDescriptors
 {
@@ -15,11 +17,15 @@ public:
     VkDescriptorSetLayout GetLayout() const { return m_Layout; }
     VkDescriptorSet GetSet(uint32_t frameIndex) const { return m_Sets[frameIndex]; }
 
+    // Bindings 1-4: the slot's cluster uniforms, point lights, cluster lists
+    // and sun + spot lights. Before the slot's first frame and whenever its
+    // buffers change (the slot's last frame must have completed).
+    void WriteLights(uint32_t frameIndex, const VulkanLightStorage* lights, const VulkanLightClusters* clusters);
+
 private:
     VulkanDevice* m_Device = nullptr;
     VulkanUniformBuffers* m_UBO = nullptr;
 
     VkDescriptorSetLayout m_Layout = VK_NULL_HANDLE;
-    VkDescriptorPool      m_Pool = VK_NULL_HANDLE;
     std::vector<VkDescriptorSet> m_Sets;
 };
@@ -1,4 +1,9 @@
 #include "VulkanDevice.h"
+#include "VulkanTimeline.h"
+#include "VulkanProfiler.h"
+#include "VulkanFrameStats.h"
+#include "VulkanDescriptorAllocator.h"
+#include "pipeline/VulkanStateCache.h"
 #include "../core/Logger.h"
 
 #include <stdexcept>
@@ -17,6 +22,18 @@ VulkanDevice::~VulkanDevice()
 {
     if (m_Device)
     {
+        // Waits for outstanding work and runs its retirements
+        delete m_Timeline;
+        m_Timeline = nullptr;
+
+        // After the retirements: they may still free descriptor sets
+        // and release pipeline users
+        delete m_DescriptorAllocator;
+        m_DescriptorAllocator = nullptr;
+
+        delete m_StateCache;
+        m_StateCache = nullptr;
+
         if (m_TransferCommandPool)
         {
             vkDestroyCommandPool(m_Device, m_TransferCommandPool, nullptr);
@@ -65,6 +82,13 @@ void VulkanDevice::PickPhysicalDevice(VkInstance instance, VkSurfaceKHR surface)
 
 bool VulkanDevice::IsDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR surface)
 {
+    // Timeline semaphores are core in 1.2
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(device, &props);
+
+    if (props.apiVersion < VK_API_VERSION_1_2)
+        return false;
+
     FindQueueFamilies(device, surface);
 
     return m_GraphicsFamilyIndex != UINT32_MAX &&
@@ -100,7 +124,10 @@ void VulkanDevice::FindQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surfa
             m_GraphicsFamilyIndex = i;
 
         VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+        if (surface != VK_NULL_HANDLE)
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+        else
+            presentSupport = m_GraphicsFamilyIndex == i; // headless: nothing is presented
 
         if (presentSupport)
             m_PresentFamilyIndex = i;
@@ -134,16 +161,62 @@ void VulkanDevice::CreateLogicalDevice(VkSurfaceKHR surface)
         queueInfos.push_back(qInfo);
     }
 
-    const std::vector<const char*> deviceExtensions = {
-        VK_KHR_SWAPCHAIN_EXTENSION_NAME
-    };
+    std::vector<const char*> deviceExtensions;
+    if (surface != VK_NULL_HANDLE)
+        deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+
+    // Enable only the optional features we use, and only when supported.
+    // drawIndirectFirstInstance: GPU culling writes firstInstance into indirect draws.
+    // pipelineStatisticsQuery + inheritedQueries: FrameStats shading counters,
+    // also across the CPU path's secondary command buffers.
+    VkPhysicalDeviceFeatures supported{};
+    vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &supported);
+
+    m_EnabledFeatures = {};
+    m_EnabledFeatures.drawIndirectFirstInstance = supported.drawIndirectFirstInstance;
+    m_EnabledFeatures.pipelineStatisticsQuery = supported.pipelineStatisticsQuery;
+    m_EnabledFeatures.inheritedQueries = supported.inheritedQueries;
+
+    // Vulkan 1.2 features. timelineSemaphore is required (frame + upload sync).
+    // hostQueryReset: the profiler resets its timestamp ranges from the CPU.
+    // Descriptor indexing is required too: material textures are one bindless
+    // array (VulkanMaterialDescriptors), indexed per draw and written while bound.
+    VkPhysicalDeviceVulkan12Features supported12{};
+    supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+    VkPhysicalDeviceFeatures2 supported2{};
+    supported2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supported2.pNext = &supported12;
+    vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &supported2);
+
+    if (!supported12.timelineSemaphore)
+        throw std::runtime_error("VulkanDevice: timeline semaphores are not supported");
+
+    if (!supported12.runtimeDescriptorArray ||
+        !supported12.shaderSampledImageArrayNonUniformIndexing ||
+        !supported12.descriptorBindingPartiallyBound ||
+        !supported12.descriptorBindingSampledImageUpdateAfterBind ||
+        !supported12.descriptorBindingUpdateUnusedWhilePending)
+        throw std::runtime_error("VulkanDevice: descriptor indexing (bindless materials) is not supported");
+
+    m_EnabledFeatures12 = {};
+    m_EnabledFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    m_EnabledFeatures12.timelineSemaphore = VK_TRUE;
+    m_EnabledFeatures12.hostQueryReset = supported12.hostQueryReset;
+    m_EnabledFeatures12.runtimeDescriptorArray = VK_TRUE;
+    m_EnabledFeatures12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    m_EnabledFeatures12.descriptorBindingPartiallyBound = VK_TRUE;
+    m_EnabledFeatures12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    m_EnabledFeatures12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
 
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = &m_EnabledFeatures12;
     createInfo.queueCreateInfoCount = queueInfos.size();
     createInfo.pQueueCreateInfos = queueInfos.data();
     createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
     createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    createInfo.pEnabledFeatures = &m_EnabledFeatures;
 
 
     if (vkCreateDevice(m_PhysicalDevice, &createInfo, nullptr, &m_Device) != VK_SUCCESS)
@@ -157,6 +230,10 @@ void VulkanDevice::CreateLogicalDevice(VkSurfaceKHR surface)
 
     LOG_INFO("Logical device created successfully!");
 
+    m_Timeline = new VulkanTimeline(this, m_GraphicsQueue);
+    m_StateCache = new VulkanStateCache(this);
+    m_DescriptorAllocator = new VulkanDescriptorAllocator(this);
+
     // Create transfer / one-time command pool
     VkCommandPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -309,19 +386,35 @@ void VulkanDevice::EndSingleTimeCommands(VkCommandBuffer commandBuffer) const
 {
     vkEndCommandBuffer(commandBuffer);
 
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-
-    vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(m_GraphicsQueue);
+    // Frames already in flight keep running
+    m_Timeline->Wait(m_Timeline->Submit({ commandBuffer }));
 
     vkFreeCommandBuffers(m_Device, m_TransferCommandPool, 1, &commandBuffer);
 }
 
+uint64_t VulkanDevice::SubmitSingleTimeCommands(VkCommandBuffer commandBuffer) const
+{
+    vkEndCommandBuffer(commandBuffer);
+
+    uint64_t value = m_Timeline->Submit({ commandBuffer });
+
+    VkDevice device = m_Device;
+    VkCommandPool pool = m_TransferCommandPool;
+    m_Timeline->Retire(value, [device, pool, commandBuffer]()
+        {
+            vkFreeCommandBuffers(device, pool, 1, &commandBuffer);
+        });
+
+    return value;
+}
+
 void VulkanDevice::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) const
 {
+    PROFILE_CPU_ZONE(m_Profiler, "Buffer upload");
+
+    if (m_FrameStats)
+        m_FrameStats->CountUpload(size);
+
     VkCommandBuffer cmd = BeginSingleTimeCommands();
 
     VkBufferCopy copyRegion{};
@@ -329,7 +422,10 @@ void VulkanDevice::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSi
     copyRegion.dstOffset = 0;
     copyRegion.size = size;
 
-    vkCmdCopyBuffer(cmd, srcBuffer, dstBuffer, 1, &copyRegion);
+    {
+        PROFILE_GPU_SCOPE(m_Profiler, cmd, "Buffer upload");
+        vkCmdCopyBuffer(cmd, srcBuffer, dstBuffer, 1, &copyRegion);
+    }
 
     EndSingleTimeCommands(cmd);
 }
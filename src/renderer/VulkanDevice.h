@@ -3,9 +3,18 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 
+class VulkanTimeline;
+class VulkanProfiler;
+class VulkanFrameStats;
+class VulkanPipelineCache;
+class VulkanStateCache;
+class VulkanDescriptorAllocator;
+
 class VulkanDevice
 {
 public:
+    // surface may be VK_NULL_HANDLE (headless): no present queue requirement,
+    // no swapchain extension; the present queue is the graphics queue
     VulkanDevice(VkInstance instance, VkSurfaceKHR surface);
     ~VulkanDevice();
 
@@ -23,6 +32,32 @@ public:
 
     VkFormat FindDepthFormat() const;
 
+    // Optional core features that were available and got enabled at device creation
+    const VkPhysicalDeviceFeatures& GetEnabledFeatures() const { return m_EnabledFeatures; }
+    const VkPhysicalDeviceVulkan12Features& GetEnabledFeatures12() const { return m_EnabledFeatures12; }
+
+    // Graphics queue timeline. Transfers are submitted on the graphics queue,
+    // so frames and uploads share this one counter.
+    VulkanTimeline* GetTimeline() const { return m_Timeline; }
+
+    // Shared shader modules, layouts and pipelines (lives as long as the device)
+    VulkanStateCache* GetStateCache() const { return m_StateCache; }
+
+    // Descriptor sets of every non-bindless layout (lives as long as the device)
+    VulkanDescriptorAllocator* GetDescriptorAllocator() const { return m_DescriptorAllocator; }
+
+    // Optional (--profile), owned by Application. Null: scopes are no-ops.
+    VulkanProfiler* GetProfiler() const { return m_Profiler; }
+    void SetProfiler(VulkanProfiler* profiler) { m_Profiler = profiler; }
+
+    // Optional (--frame-stats), owned by Application. Null: nothing is counted.
+    VulkanFrameStats* GetFrameStats() const { return m_FrameStats; }
+    void SetFrameStats(VulkanFrameStats* stats) { m_FrameStats = stats; }
+
+    // Owned by Application. Null: pipelines are created without a cache.
+    VulkanPipelineCache* GetPipelineCache() const { return m_PipelineCache; }
+    void SetPipelineCache(VulkanPipelineCache* cache) { m_PipelineCache = cache; }
+
     uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
 
     void CreateBuffer(
@@ -36,9 +71,14 @@ public:
     void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) const;
 
     // --- One-time command helpers (for copy/transition) ---
+    // End waits for this submit only (its timeline value), not the whole queue
     VkCommandBuffer BeginSingleTimeCommands() const;
     void EndSingleTimeCommands(VkCommandBuffer commandBuffer) const;
 
+    // Ends + submits without waiting; the buffer is freed once its timeline
+    // value retires. Later submits on the queue are ordered after it.
+    uint64_t SubmitSingleTimeCommands(VkCommandBuffer commandBuffer) const;
+
 
 private:
     void PickPhysicalDevice(VkInstance instance, VkSurfaceKHR surface);
@@ -69,4 +109,14 @@ private:
     // NEW: MSAA sample count
     VkSampleCountFlagBits m_MSAASamples = VK_SAMPLE_COUNT_1_BIT;
 
+    VkPhysicalDeviceFeatures m_EnabledFeatures{};
+    VkPhysicalDeviceVulkan12Features m_EnabledFeatures12{};
+
+    VulkanTimeline* m_Timeline = nullptr;
+    VulkanStateCache* m_StateCache = nullptr;
+    VulkanDescriptorAllocator* m_DescriptorAllocator = nullptr;
+    VulkanProfiler* m_Profiler = nullptr;
+    VulkanFrameStats* m_FrameStats = nullptr;
+    VulkanPipelineCache* m_PipelineCache = nullptr;
+
 };
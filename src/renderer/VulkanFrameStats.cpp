@@ -0,0 +1,201 @@
+#include "VulkanFrameStats.h"
+#include "VulkanDevice.h"
+#include "culling/VulkanGpuCulling.h"
+#include "../core/Logger.h"
+
+#include <stdexcept>
+
+// Result order follows the flag bits, lowest first
+static constexpr VkQueryPipelineStatisticFlags STATISTIC_FLAGS =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+static constexpr uint32_t STATISTIC_COUNT = 7;
+
+VulkanFrameStats::VulkanFrameStats(VulkanDevice* device, uint32_t framesInFlight)
+    : m_Device(device)
+{
+    m_Slots.resize(framesInFlight);
+
+    const VkPhysicalDeviceFeatures& features = m_Device->GetEnabledFeatures();
+    if (!features.pipelineStatisticsQuery)
+    {
+        LOG_WARN("FrameStats: pipeline statistics queries not supported, submission counters only");
+        return;
+    }
+
+    m_InheritedQueries = features.inheritedQueries == VK_TRUE;
+    m_StatisticFlags = STATISTIC_FLAGS;
+
+    VkQueryPoolCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    info.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+    info.queryCount = framesInFlight;
+    info.pipelineStatistics = m_StatisticFlags;
+
+    if (vkCreateQueryPool(m_Device->GetHandle(), &info, nullptr, &m_QueryPool) != VK_SUCCESS)
+        throw std::runtime_error("VulkanFrameStats: failed to create pipeline statistics query pool");
+}
+
+VulkanFrameStats::~VulkanFrameStats()
+{
+    if (m_QueryPool)
+        vkDestroyQueryPool(m_Device->GetHandle(), m_QueryPool, nullptr);
+}
+
+bool VulkanFrameStats::OpenCsv(const std::string& path)
+{
+    m_Csv.open(path);
+    if (!m_Csv)
+    {
+        LOG_ERROR("FrameStats: cannot write " + path);
+        return false;
+    }
+
+    m_Csv << "frame,drawCalls,instancesSubmitted,instancesDrawn,frustumCulled,occlusionCulled,drawnLate,"
+        "trianglesSubmitted,trianglesDrawn,"
+        "pipelineBinds,descriptorBinds,pushConstantUpdates,uploadBytes,fallbackPipelines,"
+        "iaVertices,iaPrimitives,vsInvocations,clippingInvocations,clippingPrimitives,fsInvocations,csInvocations\n";
+    return true;
+}
+
+void VulkanFrameStats::WriteCsvRow(const FrameStats& s)
+{
+    if (!m_Csv.is_open())
+        return;
+
+    m_Csv << s.frame << ',' << s.drawCalls << ',' << s.instancesSubmitted << ',' << s.instancesDrawn << ','
+        << s.frustumCulled << ',' << s.occlusionCulled << ',' << s.drawnLate << ','
+        << s.trianglesSubmitted << ',' << s.trianglesDrawn << ','
+        << s.pipelineBinds << ',' << s.descriptorBinds << ',' << s.pushConstantUpdates << ',' << s.uploadBytes
+        << ',' << (s.onFallbackPipelines ? 1 : 0);
+
+    // Empty shading columns when the frame had no query result
+    if (s.hasPipelineStatistics)
+    {
+        m_Csv << ',' << s.inputAssemblyVertices << ',' << s.inputAssemblyPrimitives << ',' << s.vertexInvocations
+            << ',' << s.clippingInvocations << ',' << s.clippingPrimitives << ',' << s.fragmentInvocations
+            << ',' << s.computeInvocations << '\n';
+    }
+    else
+    {
+        m_Csv << ",,,,,,,\n";
+    }
+}
+
+void VulkanFrameStats::Resolve(uint32_t frameIndex, const GpuCullingStats& gpuCulling)
+{
+    Slot& slot = m_Slots[frameIndex];
+    if (!slot.pending)
+        return;
+
+    slot.pending = false;
+    FrameStats stats = slot.stats;
+
+    if (slot.queried)
+    {
+        // Values + availability; the slot's frame has completed, so no wait
+        uint64_t results[STATISTIC_COUNT + 1] = {};
+        VkResult result = vkGetQueryPoolResults(
+            m_Device->GetHandle(),
+            m_QueryPool,
+            frameIndex,
+            1,
+            sizeof(results),
+            results,
+            sizeof(results),
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+        if ((result == VK_SUCCESS || result == VK_NOT_READY) && results[STATISTIC_COUNT] != 0)
+        {
+            stats.hasPipelineStatistics = true;
+            stats.inputAssemblyVertices = results[0];
+            stats.inputAssemblyPrimitives = results[1];
+            stats.vertexInvocations = results[2];
+            stats.clippingInvocations = results[3];
+            stats.clippingPrimitives = results[4];
+            stats.fragmentInvocations = results[5];
+            stats.computeInvocations = results[6];
+        }
+    }
+
+    if (slot.gpuCulled)
+    {
+        stats.instancesDrawn = gpuCulling.drawnEarly + gpuCulling.drawnLate;
+        stats.frustumCulled = gpuCulling.frustumCulled;
+        stats.occlusionCulled = gpuCulling.occlusionCulled;
+        stats.drawnLate = gpuCulling.drawnLate;
+        stats.trianglesDrawn = stats.hasPipelineStatistics ? stats.inputAssemblyPrimitives : 0;
+    }
+
+    m_Last = stats;
+    WriteCsvRow(stats);
+}
+
+void VulkanFrameStats::BeginFrame(uint32_t frameIndex, uint64_t frameNumber)
+{
+    m_CurrentSlot = frameIndex;
+    m_CurrentFrame = frameNumber;
+    m_Slots[frameIndex].queried = false;
+}
+
+void VulkanFrameStats::BeginQuery(VkCommandBuffer cmd)
+{
+    if (!m_QueryPool || m_QueryActive)
+        return;
+
+    vkCmdResetQueryPool(cmd, m_QueryPool, m_CurrentSlot, 1);
+    vkCmdBeginQuery(cmd, m_QueryPool, m_CurrentSlot, 0);
+
+    m_QueryActive = true;
+    m_Slots[m_CurrentSlot].queried = true;
+}
+
+void VulkanFrameStats::EndQuery(VkCommandBuffer cmd)
+{
+    if (!m_QueryActive)
+        return;
+
+    vkCmdEndQuery(cmd, m_QueryPool, m_CurrentSlot);
+    m_QueryActive = false;
+}
+
+void VulkanFrameStats::EndFrame(bool gpuCulled)
+{
+    Slot& slot = m_Slots[m_CurrentSlot];
+
+    FrameStats& s = slot.stats;
+    s = FrameStats();
+    s.frame = m_CurrentFrame;
+    s.drawCalls = m_DrawCalls.exchange(0, std::memory_order_relaxed);
+    s.instancesSubmitted = m_InstancesSubmitted.exchange(0, std::memory_order_relaxed);
+    s.instancesDrawn = m_InstancesDrawn.exchange(0, std::memory_order_relaxed);
+    s.trianglesSubmitted = m_TrianglesSubmitted.exchange(0, std::memory_order_relaxed);
+    s.trianglesDrawn = m_TrianglesDrawn.exchange(0, std::memory_order_relaxed);
+    s.pipelineBinds = m_PipelineBinds.exchange(0, std::memory_order_relaxed);
+    s.descriptorBinds = m_DescriptorBinds.exchange(0, std::memory_order_relaxed);
+    s.pushConstantUpdates = m_PushConstants.exchange(0, std::memory_order_relaxed);
+    s.uploadBytes = m_UploadBytes.exchange(0, std::memory_order_relaxed);
+    s.onFallbackPipelines = m_OnFallback.exchange(false, std::memory_order_relaxed);
+
+    slot.gpuCulled = gpuCulled;
+    slot.pending = true;
+}
+
+void VulkanFrameStats::CountSubmitted(uint32_t instances, uint64_t triangles)
+{
+    m_InstancesSubmitted.fetch_add(instances, std::memory_order_relaxed);
+    m_TrianglesSubmitted.fetch_add(triangles, std::memory_order_relaxed);
+}
+
+void VulkanFrameStats::CountDraws(uint32_t drawCalls, uint32_t instances, uint64_t triangles)
+{
+    m_DrawCalls.fetch_add(drawCalls, std::memory_order_relaxed);
+    m_InstancesDrawn.fetch_add(instances, std::memory_order_relaxed);
+    m_TrianglesDrawn.fetch_add(triangles, std::memory_order_relaxed);
+}
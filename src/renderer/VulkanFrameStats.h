@@ -0,0 +1,131 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class VulkanDevice;
+struct GpuCullingStats;
+
+// One finished frame. Submission counters are exact CPU counts; the shading
+// side comes from a VK_QUERY_TYPE_PIPELINE_STATISTICS query around the
+// frame's passes (compute culling included).
+struct FrameStats
+{
+    uint64_t frame = 0;
+
+    // --- Submission ---
+    uint32_t drawCalls = 0;           // one per vkCmdDraw* (an indirect batch counts once)
+    uint32_t instancesSubmitted = 0;  // renderable objects before any culling
+    uint32_t instancesDrawn = 0;      // after culling (GPU culling: its readback counters)
+    uint32_t frustumCulled = 0;       // GPU culling only
+    uint32_t occlusionCulled = 0;     // GPU culling only (0 without occlusion)
+    uint32_t drawnLate = 0;           // GPU culling: part of instancesDrawn from the late pass
+    uint64_t trianglesSubmitted = 0;
+    uint64_t trianglesDrawn = 0;      // GPU culling: input assembly primitives (0 without pipeline statistics)
+    uint32_t pipelineBinds = 0;
+    uint32_t descriptorBinds = 0;     // vkCmdBindDescriptorSets calls
+    uint32_t pushConstantUpdates = 0;
+    uint64_t uploadBytes = 0;         // mapped writes + staging copies towards the GPU
+    bool onFallbackPipelines = false; // some draws used a fallback (or were skipped) while a pipeline compiled
+
+    // --- Shading (hasPipelineStatistics) ---
+    bool hasPipelineStatistics = false;
+    uint64_t inputAssemblyVertices = 0;
+    uint64_t inputAssemblyPrimitives = 0;
+    uint64_t vertexInvocations = 0;
+    uint64_t clippingInvocations = 0;
+    uint64_t clippingPrimitives = 0;
+    uint64_t fragmentInvocations = 0;
+    uint64_t computeInvocations = 0;
+};
+
+// Collects FrameStats per frame slot. Counters are thread-safe (worker
+// threads record draws) and accumulate from one EndFrame() to the next, so
+// uploads between frames land in the next frame. A slot's pipeline
+// statistics are read back when the slot comes around again, without waiting.
+// Reached through VulkanDevice::GetFrameStats(); null when not collecting.
+class VulkanFrameStats
+{
+public:
+    VulkanFrameStats(VulkanDevice* device, uint32_t framesInFlight);
+    ~VulkanFrameStats();
+
+    // pipelineStatisticsQuery supported and enabled
+    bool HasPipelineStatistics() const { return m_QueryPool != VK_NULL_HANDLE; }
+
+    // The query may stay active across vkCmdExecuteCommands (inheritedQueries)
+    bool CanQueryAcrossSecondaries() const { return HasPipelineStatistics() && m_InheritedQueries; }
+
+    // Secondary buffers executed while the query is active must be recorded with these
+    VkQueryPipelineStatisticFlags GetPipelineStatisticFlags() const { return m_StatisticFlags; }
+
+    // One row per finished frame from now on
+    bool OpenCsv(const std::string& path);
+
+    // After the slot's frame wait: finalizes the frame that last used the slot.
+    // gpuCulling: GPU culling's counters for that frame (ignored if it was
+    // culled on the CPU).
+    void Resolve(uint32_t frameIndex, const GpuCullingStats& gpuCulling);
+
+    void BeginFrame(uint32_t frameIndex, uint64_t frameNumber);
+
+    // Around the frame's passes, outside render passes
+    void BeginQuery(VkCommandBuffer cmd);
+    void EndQuery(VkCommandBuffer cmd);
+
+    // After submit. gpuCulled: instances / triangles drawn are only known on the GPU.
+    void EndFrame(bool gpuCulled);
+
+    // Most recent finished frame
+    const FrameStats& GetLast() const { return m_Last; }
+
+    // --- Counters (thread-safe) ---
+    void CountSubmitted(uint32_t instances, uint64_t triangles);
+    void CountDraws(uint32_t drawCalls, uint32_t instances, uint64_t triangles);
+    void CountPipelineBinds(uint32_t count) { m_PipelineBinds.fetch_add(count, std::memory_order_relaxed); }
+    void CountDescriptorBinds(uint32_t count) { m_DescriptorBinds.fetch_add(count, std::memory_order_relaxed); }
+    void CountPushConstants(uint32_t count) { m_PushConstants.fetch_add(count, std::memory_order_relaxed); }
+    void CountUpload(uint64_t bytes) { m_UploadBytes.fetch_add(bytes, std::memory_order_relaxed); }
+    void MarkFallbackPipelines() { m_OnFallback.store(true, std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        FrameStats stats;
+        bool pending = false;
+        bool queried = false;
+        bool gpuCulled = false;
+    };
+
+    void WriteCsvRow(const FrameStats& stats);
+
+private:
+    VulkanDevice* m_Device = nullptr;
+
+    VkQueryPool m_QueryPool = VK_NULL_HANDLE; // one pipeline statistics query per slot
+    VkQueryPipelineStatisticFlags m_StatisticFlags = 0;
+    bool m_InheritedQueries = false;
+
+    std::vector<Slot> m_Slots;
+    uint32_t m_CurrentSlot = 0;
+    uint64_t m_CurrentFrame = 0;
+    bool m_QueryActive = false;
+
+    FrameStats m_Last;
+    std::ofstream m_Csv;
+
+    // Current frame
+    std::atomic<uint32_t> m_DrawCalls{ 0 };
+    std::atomic<uint32_t> m_InstancesSubmitted{ 0 };
+    std::atomic<uint32_t> m_InstancesDrawn{ 0 };
+    std::atomic<uint64_t> m_TrianglesSubmitted{ 0 };
+    std::atomic<uint64_t> m_TrianglesDrawn{ 0 };
+    std::atomic<uint32_t> m_PipelineBinds{ 0 };
+    std::atomic<uint32_t> m_DescriptorBinds{ 0 };
+    std::atomic<uint32_t> m_PushConstants{ 0 };
+    std::atomic<uint64_t> m_UploadBytes{ 0 };
+    std::atomic<bool> m_OnFallback{ false };
+};
@@ -1,31 +1,29 @@
 #include "VulkanFramebuffers.h"
 #include "VulkanDevice.h"
-#include "VulkanSwapchain.h"
 #include "VulkanDepthBuffer.h"
 #include "VulkanMSAAColorBuffer.h"
 #include "VulkanRenderPass.h"
 #include "../core/Logger.h"
 
 VulkanFramebuffers::VulkanFramebuffers(VulkanDevice* device,
-    VulkanSwapchain* swapchain,
+    const std::vector<VkImageView>& targetViews,
+    VkExtent2D extent,
     VulkanRenderPass* renderPass,
     VulkanDepthBuffer* depthBuffer,
     VulkanMSAAColorBuffer* msaaColor)
     : m_Device(device),
-    m_Swapchain(swapchain),
     m_RenderPass(renderPass),
     m_DepthBuffer(depthBuffer),
     m_MSAAColor(msaaColor)
 {
-    const auto& swapViews = m_Swapchain->GetImageViews();
-    m_Framebuffers.resize(swapViews.size());
+    m_Framebuffers.resize(targetViews.size());
 
-    for (size_t i = 0; i < swapViews.size(); ++i)
+    for (size_t i = 0; i < targetViews.size(); ++i)
     {
         VkImageView attachments[3] = {
             m_MSAAColor->GetImageView(),
             m_DepthBuffer->GetImageView(),
-            swapViews[i]
+            targetViews[i]
         };
 
         VkFramebufferCreateInfo fbInfo{};
@@ -33,8 +31,8 @@ VulkanFramebuffers::VulkanFramebuffers(VulkanDevice* device,
         fbInfo.renderPass = m_RenderPass->GetHandle();
         fbInfo.attachmentCount = 3;
         fbInfo.pAttachments = attachments;
-        fbInfo.width = m_Swapchain->GetExtent().width;
-        fbInfo.height = m_Swapchain->GetExtent().height;
+        fbInfo.width = extent.width;
+        fbInfo.height = extent.height;
         fbInfo.layers = 1;
 
         if (vkCreateFramebuffer(m_Device->GetHandle(), &fbInfo, nullptr, &m_Framebuffers[i]) != VK_SUCCESS)
@@ -4,7 +4,6 @@
 #include <vector>
 
 class VulkanDevice;
-class VulkanSwapchain;
 class VulkanDepthBuffer;
 class VulkanMSAAColorBuffer;
 class VulkanRenderPass;
@@ -12,8 +11,10 @@ class VulkanRenderPass;
 class VulkanFramebuffers
 {
 public:
+    // One framebuffer per resolve target image (swapchain or offscreen views)
     VulkanFramebuffers(VulkanDevice* device,
-        VulkanSwapchain* swapchain,
+        const std::vector<VkImageView>& targetViews,
+        VkExtent2D extent,
         VulkanRenderPass* renderPass,
         VulkanDepthBuffer* depthBuffer,
         VulkanMSAAColorBuffer* msaaColor);
@@ -23,7 +24,6 @@ public:
 
 private:
     VulkanDevice* m_Device = nullptr;
-    VulkanSwapchain* m_Swapchain = nullptr;
     VulkanRenderPass* m_RenderPass = nullptr;
     VulkanDepthBuffer* m_DepthBuffer = nullptr;
     VulkanMSAAColorBuffer* m_MSAAColor = nullptr;
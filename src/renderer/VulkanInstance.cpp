@@ -6,8 +6,8 @@ static const std::vector<const char*> validationLayers = {
     "VK_LAYER_KHRONOS_validation"
 };
 
-VulkanInstance::VulkanInstance(bool enableValidationLayers)
-    : m_EnableValidationLayers(enableValidationLayers)
+VulkanInstance::VulkanInstance(bool enableValidationLayers, bool headless)
+    : m_EnableValidationLayers(enableValidationLayers), m_Headless(headless)
 {
     CreateInstance();
     SetupDebugMessenger();
@@ -25,9 +25,11 @@ VulkanInstance::~VulkanInstance()
 
 void VulkanInstance::CreateInstance()
 {
+    // CI machines often have a driver but no SDK layers
     if (m_EnableValidationLayers && !CheckValidationLayerSupport())
     {
-        LOG_ERROR("Validation layers requested but not available!");
+        LOG_WARN("Validation layers requested but not available, continuing without them.");
+        m_EnableValidationLayers = false;
     }
 
     VkApplicationInfo appInfo{};
@@ -97,10 +99,15 @@ bool VulkanInstance::CheckValidationLayerSupport()
 
 std::vector<const char*> VulkanInstance::GetRequiredExtensions()
 {
-    uint32_t glfwExtensionCount = 0;
-    const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+    std::vector<const char*> extensions;
 
-    std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    if (!m_Headless)
+    {
+        uint32_t glfwExtensionCount = 0;
+        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+
+        extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    }
 
     if (m_EnableValidationLayers)
     {
@@ -7,7 +7,8 @@
 class VulkanInstance
 {
 public:
-    VulkanInstance(bool enableValidationLayers = true);
+    // headless: no window-system extensions, GLFW is never touched
+    VulkanInstance(bool enableValidationLayers = true, bool headless = false);
     ~VulkanInstance();
 
     VkInstance GetHandle() const { return m_Instance; }
@@ -16,6 +17,7 @@ private:
     VkInstance m_Instance = VK_NULL_HANDLE;
     VkDebugUtilsMessengerEXT m_DebugMessenger = nullptr;
     bool m_EnableValidationLayers = true;
+    bool m_Headless = false;
 
 private:
     void CreateInstance();
@@ -0,0 +1,168 @@
+#include "VulkanLightStorage.h"
+#include "VulkanDevice.h"
+#include "VulkanFrameStats.h"
+#include "../core/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+VulkanLightStorage::VulkanLightStorage(VulkanDevice* device, uint32_t framesInFlight)
+    : m_Device(device)
+{
+    m_PointStream.slots.resize(framesInFlight);
+    m_SceneStream.slots.resize(framesInFlight);
+
+    m_SceneBytes.resize(sizeof(SceneLighting));
+    WriteHeader();
+
+    // Every slot gets buffers right away, so set 0 can be written before the first frame
+    for (uint32_t i = 0; i < framesInFlight; i++)
+    {
+        Upload(m_PointStream, i, m_PointLights.data(), m_PointLights.size() * sizeof(PointLight));
+        Upload(m_SceneStream, i, m_SceneBytes.data(), m_SceneBytes.size());
+    }
+
+    LOG_INFO("Light storage created.");
+}
+
+VulkanLightStorage::~VulkanLightStorage()
+{
+    for (Stream::Slot& slot : m_PointStream.slots)
+        DestroySlot(slot);
+    for (Stream::Slot& slot : m_SceneStream.slots)
+        DestroySlot(slot);
+}
+
+void VulkanLightStorage::DestroySlot(Stream::Slot& slot)
+{
+    VkDevice vkDevice = m_Device->GetHandle();
+
+    if (slot.mapped) vkUnmapMemory(vkDevice, slot.memory);
+    if (slot.buffer) vkDestroyBuffer(vkDevice, slot.buffer, nullptr);
+    if (slot.memory) vkFreeMemory(vkDevice, slot.memory, nullptr);
+
+    slot = Stream::Slot();
+}
+
+// --- Edits (CPU copy + dirty ranges) ---
+
+void VulkanLightStorage::MarkDirty(Stream& stream, size_t begin, size_t end)
+{
+    for (Stream::Slot& slot : stream.slots)
+    {
+        if (slot.dirtyBegin == slot.dirtyEnd)
+        {
+            slot.dirtyBegin = begin;
+            slot.dirtyEnd = end;
+        }
+        else
+        {
+            slot.dirtyBegin = std::min(slot.dirtyBegin, begin);
+            slot.dirtyEnd = std::max(slot.dirtyEnd, end);
+        }
+    }
+}
+
+void VulkanLightStorage::WriteHeader()
+{
+    std::memcpy(m_SceneBytes.data(), &m_Header, sizeof(SceneLighting));
+    MarkDirty(m_SceneStream, 0, sizeof(SceneLighting));
+}
+
+void VulkanLightStorage::SetSun(const DirectionalLight& sun)
+{
+    m_Header.sun = sun;
+    WriteHeader();
+}
+
+uint32_t VulkanLightStorage::AddPointLight(const PointLight& light)
+{
+    const uint32_t index = GetPointLightCount();
+    m_PointLights.push_back(light);
+
+    MarkDirty(m_PointStream, index * sizeof(PointLight), (index + 1) * sizeof(PointLight));
+    return index;
+}
+
+void VulkanLightStorage::SetPointLight(uint32_t index, const PointLight& light)
+{
+    m_PointLights[index] = light;
+    MarkDirty(m_PointStream, index * sizeof(PointLight), (index + 1) * sizeof(PointLight));
+}
+
+uint32_t VulkanLightStorage::AddSpotLight(const SpotLight& light)
+{
+    const uint32_t index = m_Header.spotLightCount;
+    m_SpotLights.push_back(light);
+    m_SceneBytes.resize(sizeof(SceneLighting) + (index + 1) * sizeof(SpotLight));
+
+    m_Header.spotLightCount++;
+    WriteHeader();
+    SetSpotLight(index, light);
+    return index;
+}
+
+void VulkanLightStorage::SetSpotLight(uint32_t index, const SpotLight& light)
+{
+    m_SpotLights[index] = light;
+
+    const size_t offset = sizeof(SceneLighting) + size_t(index) * sizeof(SpotLight);
+    std::memcpy(m_SceneBytes.data() + offset, &light, sizeof(SpotLight));
+    MarkDirty(m_SceneStream, offset, offset + sizeof(SpotLight));
+}
+
+// --- Upload ---
+
+bool VulkanLightStorage::Upload(Stream& stream, uint32_t frameIndex, const void* data, size_t size)
+{
+    Stream::Slot& slot = stream.slots[frameIndex];
+    bool reallocated = false;
+
+    // Grow: only this slot, whose last frame has completed
+    if (slot.buffer == VK_NULL_HANDLE || size > slot.capacity)
+    {
+        DestroySlot(slot);
+
+        VkDeviceSize capacity = 4096;
+        while (capacity < size)
+            capacity *= 2;
+
+        m_Device->CreateBuffer(
+            capacity,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            slot.buffer,
+            slot.memory
+        );
+
+        if (vkMapMemory(m_Device->GetHandle(), slot.memory, 0, capacity, 0, &slot.mapped) != VK_SUCCESS)
+            throw std::runtime_error("VulkanLightStorage: failed to map light buffer");
+
+        slot.capacity = capacity;
+        slot.dirtyBegin = 0;
+        slot.dirtyEnd = size;
+        reallocated = true;
+    }
+
+    const size_t end = std::min(slot.dirtyEnd, size);
+    if (slot.dirtyBegin < end)
+    {
+        std::memcpy(static_cast<uint8_t*>(slot.mapped) + slot.dirtyBegin,
+            static_cast<const uint8_t*>(data) + slot.dirtyBegin, end - slot.dirtyBegin);
+
+        if (VulkanFrameStats* stats = m_Device->GetFrameStats())
+            stats->CountUpload(end - slot.dirtyBegin);
+    }
+
+    slot.dirtyBegin = 0;
+    slot.dirtyEnd = 0;
+    return reallocated;
+}
+
+bool VulkanLightStorage::Prepare(uint32_t frameIndex)
+{
+    bool reallocated = Upload(m_PointStream, frameIndex, m_PointLights.data(), m_PointLights.size() * sizeof(PointLight));
+    reallocated |= Upload(m_SceneStream, frameIndex, m_SceneBytes.data(), m_SceneBytes.size());
+    return reallocated;
+}
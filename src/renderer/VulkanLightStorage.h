@@ -0,0 +1,86 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <cstdint>
+
+#include "../lighting/SceneLighting.h"
+
+class VulkanDevice;
+
+// Scene lights in storage buffers, apart from the per-frame camera UBO:
+//  - point lights: set 0 binding 2 (binned by VulkanLightClusters)
+//  - sun + spot lights: set 0 binding 4 (SceneLighting header, then the spots)
+// The CPU copy is authoritative. Edits only mark their byte range dirty;
+// each frame slot keeps its own copy and, once its last frame has completed,
+// Prepare() uploads just what changed since that slot was last written.
+// Static lighting costs no upload at all, and the light count is bounded
+// by memory, not by UBO size limits.
+class VulkanLightStorage
+{
+public:
+    VulkanLightStorage(VulkanDevice* device, uint32_t framesInFlight);
+    ~VulkanLightStorage();
+
+    void SetSun(const DirectionalLight& sun);
+
+    uint32_t AddPointLight(const PointLight& light); // returns its index
+    void SetPointLight(uint32_t index, const PointLight& light);
+
+    uint32_t AddSpotLight(const SpotLight& light);
+    void SetSpotLight(uint32_t index, const SpotLight& light);
+
+    uint32_t GetPointLightCount() const { return static_cast<uint32_t>(m_PointLights.size()); }
+    uint32_t GetSpotLightCount() const { return m_Header.spotLightCount; }
+    const std::vector<PointLight>& GetPointLights() const { return m_PointLights; }
+    const std::vector<SpotLight>& GetSpotLights() const { return m_SpotLights; }
+
+    // Uploads the slot's dirty ranges. True when one of its buffers was
+    // reallocated: the slot's set 0 must be rewritten before recording.
+    bool Prepare(uint32_t frameIndex);
+
+    VkBuffer GetPointLightBuffer(uint32_t frameIndex) const { return m_PointStream.slots[frameIndex].buffer; }
+    VkBuffer GetSceneLightBuffer(uint32_t frameIndex) const { return m_SceneStream.slots[frameIndex].buffer; }
+
+private:
+    // One GPU copy per frame slot of a CPU byte array
+    struct Stream
+    {
+        struct Slot
+        {
+            VkBuffer       buffer = VK_NULL_HANDLE;
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            void*          mapped = nullptr;
+            VkDeviceSize   capacity = 0;
+
+            // Bytes changed since this slot was last written (begin == end: none)
+            size_t dirtyBegin = 0;
+            size_t dirtyEnd = 0;
+        };
+
+        std::vector<Slot> slots;
+    };
+
+    // Every slot must re-upload [begin, end)
+    static void MarkDirty(Stream& stream, size_t begin, size_t end);
+
+    // Copies the slot's dirty part of data; returns true when the slot's
+    // buffer was reallocated (then all of data is copied)
+    bool Upload(Stream& stream, uint32_t frameIndex, const void* data, size_t size);
+    void DestroySlot(Stream::Slot& slot);
+
+    // m_Header -> the front of m_SceneBytes
+    void WriteHeader();
+
+private:
+    VulkanDevice* m_Device = nullptr;
+
+    std::vector<PointLight> m_PointLights;
+    std::vector<SpotLight>  m_SpotLights;
+
+    // [SceneLighting header][SpotLight...], exactly as the shader sees it
+    SceneLighting        m_Header{};
+    std::vector<uint8_t> m_SceneBytes;
+
+    Stream m_PointStream;
+    Stream m_SceneStream;
+};
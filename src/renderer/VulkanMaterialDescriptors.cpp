@@ -1,32 +1,74 @@
-﻿#include "VulkanMaterialDescriptors.h"
+#include "VulkanMaterialDescriptors.h"
 #include "VulkanDevice.h"
-#include "VulkanCheck.h"
+#include "pipeline/VulkanStateCache.h"
 #include "../core/Logger.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+// Texture array size, lowered to what the device allows for update-after-bind
+// sets (a few slots stay free for the other sets of the layout)
+static constexpr uint32_t MAX_TEXTURES = 4096;
+static constexpr uint32_t RESERVED_RESOURCES = 16;
+
 VulkanMaterialDescriptors::VulkanMaterialDescriptors(VulkanDevice* device, uint32_t maxMaterials)
-    : m_Device(device)
+    : m_Device(device), m_MaxMaterials(maxMaterials)
 {
     VkDevice vkDevice = m_Device->GetHandle();
 
-	CreateLayout();
+    VkPhysicalDeviceVulkan12Properties props12{};
+    props12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 props{};
+    props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    props.pNext = &props12;
+    vkGetPhysicalDeviceProperties2(m_Device->GetPhysicalDevice(), &props);
+
+    m_MaxTextures = std::min({
+        MAX_TEXTURES,
+        props12.maxPerStageDescriptorUpdateAfterBindSamplers,
+        props12.maxPerStageDescriptorUpdateAfterBindSampledImages,
+        props12.maxDescriptorSetUpdateAfterBindSamplers,
+        props12.maxDescriptorSetUpdateAfterBindSampledImages,
+        props12.maxPerStageUpdateAfterBindResources > RESERVED_RESOURCES
+            ? props12.maxPerStageUpdateAfterBindResources - RESERVED_RESOURCES
+            : 1u });
+
+    CreateLayout();
 
-    // We need COMBINED_IMAGE_SAMPLER descriptors for:
-    // binding 0 = albedo, binding 1 = normal
-    // => 2 per material
-    VkDescriptorPoolSize poolSize{};
-    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSize.descriptorCount = maxMaterials * 2;
+    // One set: the texture array + the material buffer
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = m_MaxTextures;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[1].descriptorCount = 1;
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = 1;
-    poolInfo.pPoolSizes = &poolSize;
-    poolInfo.maxSets = maxMaterials;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = 1;
 
     if (vkCreateDescriptorPool(vkDevice, &poolInfo, nullptr, &m_Pool) != VK_SUCCESS)
-        LOG_ERROR("Failed to create material descriptor pool!");
-    else
-        LOG_INFO("Material descriptor pool created.");
+        throw std::runtime_error("VulkanMaterialDescriptors: failed to create descriptor pool");
+
+    VkDescriptorSetAllocateInfo alloc{};
+    alloc.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc.descriptorPool = m_Pool;
+    alloc.descriptorSetCount = 1;
+    alloc.pSetLayouts = &m_Layout;
+
+    if (vkAllocateDescriptorSets(vkDevice, &alloc, &m_Set) != VK_SUCCESS)
+        throw std::runtime_error("VulkanMaterialDescriptors: failed to allocate descriptor set");
+
+    CreateMaterialBuffer();
+
+    LOG_INFO("Material table created (" + std::to_string(m_MaxTextures) + " textures, " +
+        std::to_string(m_MaxMaterials) + " materials).");
 }
 
 VulkanMaterialDescriptors::~VulkanMaterialDescriptors()
@@ -34,41 +76,116 @@ VulkanMaterialDescriptors::~VulkanMaterialDescriptors()
     if (!m_Device) return;
     VkDevice device = m_Device->GetHandle();
 
-    if (m_Layout != VK_NULL_HANDLE)
-    {
-        vkDestroyDescriptorSetLayout(device, m_Layout, nullptr);
-        m_Layout = VK_NULL_HANDLE;
-    }
-
     if (m_Pool != VK_NULL_HANDLE)
     {
         vkDestroyDescriptorPool(device, m_Pool, nullptr);
         m_Pool = VK_NULL_HANDLE;
     }
+
+    if (m_MaterialMapped) vkUnmapMemory(device, m_MaterialMemory);
+    if (m_MaterialBuffer) vkDestroyBuffer(device, m_MaterialBuffer, nullptr);
+    if (m_MaterialMemory) vkFreeMemory(device, m_MaterialMemory, nullptr);
 }
 
 void VulkanMaterialDescriptors::CreateLayout()
 {
-    VkDevice device = m_Device->GetHandle();
+    std::vector<VkDescriptorSetLayoutBinding> bindings(2);
 
-    VkDescriptorSetLayoutBinding bindings[2]{};
-
-    // binding 0 → albedo
+    // binding 0 → every material texture
     bindings[0].binding = 0;
     bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    bindings[0].descriptorCount = 1;
+    bindings[0].descriptorCount = m_MaxTextures;
     bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    // binding 1 → normal
+    // binding 1 → material table
     bindings[1].binding = 1;
-    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     bindings[1].descriptorCount = 1;
     bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    VkDescriptorSetLayoutCreateInfo info{};
-    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    info.bindingCount = 2;
-    info.pBindings = bindings;
+    // Texture slots are written while frames using the set are in flight
+    // (only slots no recorded draw can reach yet)
+    std::vector<VkDescriptorBindingFlags> bindingFlags = {
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+        VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT,
+        0
+    };
+
+    // Shared through the state cache: every lit pipeline layout uses it as set 1
+    m_Layout = m_Device->GetStateCache()->GetSetLayout(
+        bindings, VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT, bindingFlags);
+}
+
+void VulkanMaterialDescriptors::CreateMaterialBuffer()
+{
+    const VkDeviceSize size = VkDeviceSize(m_MaxMaterials) * sizeof(GpuMaterialData);
+
+    // Written once per material, never moved: new entries land past what
+    // recorded draws index
+    m_Device->CreateBuffer(
+        size,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        m_MaterialBuffer,
+        m_MaterialMemory
+    );
+
+    if (vkMapMemory(m_Device->GetHandle(), m_MaterialMemory, 0, size, 0, &m_MaterialMapped) != VK_SUCCESS)
+        throw std::runtime_error("VulkanMaterialDescriptors: failed to map material buffer");
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = m_MaterialBuffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = size;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_Set;
+    write.dstBinding = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.descriptorCount = 1;
+    write.pBufferInfo = &bufferInfo;
+
+    vkUpdateDescriptorSets(m_Device->GetHandle(), 1, &write, 0, nullptr);
+}
+
+uint32_t VulkanMaterialDescriptors::AddTexture(VkImageView view, VkSampler sampler)
+{
+    auto it = m_TextureSlots.find(view);
+    if (it != m_TextureSlots.end())
+        return it->second;
+
+    if (m_TextureCount == m_MaxTextures)
+        throw std::runtime_error("VulkanMaterialDescriptors: texture array is full (" + std::to_string(m_MaxTextures) + ")");
+
+    const uint32_t slot = m_TextureCount++;
+    m_TextureSlots.emplace(view, slot);
+
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = view;
+    imageInfo.sampler = sampler;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_Set;
+    write.dstBinding = 0;
+    write.dstArrayElement = slot;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.descriptorCount = 1;
+    write.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(m_Device->GetHandle(), 1, &write, 0, nullptr);
+    return slot;
+}
+
+uint32_t VulkanMaterialDescriptors::AddMaterial(const GpuMaterialData& material)
+{
+    if (m_MaterialCount == m_MaxMaterials)
+        throw std::runtime_error("VulkanMaterialDescriptors: material buffer is full (" + std::to_string(m_MaxMaterials) + ")");
 
-    VK_CHECK(vkCreateDescriptorSetLayout(device, &info, nullptr, &m_Layout));
+    const uint32_t index = m_MaterialCount++;
+    std::memcpy(static_cast<GpuMaterialData*>(m_MaterialMapped) + index, &material, sizeof(GpuMaterialData));
+    return index;
 }
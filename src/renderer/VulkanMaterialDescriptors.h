@@ -1,24 +1,63 @@
 #pragma once
 #include <vulkan/vulkan.h>
+#include <unordered_map>
 #include <vector>
 #include <cstdint>
 
 class VulkanDevice;
 
+// std430 mirror of MaterialData in lighting.frag / depth_alpha.frag (16 bytes)
+struct GpuMaterialData
+{
+    uint32_t albedoIndex = 0; // slots of the texture array
+    uint32_t normalIndex = 0;
+    uint32_t padding[2] = {};
+};
+
+// Bindless material table, set 1 of the lit pipelines. One set for every
+// material, bound once per pipeline:
+//  - binding 0: sampler2D array of all material textures (UPDATE_AFTER_BIND +
+//    PARTIALLY_BOUND: slots are filled as textures arrive, the rest stay empty)
+//  - binding 1: GpuMaterialData per material, indexed by the draw's material
+//    index (firstInstance on the CPU path, GpuInstanceData::info.y on the GPU path)
+// New textures and materials only write unused slots, so they can be added
+// while earlier frames still read the set.
 class VulkanMaterialDescriptors
 {
 public:
+    // maxMaterials: material buffer capacity (host visible, 16 bytes each)
     VulkanMaterialDescriptors(VulkanDevice* device, uint32_t maxMaterials);
     ~VulkanMaterialDescriptors();
 
-    VkDescriptorPool GetPool() const { return m_Pool; }
+    // Array slot of view; a view already in the array keeps its slot
+    uint32_t AddTexture(VkImageView view, VkSampler sampler);
+
+    // Index of the new material
+    uint32_t AddMaterial(const GpuMaterialData& material);
+
     VkDescriptorSetLayout GetLayout() const { return m_Layout; }
+    VkDescriptorSet GetSet() const { return m_Set; }
+
+    uint32_t GetTextureCount() const { return m_TextureCount; }
+    uint32_t GetMaterialCount() const { return m_MaterialCount; }
 
 private:
     void CreateLayout();
+    void CreateMaterialBuffer();
 
 private:
     VulkanDevice* m_Device = nullptr;
     VkDescriptorPool m_Pool = VK_NULL_HANDLE;
-    VkDescriptorSetLayout m_Layout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout m_Layout = VK_NULL_HANDLE; // shared (state cache)
+    VkDescriptorSet m_Set = VK_NULL_HANDLE;
+
+    uint32_t m_MaxTextures = 0;
+    uint32_t m_TextureCount = 0;
+    std::unordered_map<VkImageView, uint32_t> m_TextureSlots;
+
+    VkBuffer       m_MaterialBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_MaterialMemory = VK_NULL_HANDLE;
+    void*          m_MaterialMapped = nullptr;
+    uint32_t       m_MaxMaterials = 0;
+    uint32_t       m_MaterialCount = 0;
 };
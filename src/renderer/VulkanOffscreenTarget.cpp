@@ -0,0 +1,184 @@
+#include "VulkanOffscreenTarget.h"
+#include "VulkanDevice.h"
+#include "VulkanProfiler.h"
+#include "../core/Logger.h"
+
+#include <stdexcept>
+#include <cstring>
+#include <utility>
+
+VulkanOffscreenTarget::VulkanOffscreenTarget(VulkanDevice* device, VkFormat format, VkExtent2D extent, uint32_t imageCount)
+    : m_Device(device), m_Format(format), m_Extent(extent)
+{
+    CreateImages(imageCount);
+    m_Staging.resize(imageCount);
+
+    LOG_INFO("Offscreen target created: " + std::to_string(extent.width) + "x" + std::to_string(extent.height) +
+        ", " + std::to_string(imageCount) + " images");
+}
+
+VulkanOffscreenTarget::~VulkanOffscreenTarget()
+{
+    VkDevice vkDevice = m_Device->GetHandle();
+
+    for (Staging& staging : m_Staging)
+    {
+        if (staging.mapped) vkUnmapMemory(vkDevice, staging.memory);
+        if (staging.buffer) vkDestroyBuffer(vkDevice, staging.buffer, nullptr);
+        if (staging.memory) vkFreeMemory(vkDevice, staging.memory, nullptr);
+    }
+
+    for (VkImageView view : m_ImageViews)
+        vkDestroyImageView(vkDevice, view, nullptr);
+    for (VkImage image : m_Images)
+        vkDestroyImage(vkDevice, image, nullptr);
+    for (VkDeviceMemory memory : m_Memories)
+        vkFreeMemory(vkDevice, memory, nullptr);
+}
+
+void VulkanOffscreenTarget::CreateImages(uint32_t imageCount)
+{
+    VkDevice vkDevice = m_Device->GetHandle();
+
+    m_Images.resize(imageCount, VK_NULL_HANDLE);
+    m_Memories.resize(imageCount, VK_NULL_HANDLE);
+    m_ImageViews.resize(imageCount, VK_NULL_HANDLE);
+
+    for (uint32_t i = 0; i < imageCount; i++)
+    {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent = { m_Extent.width, m_Extent.height, 1 };
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = m_Format;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateImage(vkDevice, &imageInfo, nullptr, &m_Images[i]) != VK_SUCCESS)
+            throw std::runtime_error("VulkanOffscreenTarget: failed to create color image");
+
+        VkMemoryRequirements memReq{};
+        vkGetImageMemoryRequirements(vkDevice, m_Images[i], &memReq);
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memReq.size;
+        allocInfo.memoryTypeIndex = m_Device->FindMemoryType(memReq.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        if (vkAllocateMemory(vkDevice, &allocInfo, nullptr, &m_Memories[i]) != VK_SUCCESS)
+            throw std::runtime_error("VulkanOffscreenTarget: failed to allocate color image memory");
+
+        vkBindImageMemory(vkDevice, m_Images[i], m_Memories[i], 0);
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = m_Images[i];
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = m_Format;
+        viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+        if (vkCreateImageView(vkDevice, &viewInfo, nullptr, &m_ImageViews[i]) != VK_SUCCESS)
+            throw std::runtime_error("VulkanOffscreenTarget: failed to create color image view");
+    }
+}
+
+void VulkanOffscreenTarget::CreateStaging(Staging& staging)
+{
+    const VkDeviceSize bytes = VkDeviceSize(m_Extent.width) * m_Extent.height * 4;
+
+    m_Device->CreateBuffer(
+        bytes,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        staging.buffer,
+        staging.memory
+    );
+    vkMapMemory(m_Device->GetHandle(), staging.memory, 0, bytes, 0, &staging.mapped);
+}
+
+void VulkanOffscreenTarget::RecordReadback(VkCommandBuffer cmd, uint32_t imageIndex)
+{
+    PROFILE_GPU_SCOPE(m_Device->GetProfiler(), cmd, "Readback");
+
+    Staging& staging = m_Staging[imageIndex];
+    if (!staging.buffer)
+        CreateStaging(staging);
+
+    // The pass already left the image in TRANSFER_SRC: only order the resolve
+    // writes before the copy
+    VkImageMemoryBarrier toCopy{};
+    toCopy.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toCopy.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    toCopy.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    toCopy.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toCopy.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toCopy.image = m_Images[imageIndex];
+    toCopy.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+    toCopy.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    toCopy.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0, nullptr,
+        0, nullptr,
+        1, &toCopy
+    );
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;   // tightly packed
+    region.bufferImageHeight = 0;
+    region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    region.imageOffset = { 0, 0, 0 };
+    region.imageExtent = { m_Extent.width, m_Extent.height, 1 };
+
+    vkCmdCopyImageToBuffer(cmd, m_Images[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, staging.buffer, 1, &region);
+
+    VkBufferMemoryBarrier toHost{};
+    toHost.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    toHost.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toHost.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    toHost.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toHost.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toHost.buffer = staging.buffer;
+    toHost.offset = 0;
+    toHost.size = VK_WHOLE_SIZE;
+
+    vkCmdPipelineBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        0, nullptr,
+        1, &toHost,
+        0, nullptr
+    );
+
+    staging.pending = true;
+}
+
+void VulkanOffscreenTarget::ReadPixels(uint32_t imageIndex, std::vector<uint8_t>& rgba)
+{
+    Staging& staging = m_Staging[imageIndex];
+
+    const size_t bytes = size_t(m_Extent.width) * m_Extent.height * 4;
+    rgba.resize(bytes);
+    std::memcpy(rgba.data(), staging.mapped, bytes);
+
+    // Stored as BGRA: swap to RGBA
+    if (m_Format == VK_FORMAT_B8G8R8A8_SRGB || m_Format == VK_FORMAT_B8G8R8A8_UNORM)
+    {
+        for (size_t i = 0; i < bytes; i += 4)
+            std::swap(rgba[i], rgba[i + 2]);
+    }
+
+    staging.pending = false;
+}
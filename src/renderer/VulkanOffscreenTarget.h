@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <cstdint>
+
+class VulkanDevice;
+
+// Stand-in for VulkanSwapchain when there is no window / surface (headless
+// runs, CI on lavapipe). Same getters, so framebuffers and passes are built
+// the same way. The render pass resolves into these 1x images and leaves them
+// in TRANSFER_SRC_OPTIMAL (see VulkanRenderPass resolveFinalLayout).
+//
+// Readback: RecordReadback() copies an image into its own host-visible
+// staging buffer in the frame's command buffer; once that submit completed,
+// ReadPixels() returns tightly packed RGBA8. Staging is allocated on first use.
+class VulkanOffscreenTarget
+{
+public:
+    VulkanOffscreenTarget(VulkanDevice* device, VkFormat format, VkExtent2D extent, uint32_t imageCount);
+    ~VulkanOffscreenTarget();
+
+    VkFormat GetImageFormat() const { return m_Format; }
+    VkExtent2D GetExtent() const { return m_Extent; }
+    const std::vector<VkImageView>& GetImageViews() const { return m_ImageViews; }
+    uint32_t GetImageCount() const { return static_cast<uint32_t>(m_Images.size()); }
+
+    // After the render pass that resolved into imageIndex
+    void RecordReadback(VkCommandBuffer cmd, uint32_t imageIndex);
+
+    bool IsReadbackPending(uint32_t imageIndex) const { return m_Staging[imageIndex].pending; }
+
+    // The submit that recorded the readback must have completed
+    void ReadPixels(uint32_t imageIndex, std::vector<uint8_t>& rgba);
+
+private:
+    struct Staging
+    {
+        VkBuffer       buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        void*          mapped = nullptr;
+        bool           pending = false;
+    };
+
+    void CreateImages(uint32_t imageCount);
+    void CreateStaging(Staging& staging);
+
+private:
+    VulkanDevice* m_Device = nullptr;
+
+    VkFormat   m_Format = VK_FORMAT_UNDEFINED;
+    VkExtent2D m_Extent{};
+
+    std::vector<VkImage>        m_Images;
+    std::vector<VkDeviceMemory> m_Memories;
+    std::vector<VkImageView>    m_ImageViews;
+
+    std::vector<Staging> m_Staging; // per image
+};
@@ -0,0 +1,298 @@
+#include "VulkanProfiler.h"
+#include "VulkanDevice.h"
+#include "VulkanTimeline.h"
+#include "../core/Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+static int64_t SteadyNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::string JsonEscape(const char* s)
+{
+    std::string out;
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\')
+            out += '\\';
+        out += *s;
+    }
+    return out;
+}
+
+VulkanProfiler::VulkanProfiler(VulkanDevice* device, uint32_t framesInFlight, uint32_t maxScopesPerFrame)
+    : m_Device(device), m_MaxScopes(std::max(maxScopesPerFrame, 1u))
+{
+    m_StartTicks = SteadyNs();
+    m_MainThread = std::this_thread::get_id();
+    m_Slots.resize(framesInFlight);
+
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(m_Device->GetPhysicalDevice(), &props);
+    m_TimestampPeriod = props.limits.timestampPeriod;
+
+    m_TimestampMask = GetTimestampMask(m_Device);
+    const bool hostReset = m_Device->GetEnabledFeatures12().hostQueryReset == VK_TRUE;
+
+    if (m_TimestampMask == 0 || !hostReset)
+    {
+        LOG_WARN(m_TimestampMask == 0
+            ? "Profiler: graphics queue has no timestamps, CPU zones only"
+            : "Profiler: hostQueryReset not supported, CPU zones only");
+        return;
+    }
+
+    VkQueryPoolCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    info.queryCount = 2 * m_MaxScopes * framesInFlight;
+
+    if (vkCreateQueryPool(m_Device->GetHandle(), &info, nullptr, &m_QueryPool) != VK_SUCCESS)
+        throw std::runtime_error("VulkanProfiler: failed to create timestamp query pool");
+
+    vkResetQueryPool(m_Device->GetHandle(), m_QueryPool, 0, info.queryCount);
+    m_GpuSupported = true;
+}
+
+VulkanProfiler::~VulkanProfiler()
+{
+    if (m_QueryPool)
+        vkDestroyQueryPool(m_Device->GetHandle(), m_QueryPool, nullptr);
+}
+
+int64_t VulkanProfiler::NowNs() const
+{
+    return SteadyNs() - m_StartTicks;
+}
+
+// --- GPU scopes ---
+
+void VulkanProfiler::BeginFrame(uint32_t frameIndex)
+{
+    m_CurrentSlot = frameIndex;
+
+    // Not pending: scopes recorded before the first frame (uploads) stay in
+    // the slot and resolve with it
+    if (m_Slots[frameIndex].pending)
+        Resolve(frameIndex);
+}
+
+void VulkanProfiler::EndFrame()
+{
+    Slot& slot = m_Slots[m_CurrentSlot];
+    slot.timelineValue = m_Device->GetTimeline()->GetSubmittedValue();
+    slot.pending = true;
+}
+
+uint32_t VulkanProfiler::BeginGpuScope(VkCommandBuffer cmd, const char* name)
+{
+    if (!m_GpuSupported)
+        return UINT32_MAX;
+
+    Slot& slot = m_Slots[m_CurrentSlot];
+    if (slot.scopes.size() >= m_MaxScopes)
+    {
+        if (!m_DroppedScopes)
+            LOG_WARN("Profiler: more than " + std::to_string(m_MaxScopes) + " GPU scopes in a frame, extra scopes dropped");
+        m_DroppedScopes = true;
+        return UINT32_MAX;
+    }
+
+    const uint32_t scope = static_cast<uint32_t>(slot.scopes.size());
+    slot.scopes.push_back({ name, NowNs() });
+
+    const uint32_t query = 2 * (m_CurrentSlot * m_MaxScopes + scope);
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_QueryPool, query);
+
+    return scope;
+}
+
+void VulkanProfiler::EndGpuScope(VkCommandBuffer cmd, uint32_t scope)
+{
+    if (scope == UINT32_MAX)
+        return;
+
+    const uint32_t query = 2 * (m_CurrentSlot * m_MaxScopes + scope) + 1;
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_QueryPool, query);
+}
+
+void VulkanProfiler::Resolve(uint32_t slotIndex)
+{
+    Slot& slot = m_Slots[slotIndex];
+    slot.pending = false;
+
+    if (slot.scopes.empty())
+        return;
+
+    // Already passed after the frame wait; only ever waits in Flush()
+    m_Device->GetTimeline()->Wait(slot.timelineValue);
+
+    const uint32_t first = 2 * slotIndex * m_MaxScopes;
+    const uint32_t count = 2 * static_cast<uint32_t>(slot.scopes.size());
+
+    // value + availability per query: scopes in command buffers that were
+    // never submitted are skipped instead of waited on
+    std::vector<uint64_t> results(size_t(count) * 2);
+    VkResult result = vkGetQueryPoolResults(
+        m_Device->GetHandle(),
+        m_QueryPool,
+        first,
+        count,
+        results.size() * sizeof(uint64_t),
+        results.data(),
+        2 * sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+    if (result == VK_SUCCESS || result == VK_NOT_READY)
+    {
+        std::lock_guard<std::mutex> lock(m_EventMutex);
+
+        for (size_t i = 0; i < slot.scopes.size(); i++)
+        {
+            const uint64_t* begin = &results[4 * i];
+            const uint64_t* end = &results[4 * i + 2];
+            if (!begin[1] || !end[1])
+                continue;
+
+            const uint64_t beginTicks = begin[0] & m_TimestampMask;
+            const uint64_t ticks = TimestampDelta(begin[0], end[0], m_TimestampMask);
+
+            Event event;
+            event.name = slot.scopes[i].name;
+            event.beginNs = static_cast<int64_t>(double(beginTicks) * m_TimestampPeriod);
+            event.endNs = event.beginNs + static_cast<int64_t>(double(ticks) * m_TimestampPeriod);
+            event.track = GPU_TRACK;
+
+            m_GpuToCpuOffset = std::max(m_GpuToCpuOffset, slot.scopes[i].recordNs - event.beginNs);
+            PushEvent(event);
+        }
+    }
+
+    vkResetQueryPool(m_Device->GetHandle(), m_QueryPool, first, count);
+    slot.scopes.clear();
+}
+
+void VulkanProfiler::Flush()
+{
+    const uint64_t submitted = m_Device->GetTimeline()->GetSubmittedValue();
+
+    for (uint32_t i = 0; i < m_Slots.size(); i++)
+    {
+        m_Slots[i].timelineValue = std::max(m_Slots[i].timelineValue, submitted);
+        Resolve(i);
+    }
+}
+
+// --- CPU zones ---
+
+void VulkanProfiler::AddCpuZone(const char* name, int64_t beginNs, int64_t endNs)
+{
+    std::lock_guard<std::mutex> lock(m_EventMutex);
+
+    Event event;
+    event.name = name;
+    event.beginNs = beginNs;
+    event.endNs = endNs;
+    event.track = ThreadTrack();
+    PushEvent(event);
+}
+
+uint32_t VulkanProfiler::ThreadTrack()
+{
+    const std::thread::id id = std::this_thread::get_id();
+
+    for (uint32_t i = 0; i < m_Threads.size(); i++)
+    {
+        if (m_Threads[i] == id)
+            return i;
+    }
+
+    m_Threads.push_back(id);
+    return static_cast<uint32_t>(m_Threads.size() - 1);
+}
+
+void VulkanProfiler::PushEvent(const Event& event)
+{
+    if (m_Events.size() >= MAX_EVENTS)
+    {
+        m_EventsFull = true;
+        return;
+    }
+
+    m_Events.push_back(event);
+}
+
+// --- Export ---
+
+bool VulkanProfiler::ExportChromeTrace(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_EventMutex);
+
+    std::ofstream file(path);
+    if (!file)
+    {
+        LOG_ERROR("Profiler: cannot write " + path);
+        return false;
+    }
+
+    const int64_t gpuOffset = m_GpuToCpuOffset == INT64_MIN ? 0 : m_GpuToCpuOffset;
+
+    // tid 0 = GPU queue, CPU threads from 1 in first-seen order
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"VXR_Engine\"}},\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU (graphics queue)\"}}";
+
+    for (uint32_t i = 0; i < m_Threads.size(); i++)
+    {
+        file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i + 1
+            << ",\"args\":{\"name\":\"" << (m_Threads[i] == m_MainThread ? "CPU main" : "CPU worker " + std::to_string(i)) << "\"}}";
+    }
+
+    char ts[64];
+    for (const Event& event : m_Events)
+    {
+        const bool gpu = event.track == GPU_TRACK;
+        const int64_t beginNs = gpu ? event.beginNs + gpuOffset : event.beginNs;
+
+        std::snprintf(ts, sizeof(ts), "\"ts\":%.3f,\"dur\":%.3f",
+            double(beginNs) * 1.0e-3, double(event.endNs - event.beginNs) * 1.0e-3);
+
+        file << ",\n{\"name\":\"" << JsonEscape(event.name) << "\",\"cat\":\"" << (gpu ? "gpu" : "cpu")
+            << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (gpu ? 0 : event.track + 1) << "," << ts << "}";
+    }
+
+    file << "\n]}\n";
+
+    if (m_EventsFull)
+        LOG_WARN("Profiler: event buffer filled up, the trace is truncated");
+
+    LOG_INFO("Profiler: " + std::to_string(m_Events.size()) + " events written to " + path);
+    return file.good();
+}
+
+uint64_t VulkanProfiler::GetTimestampMask(VulkanDevice* device)
+{
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device->GetPhysicalDevice(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(device->GetPhysicalDevice(), &familyCount, families.data());
+
+    const uint32_t validBits = families[device->GetGraphicsQueueFamilyIndex()].timestampValidBits;
+    if (validBits == 0)
+        return 0;
+
+    return validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+}
+
+uint64_t VulkanProfiler::TimestampDelta(uint64_t begin, uint64_t end, uint64_t mask)
+{
+    // Unsigned wrap-around, then back into the valid bits
+    return ((end & mask) - (begin & mask)) & mask;
+}
@@ -0,0 +1,181 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <cstdint>
+
+class VulkanDevice;
+
+// Scoped profiling macros. Build with VXR_PROFILE=0 (CMake: -DVXR_ENABLE_PROFILER=OFF)
+// and they compile to nothing, arguments included. At runtime they are no-ops
+// while the profiler pointer is null (no --profile).
+#ifndef VXR_PROFILE
+#define VXR_PROFILE 1
+#endif
+
+// GPU timestamps + CPU zones on one timeline, exported as Chrome trace JSON
+// (chrome://tracing, ui.perfetto.dev).
+//  - GPU: each frame slot owns a range of a timestamp query pool. Scopes
+//    written during a frame are read back when the slot comes around again
+//    (its timeline value has passed), so nothing stalls. Slots are reset on
+//    the host (hostQueryReset), so upload command buffers can carry scopes too.
+//  - CPU: zones are steady-clock intervals, from any thread.
+//  - GPU times are moved onto the CPU clock with the tightest lower bound
+//    seen ("work cannot start before it was recorded"); without calibrated
+//    timestamps, GPU events may sit slightly late relative to CPU zones.
+// Scope names must outlive the profiler (string literals).
+class VulkanProfiler
+{
+public:
+    VulkanProfiler(VulkanDevice* device, uint32_t framesInFlight, uint32_t maxScopesPerFrame = 256);
+    ~VulkanProfiler();
+
+    bool IsGpuSupported() const { return m_GpuSupported; }
+
+    // After the slot's frame wait: reads the slot's scopes back, then resets it
+    void BeginFrame(uint32_t frameIndex);
+
+    // After the frame's submit: the slot resolves once that submit completes
+    void EndFrame();
+
+    // Recording thread only. Returns UINT32_MAX when the slot is full (dropped).
+    uint32_t BeginGpuScope(VkCommandBuffer cmd, const char* name);
+    void     EndGpuScope(VkCommandBuffer cmd, uint32_t scope);
+
+    // CPU clock, ns since the profiler was created
+    int64_t NowNs() const;
+
+    // Thread-safe
+    void AddCpuZone(const char* name, int64_t beginNs, int64_t endNs);
+
+    // After vkDeviceWaitIdle: resolves every pending slot
+    void Flush();
+
+    bool ExportChromeTrace(const std::string& path);
+
+    // --- Timestamp helpers (also used by the benchmarks) ---
+    // Valid bits of the graphics queue's timestamps as a mask; 0: no timestamps
+    static uint64_t GetTimestampMask(VulkanDevice* device);
+
+    // end - begin in ticks, both masked to the valid bits; the counter may
+    // have wrapped once in between
+    static uint64_t TimestampDelta(uint64_t begin, uint64_t end, uint64_t mask);
+
+private:
+    struct Scope
+    {
+        const char* name = nullptr;
+        int64_t recordNs = 0; // CPU time the begin timestamp was recorded
+    };
+
+    struct Slot
+    {
+        std::vector<Scope> scopes;
+        uint64_t timelineValue = 0;
+        bool pending = false;
+    };
+
+    struct Event
+    {
+        const char* name = nullptr;
+        int64_t beginNs = 0;
+        int64_t endNs = 0;
+        uint32_t track = 0; // GPU_TRACK, otherwise CPU thread index
+    };
+
+    static constexpr uint32_t GPU_TRACK = UINT32_MAX;
+    static constexpr size_t   MAX_EVENTS = 1u << 21;
+
+    void Resolve(uint32_t slotIndex);
+    void PushEvent(const Event& event); // m_EventMutex held
+    uint32_t ThreadTrack();             // m_EventMutex held
+
+private:
+    VulkanDevice* m_Device = nullptr;
+    uint32_t m_MaxScopes = 0;
+
+    VkQueryPool m_QueryPool = VK_NULL_HANDLE; // 2 timestamps per scope, m_MaxScopes per slot
+    double   m_TimestampPeriod = 1.0;         // ns per tick
+    uint64_t m_TimestampMask = ~0ull;
+    bool     m_GpuSupported = false;
+
+    std::vector<Slot> m_Slots;
+    uint32_t m_CurrentSlot = 0;
+    bool m_DroppedScopes = false;
+
+    // GPU ns -> CPU ns: max over (recordNs - gpuBeginNs)
+    int64_t m_GpuToCpuOffset = INT64_MIN;
+
+    int64_t m_StartTicks = 0; // steady clock epoch
+
+    std::mutex m_EventMutex;
+    std::vector<Event> m_Events;
+    std::vector<std::thread::id> m_Threads; // index = CPU track
+    std::thread::id m_MainThread;           // creating thread, named in the trace
+    bool m_EventsFull = false;
+};
+
+// RAII helpers behind the macros; null profiler = no-op
+class GpuProfileScope
+{
+public:
+    GpuProfileScope(VulkanProfiler* profiler, VkCommandBuffer cmd, const char* name)
+        : m_Profiler(profiler), m_Cmd(cmd)
+    {
+        if (m_Profiler)
+            m_Scope = m_Profiler->BeginGpuScope(cmd, name);
+    }
+
+    ~GpuProfileScope()
+    {
+        if (m_Profiler)
+            m_Profiler->EndGpuScope(m_Cmd, m_Scope);
+    }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    VulkanProfiler* m_Profiler = nullptr;
+    VkCommandBuffer m_Cmd = VK_NULL_HANDLE;
+    uint32_t m_Scope = UINT32_MAX;
+};
+
+class CpuProfileZone
+{
+public:
+    CpuProfileZone(VulkanProfiler* profiler, const char* name)
+        : m_Profiler(profiler), m_Name(name)
+    {
+        if (m_Profiler)
+            m_BeginNs = m_Profiler->NowNs();
+    }
+
+    ~CpuProfileZone()
+    {
+        if (m_Profiler)
+            m_Profiler->AddCpuZone(m_Name, m_BeginNs, m_Profiler->NowNs());
+    }
+
+    CpuProfileZone(const CpuProfileZone&) = delete;
+    CpuProfileZone& operator=(const CpuProfileZone&) = delete;
+
+private:
+    VulkanProfiler* m_Profiler = nullptr;
+    const char* m_Name = nullptr;
+    int64_t m_BeginNs = 0;
+};
+
+#define VXR_PROFILE_CONCAT_INNER(a, b) a##b
+#define VXR_PROFILE_CONCAT(a, b) VXR_PROFILE_CONCAT_INNER(a, b)
+
+#if VXR_PROFILE
+#define PROFILE_GPU_SCOPE(profiler, cmd, name) GpuProfileScope VXR_PROFILE_CONCAT(gpuScope_, __LINE__)(profiler, cmd, name)
+#define PROFILE_CPU_ZONE(profiler, name) CpuProfileZone VXR_PROFILE_CONCAT(cpuZone_, __LINE__)(profiler, name)
+#else
+#define PROFILE_GPU_SCOPE(profiler, cmd, name) ((void)0)
+#define PROFILE_CPU_ZONE(profiler, name) ((void)0)
+#endif
@@ -4,10 +4,24 @@
 
 class VulkanDevice;
 
+// Clear: first pass of the frame.
+// Load:  continues a previous pass (e.g. late occlusion-culled draws); same
+//        attachments, so it is framebuffer-compatible with the Clear pass.
+enum class RenderPassLoad
+{
+    Clear,
+    Load
+};
+
 class VulkanRenderPass
 {
 public:
-    VulkanRenderPass(VulkanDevice* device, VkFormat colorFormat, VkFormat depthFormat);
+    // resolveFinalLayout: PRESENT_SRC for the swapchain, TRANSFER_SRC for
+    // offscreen targets that are read back. Passes that differ only in it
+    // stay compatible.
+    VulkanRenderPass(VulkanDevice* device, VkFormat colorFormat, VkFormat depthFormat,
+        RenderPassLoad load = RenderPassLoad::Clear,
+        VkImageLayout resolveFinalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
     ~VulkanRenderPass();
 
     VkRenderPass GetHandle() const { return m_RenderPass; }
@@ -0,0 +1,159 @@
+#include "VulkanSecondaryCommandBuffers.h"
+#include "VulkanDevice.h"
+#include "core/ThreadPool.h"
+#include "core/Logger.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+VulkanSecondaryCommandBuffers::VulkanSecondaryCommandBuffers(
+    VulkanDevice* device,
+    ThreadPool* pool,
+    uint32_t framesInFlight)
+    : m_Device(device), m_Pool(pool)
+{
+    const uint32_t threadCount = m_Pool ? m_Pool->GetThreadCount() : 1;
+
+    m_Pools.resize(framesInFlight);
+
+    for (std::vector<ThreadCommandPool>& framePools : m_Pools)
+    {
+        framePools.resize(threadCount);
+
+        for (ThreadCommandPool& threadPool : framePools)
+        {
+            VkCommandPoolCreateInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            info.queueFamilyIndex = m_Device->GetGraphicsQueueFamilyIndex();
+            info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+            if (vkCreateCommandPool(m_Device->GetHandle(), &info, nullptr, &threadPool.pool) != VK_SUCCESS)
+                throw std::runtime_error("VulkanSecondaryCommandBuffers: failed to create command pool");
+        }
+    }
+
+    LOG_INFO("Secondary command recording: " + std::to_string(threadCount) + " thread(s) x " +
+        std::to_string(framesInFlight) + " frame(s)");
+}
+
+VulkanSecondaryCommandBuffers::~VulkanSecondaryCommandBuffers()
+{
+    VkDevice device = m_Device->GetHandle();
+
+    // Destroying a pool frees its buffers
+    for (std::vector<ThreadCommandPool>& framePools : m_Pools)
+    {
+        for (ThreadCommandPool& threadPool : framePools)
+        {
+            if (threadPool.pool)
+                vkDestroyCommandPool(device, threadPool.pool, nullptr);
+        }
+    }
+}
+
+void VulkanSecondaryCommandBuffers::BeginFrame(uint32_t frameIndex)
+{
+    for (ThreadCommandPool& threadPool : m_Pools[frameIndex])
+    {
+        vkResetCommandPool(m_Device->GetHandle(), threadPool.pool, 0);
+        threadPool.used = 0;
+    }
+}
+
+VkCommandBuffer VulkanSecondaryCommandBuffers::Acquire(ThreadCommandPool& threadPool)
+{
+    if (threadPool.used == threadPool.buffers.size())
+    {
+        VkCommandBufferAllocateInfo alloc{};
+        alloc.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        alloc.commandPool = threadPool.pool;
+        alloc.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        alloc.commandBufferCount = 1;
+
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        if (vkAllocateCommandBuffers(m_Device->GetHandle(), &alloc, &cmd) != VK_SUCCESS)
+            return VK_NULL_HANDLE;
+
+        threadPool.buffers.push_back(cmd);
+    }
+
+    return threadPool.buffers[threadPool.used++];
+}
+
+const std::vector<VkCommandBuffer>& VulkanSecondaryCommandBuffers::Record(
+    uint32_t frameIndex,
+    VkRenderPass renderPass,
+    uint32_t subpass,
+    VkFramebuffer framebuffer,
+    uint32_t itemCount,
+    const std::function<void(VkCommandBuffer, uint32_t, uint32_t)>& record)
+{
+    m_Recorded.clear();
+    if (itemCount == 0)
+        return m_Recorded;
+
+    std::vector<ThreadCommandPool>& framePools = m_Pools[frameIndex];
+    const uint32_t threadCount = (uint32_t)framePools.size();
+
+    // One chunk per thread unless the chunks would get too small
+    const uint32_t maxChunks = (itemCount + MIN_ITEMS_PER_CHUNK - 1) / MIN_ITEMS_PER_CHUNK;
+    const uint32_t chunkCount = std::max(1u, std::min(threadCount, maxChunks));
+    const uint32_t chunkSize = (itemCount + chunkCount - 1) / chunkCount;
+
+    m_Recorded.resize(chunkCount, VK_NULL_HANDLE);
+
+    VkCommandBufferInheritanceInfo inheritance{};
+    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.renderPass = renderPass;
+    inheritance.subpass = subpass;
+    inheritance.framebuffer = framebuffer;
+    inheritance.pipelineStatistics = m_InheritedStatistics;
+
+    auto recordChunk = [&](uint32_t chunk, uint32_t thread)
+    {
+        const uint32_t begin = chunk * chunkSize;
+        const uint32_t end = std::min(itemCount, begin + chunkSize);
+
+        VkCommandBuffer cmd = Acquire(framePools[thread]);
+        if (cmd == VK_NULL_HANDLE)
+        {
+            LOG_ERROR("VulkanSecondaryCommandBuffers: failed to allocate command buffer");
+            return;
+        }
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags =
+            VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+            VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        beginInfo.pInheritanceInfo = &inheritance;
+
+        if (vkBeginCommandBuffer(cmd, &beginInfo) != VK_SUCCESS)
+        {
+            LOG_ERROR("VulkanSecondaryCommandBuffers: failed to begin command buffer");
+            return;
+        }
+
+        record(cmd, begin, end);
+
+        if (vkEndCommandBuffer(cmd) != VK_SUCCESS)
+        {
+            LOG_ERROR("VulkanSecondaryCommandBuffers: failed to record command buffer");
+            return;
+        }
+
+        m_Recorded[chunk] = cmd;
+    };
+
+    if (m_Pool && chunkCount > 1)
+        m_Pool->ParallelFor(chunkCount, recordChunk);
+    else
+        recordChunk(0, 0);
+
+    // Drop chunks that failed so the primary never executes a bad buffer
+    m_Recorded.erase(
+        std::remove(m_Recorded.begin(), m_Recorded.end(), VK_NULL_HANDLE),
+        m_Recorded.end());
+
+    return m_Recorded;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+class VulkanDevice;
+class ThreadPool;
+
+// Parallel draw recording into secondary command buffers.
+// Each (frame in flight, thread) pair owns a transient VkCommandPool, so
+// threads never share a pool and a frame's pools are reset in one call once
+// its frame has completed on the timeline. Buffers are allocated on first use and reused.
+class VulkanSecondaryCommandBuffers
+{
+public:
+    // Draws per buffer below which splitting further is not worth it
+    static constexpr uint32_t MIN_ITEMS_PER_CHUNK = 64;
+
+    // pool may be null (records on the calling thread)
+    VulkanSecondaryCommandBuffers(VulkanDevice* device, ThreadPool* pool, uint32_t framesInFlight);
+    ~VulkanSecondaryCommandBuffers();
+
+    // Resets this frame's pools. The frame slot must have been waited on (VulkanSync::WaitForFrame).
+    void BeginFrame(uint32_t frameIndex);
+
+    // Splits [0, itemCount) into contiguous chunks, one secondary buffer each,
+    // and calls record(cmd, begin, end) on the pool's threads. Buffers continue
+    // renderPass / subpass; viewport, scissor and bindings are not inherited
+    // from the primary, so record() must set them.
+    // Returns the buffers in item order for vkCmdExecuteCommands (valid until
+    // the next call).
+    // Pipeline statistics the primary has active around vkCmdExecuteCommands
+    // (needs inheritedQueries). 0: no query may be active.
+    void SetInheritedPipelineStatistics(VkQueryPipelineStatisticFlags flags) { m_InheritedStatistics = flags; }
+
+    const std::vector<VkCommandBuffer>& Record(
+        uint32_t frameIndex,
+        VkRenderPass renderPass,
+        uint32_t subpass,
+        VkFramebuffer framebuffer,
+        uint32_t itemCount,
+        const std::function<void(VkCommandBuffer, uint32_t, uint32_t)>& record);
+
+private:
+    struct ThreadCommandPool
+    {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> buffers;
+        uint32_t used = 0;
+    };
+
+    VkCommandBuffer Acquire(ThreadCommandPool& threadPool);
+
+private:
+    VulkanDevice* m_Device = nullptr;
+    ThreadPool* m_Pool = nullptr;
+
+    std::vector<std::vector<ThreadCommandPool>> m_Pools; // [frame][thread]
+    std::vector<VkCommandBuffer> m_Recorded;
+    VkQueryPipelineStatisticFlags m_InheritedStatistics = 0;
+};
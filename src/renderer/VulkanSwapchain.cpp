@@ -4,12 +4,13 @@
 
 #include <algorithm>
 
-VulkanSwapchain::VulkanSwapchain(VkInstance instance, VulkanDevice* device, VkSurfaceKHR surface, uint32_t width, uint32_t height)
+VulkanSwapchain::VulkanSwapchain(VkInstance instance, VulkanDevice* device, VkSurfaceKHR surface, uint32_t width, uint32_t height,
+    VkSwapchainKHR oldSwapchain)
     : m_Device(device), m_Surface(surface)
 {
     LOG_INFO("Creating Vulkan Swapchain...");
 
-    CreateSwapchain(width, height);
+    CreateSwapchain(width, height, oldSwapchain);
     CreateImageViews();
 
     LOG_INFO("Swapchain successfully created!");
@@ -23,7 +24,7 @@ VulkanSwapchain::~VulkanSwapchain()
     vkDestroySwapchainKHR(m_Device->GetHandle(), m_Swapchain, nullptr);
 }
 
-void VulkanSwapchain::CreateSwapchain(uint32_t width, uint32_t height)
+void VulkanSwapchain::CreateSwapchain(uint32_t width, uint32_t height, VkSwapchainKHR oldSwapchain)
 {
     VkPhysicalDevice physical = m_Device->GetPhysicalDevice();
 
@@ -78,6 +79,7 @@ void VulkanSwapchain::CreateSwapchain(uint32_t width, uint32_t height)
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     createInfo.presentMode = presentMode;
     createInfo.clipped = VK_TRUE;
+    createInfo.oldSwapchain = oldSwapchain;
 
     if (vkCreateSwapchainKHR(m_Device->GetHandle(), &createInfo, nullptr, &m_Swapchain) != VK_SUCCESS) {
         LOG_ERROR("Failed to create swapchain!");
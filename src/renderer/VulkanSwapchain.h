@@ -8,13 +8,17 @@ class VulkanDevice;
 class VulkanSwapchain
 {
 public:
-    VulkanSwapchain(VkInstance instance, VulkanDevice* device, VkSurfaceKHR surface, uint32_t width, uint32_t height);
+    // oldSwapchain: the swapchain being replaced on resize. Its presentable
+    // images can be handed over; the caller still destroys it (once retired).
+    VulkanSwapchain(VkInstance instance, VulkanDevice* device, VkSurfaceKHR surface, uint32_t width, uint32_t height,
+        VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
     ~VulkanSwapchain();
 
     VkSwapchainKHR GetHandle() const { return m_Swapchain; }
     VkFormat GetImageFormat() const { return m_ImageFormat; }
     VkExtent2D GetExtent() const { return m_Extent; }
     const std::vector<VkImageView>& GetImageViews() const { return m_ImageViews; }
+    uint32_t GetImageCount() const { return static_cast<uint32_t>(m_Images.size()); }
 
 private:
     VkSwapchainKHR m_Swapchain = VK_NULL_HANDLE;
@@ -28,7 +32,7 @@ private:
     VkExtent2D m_Extent;
 
 private:
-    void CreateSwapchain(uint32_t width, uint32_t height);
+    void CreateSwapchain(uint32_t width, uint32_t height, VkSwapchainKHR oldSwapchain);
     void CreateImageViews();
 
     VkSurfaceFormatKHR ChooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& formats);
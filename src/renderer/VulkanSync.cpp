@@ -1,40 +1,54 @@
 #include "VulkanSync.h"
 #include "VulkanDevice.h"
+#include "VulkanTimeline.h"
 #include "../core/Logger.h"
 
 VulkanSync::VulkanSync(VulkanDevice* device,
     uint32_t maxFramesInFlight,
     uint32_t swapchainImageCount)
     : m_Device(device),
+    m_Timeline(device->GetTimeline()),
     m_MaxFramesInFlight(maxFramesInFlight)
 {
     // Per-frame sync
     m_ImageAvailableSemaphores.resize(maxFramesInFlight);
-    m_InFlightFences.resize(maxFramesInFlight);
-
-    // Per-swapchain-image sync
-    m_RenderFinishedSemaphores.resize(swapchainImageCount);
+    m_FrameValues.resize(maxFramesInFlight, 0);
 
     VkSemaphoreCreateInfo semInfo{};
     semInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-    // Create per-frame semaphores + fences
+    // Create per-frame acquire semaphores
     for (uint32_t i = 0; i < maxFramesInFlight; i++)
     {
         if (vkCreateSemaphore(m_Device->GetHandle(), &semInfo, nullptr,
-            &m_ImageAvailableSemaphores[i]) != VK_SUCCESS ||
-            vkCreateFence(m_Device->GetHandle(), &fenceInfo, nullptr,
-                &m_InFlightFences[i]) != VK_SUCCESS)
+            &m_ImageAvailableSemaphores[i]) != VK_SUCCESS)
         {
             LOG_ERROR("Failed to create per-frame sync objects!");
         }
     }
 
-    // Create per-image render-finished semaphores
+    // Per-swapchain-image sync
+    CreateRenderFinishedSemaphores(swapchainImageCount);
+
+    LOG_INFO("VulkanSync created (timeline per-frame + per-image present sync).");
+}
+
+VulkanSync::~VulkanSync()
+{
+    for (auto s : m_ImageAvailableSemaphores)
+        vkDestroySemaphore(m_Device->GetHandle(), s, nullptr);
+
+    for (auto s : m_RenderFinishedSemaphores)
+        vkDestroySemaphore(m_Device->GetHandle(), s, nullptr);
+}
+
+void VulkanSync::CreateRenderFinishedSemaphores(uint32_t swapchainImageCount)
+{
+    m_RenderFinishedSemaphores.resize(swapchainImageCount);
+
+    VkSemaphoreCreateInfo semInfo{};
+    semInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
     for (uint32_t i = 0; i < swapchainImageCount; i++)
     {
         if (vkCreateSemaphore(m_Device->GetHandle(), &semInfo, nullptr,
@@ -43,30 +57,59 @@ VulkanSync::VulkanSync(VulkanDevice* device,
             LOG_ERROR("Failed to create render-finished semaphore!");
         }
     }
+}
+
+void VulkanSync::SetImageCount(uint32_t swapchainImageCount)
+{
+    // Pending presents of the old swapchain may still wait on these: same
+    // delay as the old swapchain (see Application::RecreateSwapchain)
+    const uint64_t retireAt = m_Timeline->GetSubmittedValue() + m_MaxFramesInFlight;
+
+    VkDevice device = m_Device->GetHandle();
+    std::vector<VkSemaphore> old = std::move(m_RenderFinishedSemaphores);
 
-    LOG_INFO("VulkanSync created (per-frame + per-image sync).");
+    m_Timeline->Retire(retireAt, [device, old]()
+        {
+            for (VkSemaphore s : old)
+                vkDestroySemaphore(device, s, nullptr);
+        });
+
+    m_RenderFinishedSemaphores.clear();
+    CreateRenderFinishedSemaphores(swapchainImageCount);
 }
 
-VulkanSync::~VulkanSync()
+void VulkanSync::WaitForFrame()
 {
-    for (auto s : m_ImageAvailableSemaphores)
-        vkDestroySemaphore(m_Device->GetHandle(), s, nullptr);
+    m_Timeline->Wait(m_FrameValues[m_CurrentFrame]);
+    m_Timeline->CollectRetired();
+}
 
-    for (auto s : m_RenderFinishedSemaphores)
-        vkDestroySemaphore(m_Device->GetHandle(), s, nullptr);
+uint64_t VulkanSync::SubmitFrame(VkCommandBuffer cmd, uint32_t imageIndex)
+{
+    SemaphoreWait acquired{};
+    acquired.semaphore = m_ImageAvailableSemaphores[m_CurrentFrame];
+    acquired.stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+    uint64_t value = m_Timeline->Submit(
+        { cmd },
+        { acquired },
+        { m_RenderFinishedSemaphores[imageIndex] });
 
-    for (auto f : m_InFlightFences)
-        vkDestroyFence(m_Device->GetHandle(), f, nullptr);
+    m_FrameValues[m_CurrentFrame] = value;
+    return value;
 }
 
-VkSemaphore& VulkanSync::GetImageAvailableSemaphore()
+uint64_t VulkanSync::SubmitFrame(VkCommandBuffer cmd)
 {
-    return m_ImageAvailableSemaphores[m_CurrentFrame];
+    uint64_t value = m_Timeline->Submit({ cmd });
+
+    m_FrameValues[m_CurrentFrame] = value;
+    return value;
 }
 
-VkFence& VulkanSync::GetInFlightFence()
+VkSemaphore& VulkanSync::GetImageAvailableSemaphore()
 {
-    return m_InFlightFences[m_CurrentFrame];
+    return m_ImageAvailableSemaphores[m_CurrentFrame];
 }
 
 VkSemaphore& VulkanSync::GetRenderFinishedSemaphore(uint32_t imageIndex)
@@ -1,9 +1,15 @@
 #pragma once
 #include <vulkan/vulkan.h>
 #include <vector>
+#include <cstdint>
 
 class VulkanDevice;
+class VulkanTimeline;
 
+// Frame pacing on the device timeline: each frame slot remembers the timeline
+// value its last submit signals, and waiting for the slot is a wait on that
+// value (no per-frame fences to reset). Binary semaphores remain only where
+// the swapchain requires them.
 class VulkanSync
 {
 public:
@@ -12,27 +18,48 @@ public:
         uint32_t swapchainImageCount);
     ~VulkanSync();
 
+    // Blocks until this slot's previous submit has completed, then runs due
+    // timeline retirements
+    void WaitForFrame();
+
+    // Submits this slot's commands: waits for the acquired image, signals the
+    // image's render-finished semaphore and the next timeline value
+    uint64_t SubmitFrame(VkCommandBuffer cmd, uint32_t imageIndex);
+
+    // Offscreen: nothing acquired to wait for, nothing to present
+    uint64_t SubmitFrame(VkCommandBuffer cmd);
+
     // Per-frame
     VkSemaphore& GetImageAvailableSemaphore();
-    VkFence& GetInFlightFence();
+    uint64_t GetFrameValue(uint32_t frameIndex) const { return m_FrameValues[frameIndex]; }
 
     uint32_t GetCurrentFrame() const { return m_CurrentFrame; }
+    uint32_t GetFramesInFlight() const { return m_MaxFramesInFlight; }
 
     // Per-swapchain-image
     VkSemaphore& GetRenderFinishedSemaphore(uint32_t imageIndex);
 
+    // Swapchain recreated: new render-finished semaphores. The old ones may
+    // still be waited on by pending presents; they are retired on the timeline
+    // once the frames in flight have gone around after the recreation.
+    void SetImageCount(uint32_t swapchainImageCount);
+
     void AdvanceFrame();
 
 
+private:
+    void CreateRenderFinishedSemaphores(uint32_t swapchainImageCount);
+
 private:
     VulkanDevice* m_Device = nullptr;
+    VulkanTimeline* m_Timeline = nullptr;
 
     uint32_t m_MaxFramesInFlight = 2;
     uint32_t m_CurrentFrame = 0;
 
     // Per-frame
     std::vector<VkSemaphore> m_ImageAvailableSemaphores;
-    std::vector<VkFence>     m_InFlightFences;
+    std::vector<uint64_t>    m_FrameValues; // 0 = never submitted
 
     // Per-image
     std::vector<VkSemaphore> m_RenderFinishedSemaphores;
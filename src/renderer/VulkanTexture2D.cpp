@@ -1,6 +1,9 @@
 #include "VulkanTexture2D.h"
 #include "VulkanDevice.h"
 #include "VulkanCommandPool.h"
+#include "VulkanTimeline.h"
+#include "VulkanProfiler.h"
+#include "VulkanFrameStats.h"
 #include "../core/Logger.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "third_party/stb_image.h"
@@ -47,15 +50,11 @@ static void CreateBuffer(
 }
 
 static void TransitionImageLayout(
-    VulkanDevice* device,
-    VulkanCommandPool* cmdPool,
+    VkCommandBuffer cmd,
     VkImage image,
-    VkFormat format,
     VkImageLayout oldLayout,
     VkImageLayout newLayout)
 {
-    VkCommandBuffer cmd = cmdPool->BeginSingleTimeCommands();
-
     VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
     barrier.oldLayout = oldLayout;
     barrier.newLayout = newLayout;
@@ -100,19 +99,15 @@ static void TransitionImageLayout(
         0, nullptr,
         1, &barrier
     );
-
-    cmdPool->EndSingleTimeCommands(cmd);
 }
 
 static void CopyBufferToImage(
-    VulkanCommandPool* cmdPool,
+    VkCommandBuffer cmd,
     VkBuffer buffer,
     VkImage image,
     uint32_t w,
     uint32_t h)
 {
-    VkCommandBuffer cmd = cmdPool->BeginSingleTimeCommands();
-
     VkBufferImageCopy region{};
     region.bufferOffset = 0;
     region.bufferRowLength = 0;
@@ -132,8 +127,6 @@ static void CopyBufferToImage(
         1,
         &region
     );
-
-    cmdPool->EndSingleTimeCommands(cmd);
 }
 
 VulkanTexture2D::VulkanTexture2D(
@@ -187,6 +180,14 @@ VulkanTexture2D::VulkanTexture2D(
     if (!pixels)
         throw std::runtime_error("Failed to load texture: " + filePath);
 
+    // Only a source alpha channel can make it transparent
+    if (channels == 4 || channels == 2)
+    {
+        const size_t texels = size_t(w) * size_t(h);
+        for (size_t i = 0; i < texels && !m_HasTransparency; i++)
+            m_HasTransparency = pixels[i * 4 + 3] < 255;
+    }
+
     CreateImage(w, h);
     Upload(pixels, w, h);
     CreateView();
@@ -242,8 +243,13 @@ void VulkanTexture2D::CreateImage(uint32_t w, uint32_t h)
 
 void VulkanTexture2D::Upload(const void* rgbaPixels, uint32_t w, uint32_t h)
 {
+    PROFILE_CPU_ZONE(m_Device->GetProfiler(), "Texture upload");
+
     VkDeviceSize size = VkDeviceSize(w) * VkDeviceSize(h) * 4;
 
+    if (VulkanFrameStats* stats = m_Device->GetFrameStats())
+        stats->CountUpload(size);
+
     VkBuffer staging = VK_NULL_HANDLE;
     VkDeviceMemory stagingMem = VK_NULL_HANDLE;
 
@@ -261,20 +267,35 @@ void VulkanTexture2D::Upload(const void* rgbaPixels, uint32_t w, uint32_t h)
     std::memcpy(mapped, rgbaPixels, (size_t)size);
     vkUnmapMemory(m_Device->GetHandle(), stagingMem);
 
-    TransitionImageLayout(
-        m_Device, m_CmdPool, m_Image, m_Format,
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    // One submit, no wait: later submits on the same queue are ordered after
+    // the final barrier, so the texture is ready by the time a frame samples it
+    VkCommandBuffer cmd = m_CmdPool->BeginSingleTimeCommands();
 
-    CopyBufferToImage(m_CmdPool, staging, m_Image, w, h);
+    {
+        PROFILE_GPU_SCOPE(m_Device->GetProfiler(), cmd, "Texture upload");
 
-    TransitionImageLayout(
-        m_Device, m_CmdPool, m_Image, m_Format,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        TransitionImageLayout(
+            cmd, m_Image,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        CopyBufferToImage(cmd, staging, m_Image, w, h);
+
+        TransitionImageLayout(
+            cmd, m_Image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    uint64_t uploaded = m_CmdPool->SubmitSingleTimeCommands(cmd);
 
-    vkDestroyBuffer(m_Device->GetHandle(), staging, nullptr);
-    vkFreeMemory(m_Device->GetHandle(), stagingMem, nullptr);
+    // Staging memory goes once the copy has executed
+    VkDevice device = m_Device->GetHandle();
+    m_Device->GetTimeline()->Retire(uploaded, [device, staging, stagingMem]()
+        {
+            vkDestroyBuffer(device, staging, nullptr);
+            vkFreeMemory(device, stagingMem, nullptr);
+        });
 }
 
 void VulkanTexture2D::CreateView()
@@ -27,6 +27,9 @@ public:
     VkImageView GetView() const { return m_View; }
     VkSampler   GetSampler() const { return m_Sampler; }
 
+    // Some texel has alpha < 255 (cutout candidates: alpha-tested permutation)
+    bool HasTransparency() const { return m_HasTransparency; }
+
 private:
     void CreateImage(uint32_t w, uint32_t h);
     void CreateView();
@@ -43,4 +46,5 @@ private:
     VkSampler      m_Sampler = VK_NULL_HANDLE;
 
     VkFormat m_Format = VK_FORMAT_R8G8B8A8_UNORM;
+    bool m_HasTransparency = false;
 };
@@ -0,0 +1,168 @@
+#include "VulkanTimeline.h"
+#include "VulkanDevice.h"
+#include "../core/Logger.h"
+
+#include <stdexcept>
+#include <iterator>
+
+VulkanTimeline::VulkanTimeline(VulkanDevice* device, VkQueue queue)
+    : m_Device(device), m_Queue(queue)
+{
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    info.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(m_Device->GetHandle(), &info, nullptr, &m_Semaphore) != VK_SUCCESS)
+        throw std::runtime_error("VulkanTimeline: failed to create timeline semaphore");
+}
+
+VulkanTimeline::~VulkanTimeline()
+{
+    if (!m_Semaphore)
+        return;
+
+    WaitIdle();
+
+    // Queue is drained: retirements keyed past the last submit are due too.
+    // One at a time: a callback may retire more (e.g. freeing descriptor sets).
+    while (!m_Retirements.empty())
+    {
+        std::function<void()> fn = std::move(m_Retirements.front().fn);
+        m_Retirements.pop_front();
+        fn();
+    }
+
+    vkDestroySemaphore(m_Device->GetHandle(), m_Semaphore, nullptr);
+}
+
+uint64_t VulkanTimeline::Submit(
+    const std::vector<VkCommandBuffer>& commandBuffers,
+    const std::vector<SemaphoreWait>& waits,
+    const std::vector<VkSemaphore>& signals)
+{
+    const uint64_t value = m_SubmittedValue + 1;
+
+    std::vector<VkSemaphore> waitSemaphores;
+    std::vector<uint64_t> waitValues;
+    std::vector<VkPipelineStageFlags> waitStages;
+
+    for (const SemaphoreWait& wait : waits)
+    {
+        waitSemaphores.push_back(wait.semaphore);
+        waitValues.push_back(wait.value);
+        waitStages.push_back(wait.stage);
+    }
+
+    // Timeline signal first, binary ones after (their values are ignored)
+    std::vector<VkSemaphore> signalSemaphores;
+    std::vector<uint64_t> signalValues;
+
+    signalSemaphores.push_back(m_Semaphore);
+    signalValues.push_back(value);
+
+    for (VkSemaphore semaphore : signals)
+    {
+        signalSemaphores.push_back(semaphore);
+        signalValues.push_back(0);
+    }
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+    timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+    submitInfo.pCommandBuffers = commandBuffers.data();
+    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+    submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+    if (vkQueueSubmit(m_Queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+        throw std::runtime_error("VulkanTimeline: queue submit failed");
+
+    m_SubmittedValue = value;
+    return value;
+}
+
+uint64_t VulkanTimeline::GetCompletedValue()
+{
+    uint64_t value = 0;
+    if (vkGetSemaphoreCounterValue(m_Device->GetHandle(), m_Semaphore, &value) == VK_SUCCESS)
+        m_CompletedValue = value;
+
+    return m_CompletedValue;
+}
+
+bool VulkanTimeline::IsComplete(uint64_t value)
+{
+    if (value <= m_CompletedValue)
+        return true;
+
+    return value <= GetCompletedValue();
+}
+
+bool VulkanTimeline::Wait(uint64_t value, uint64_t timeoutNs)
+{
+    if (value <= m_CompletedValue)
+        return true;
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &m_Semaphore;
+    waitInfo.pValues = &value;
+
+    VkResult result = vkWaitSemaphores(m_Device->GetHandle(), &waitInfo, timeoutNs);
+    if (result == VK_TIMEOUT)
+        return false;
+    if (result != VK_SUCCESS)
+        throw std::runtime_error("VulkanTimeline: semaphore wait failed");
+
+    if (value > m_CompletedValue)
+        m_CompletedValue = value;
+    return true;
+}
+
+void VulkanTimeline::Retire(uint64_t value, std::function<void()> fn)
+{
+    // Already passed: nothing can still be using it
+    if (value <= m_CompletedValue)
+    {
+        fn();
+        return;
+    }
+
+    // Usually the newest value: walk back from the end to keep value order
+    auto it = m_Retirements.end();
+    while (it != m_Retirements.begin() && std::prev(it)->value > value)
+        --it;
+
+    m_Retirements.insert(it, { value, std::move(fn) });
+}
+
+void VulkanTimeline::CollectRetired()
+{
+    if (m_Retirements.empty())
+        return;
+
+    const uint64_t completed = GetCompletedValue();
+
+    while (!m_Retirements.empty() && m_Retirements.front().value <= completed)
+    {
+        std::function<void()> fn = std::move(m_Retirements.front().fn);
+        m_Retirements.pop_front();
+        fn();
+    }
+}
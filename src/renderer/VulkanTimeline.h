@@ -0,0 +1,76 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <cstdint>
+
+class VulkanDevice;
+
+// Binary or timeline semaphore wait for a submit. value is ignored for
+// binary semaphores (e.g. swapchain acquire).
+struct SemaphoreWait
+{
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    uint64_t value = 0;
+    VkPipelineStageFlags stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+};
+
+// Timeline semaphore (Vulkan 1.2) owned by one queue. Every Submit() signals
+// the next value, so "value N has completed" means everything submitted up
+// to and including the Nth submit is done. Frame pacing, uploads and resource
+// retirement all key off this one counter instead of fences + queue idles.
+//  - other queues wait on a value with SemaphoreWait{ GetHandle(), value, stage }
+//    instead of an extra binary semaphore
+//  - Retire() is a deletion queue: callbacks run once the GPU passed the value
+// Not thread-safe: submit from the thread that owns the queue.
+class VulkanTimeline
+{
+public:
+    VulkanTimeline(VulkanDevice* device, VkQueue queue);
+    ~VulkanTimeline(); // waits for the last submit and runs all pending retirements
+
+    VkSemaphore GetHandle() const { return m_Semaphore; }
+    VkQueue     GetQueue() const { return m_Queue; }
+
+    // Returns the value this submit signals once complete. signals are extra
+    // binary semaphores (e.g. swapchain present).
+    uint64_t Submit(
+        const std::vector<VkCommandBuffer>& commandBuffers,
+        const std::vector<SemaphoreWait>& waits = {},
+        const std::vector<VkSemaphore>& signals = {});
+
+    // Last value handed out by Submit()
+    uint64_t GetSubmittedValue() const { return m_SubmittedValue; }
+
+    // Only queries the driver when the cached value is not high enough
+    bool     IsComplete(uint64_t value);
+    uint64_t GetCompletedValue();
+
+    // Host wait. Returns false on timeout.
+    bool Wait(uint64_t value, uint64_t timeoutNs = UINT64_MAX);
+    void WaitIdle() { Wait(m_SubmittedValue); }
+
+    // fn runs from CollectRetired() once value has completed. value may be
+    // ahead of GetSubmittedValue() ("after N more submits").
+    void Retire(uint64_t value, std::function<void()> fn);
+
+    // Runs due retirements. Call once per frame (VulkanSync does).
+    void CollectRetired();
+
+private:
+    struct Retirement
+    {
+        uint64_t value = 0;
+        std::function<void()> fn;
+    };
+
+    VulkanDevice* m_Device = nullptr;
+    VkQueue m_Queue = VK_NULL_HANDLE;
+    VkSemaphore m_Semaphore = VK_NULL_HANDLE;
+
+    uint64_t m_SubmittedValue = 0;
+    uint64_t m_CompletedValue = 0; // last value read back, may lag the GPU
+
+    std::deque<Retirement> m_Retirements; // sorted by value
+};
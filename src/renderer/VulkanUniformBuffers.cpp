@@ -1,5 +1,6 @@
 #include "VulkanUniformBuffers.h"
 #include "VulkanDevice.h"
+#include "VulkanFrameStats.h"
 #include "../core/Logger.h"
 
 #include <cstring>
@@ -83,4 +84,7 @@ VulkanUniformBuffers::~VulkanUniformBuffers()
 void VulkanUniformBuffers::Update(uint32_t frameIndex, const void* data, VkDeviceSize size)
 {
     std::memcpy(m_Mapped[frameIndex], data, static_cast<size_t>(size));
+
+    if (VulkanFrameStats* stats = m_Device->GetFrameStats())
+        stats->CountUpload(size);
 }
@@ -0,0 +1,132 @@
+#include "LightCuller.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Tightest sphere around a cone of the given length and cos(half angle).
+// Wide cones: the sphere through the cap rim, centered on the cap.
+// Narrow cones: the sphere through the apex and the rim.
+static BoundingSphere SpotLightBounds(const SpotLight& light)
+{
+    const glm::vec3 direction = glm::normalize(light.direction);
+    const float cosAngle = light.outerCutoff;
+
+    BoundingSphere s;
+    if (cosAngle <= 0.0f)
+    {
+        s.center = light.position;
+        s.radius = light.range;
+    }
+    else if (cosAngle < 0.70710678f)
+    {
+        s.center = light.position + direction * (light.range * cosAngle);
+        s.radius = light.range * std::sqrt(1.0f - cosAngle * cosAngle);
+    }
+    else
+    {
+        s.radius = light.range / (2.0f * cosAngle);
+        s.center = light.position + direction * s.radius;
+    }
+    return s;
+}
+
+static float MaxChannel(const glm::vec3& color)
+{
+    return std::max(color.x, std::max(color.y, color.z));
+}
+
+void LightCuller::Cull(
+    const Frustum& frustum,
+    const std::vector<PointLight>& pointLights,
+    const std::vector<SpotLight>& spotLights)
+{
+    m_Visible.clear();
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(pointLights.size()); i++)
+    {
+        const PointLight& l = pointLights[i];
+
+        VisibleLight v;
+        v.bounds.center = l.position;
+        v.bounds.radius = l.radius;
+        if (l.radius <= 0.0f || !frustum.IntersectsSphere(v.bounds))
+            continue;
+
+        v.position = l.position;
+        v.range = l.radius;
+        v.strength = l.intensity * MaxChannel(l.color);
+        v.entry = i;
+
+        if (v.strength > 0.0f)
+            m_Visible.push_back(v);
+    }
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(spotLights.size()); i++)
+    {
+        const SpotLight& l = spotLights[i];
+        if (l.range <= 0.0f)
+            continue;
+
+        VisibleLight v;
+        v.bounds = SpotLightBounds(l);
+        if (!frustum.IntersectsSphere(v.bounds))
+            continue;
+
+        // lighting.frag has no spot intensity: color carries it
+        v.position = l.position;
+        v.range = l.range;
+        v.strength = MaxChannel(l.color);
+        v.entry = i | SPOT_LIGHT_BIT;
+
+        if (v.strength > 0.0f)
+            m_Visible.push_back(v);
+    }
+}
+
+glm::uvec4 LightCuller::Select(const AABB& worldBounds) const
+{
+    uint32_t best[MAX_OBJECT_LIGHTS];
+    float bestScore[MAX_OBJECT_LIGHTS];
+    uint32_t count = 0;
+
+    const bool bounded = worldBounds.IsValid();
+    const BoundingSphere object = bounded ? BoundingSphere::FromAABB(worldBounds) : BoundingSphere();
+
+    for (const VisibleLight& light : m_Visible)
+    {
+        float score = light.strength;
+
+        if (bounded)
+        {
+            const float reach = light.bounds.radius + object.radius;
+            const glm::vec3 toLight = light.bounds.center - object.center;
+            if (glm::dot(toLight, toLight) > reach * reach)
+                continue;
+
+            // Linear falloff (as in lighting.frag) at the closest point of the object
+            const float distance = std::max(glm::length(light.position - object.center) - object.radius, 0.0f);
+            score *= 1.0f - std::min(distance / light.range, 1.0f);
+            if (score <= 0.0f)
+                continue;
+        }
+
+        // Insertion into the short sorted list, strongest first
+        if (count == MAX_OBJECT_LIGHTS && score <= bestScore[count - 1])
+            continue;
+
+        uint32_t slot = count < MAX_OBJECT_LIGHTS ? count++ : count - 1;
+        while (slot > 0 && bestScore[slot - 1] < score)
+        {
+            best[slot] = best[slot - 1];
+            bestScore[slot] = bestScore[slot - 1];
+            slot--;
+        }
+        best[slot] = light.entry;
+        bestScore[slot] = score;
+    }
+
+    glm::uvec4 lights(NO_LIGHT);
+    for (uint32_t i = 0; i < count; i++)
+        lights[i] = best[i];
+    return lights;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+#include "renderer/Bounds.h"
+#include "renderer/Frustum.h"
+#include "lighting/LightingTypes.h"
+#include "lighting/LightingLimits.h"
+
+// CPU light culling, the small-scene alternative to the cluster compute pass:
+//  - Cull() keeps the point and spot lights whose bounds touch the view
+//    frustum (point: its radius sphere, spot: a sphere around its cone)
+//  - Select() ranks the survivors by their estimated contribution to one
+//    object's bounds and returns the MAX_OBJECT_LIGHTS strongest
+// The list travels with the draw (push constants / GpuInstanceData) and the
+// OBJECT_LIGHT_LISTS permutation of lighting.frag shades only those lights.
+class LightCuller
+{
+public:
+    // List entry: point light index, or spot light index | SPOT_LIGHT_BIT.
+    // Used entries come first, the rest are NO_LIGHT.
+    static constexpr uint32_t SPOT_LIGHT_BIT = 0x80000000u;
+    static constexpr uint32_t NO_LIGHT = 0xFFFFFFFFu;
+
+    void Cull(
+        const Frustum& frustum,
+        const std::vector<PointLight>& pointLights,
+        const std::vector<SpotLight>& spotLights);
+
+    // Thread-safe after Cull(). Objects without valid bounds get the
+    // strongest visible lights.
+    glm::uvec4 Select(const AABB& worldBounds) const;
+
+    uint32_t GetVisibleLightCount() const { return static_cast<uint32_t>(m_Visible.size()); }
+
+private:
+    struct VisibleLight
+    {
+        BoundingSphere bounds;   // whole lit volume
+        glm::vec3      position; // attenuation origin
+        float          range = 0.0f;
+        float          strength = 0.0f; // brightest channel at zero distance
+        uint32_t       entry = NO_LIGHT;
+    };
+
+private:
+    std::vector<VisibleLight> m_Visible;
+};
@@ -0,0 +1,572 @@
+#include "SoftwareOcclusion.h"
+
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOC_USE_SSE 1
+#endif
+
+static constexpr uint32_t TILE_PIXELS = SoftwareOcclusionCuller::TILE_WIDTH * SoftwareOcclusionCuller::TILE_HEIGHT;
+static constexpr uint32_t OCCLUDERS_PER_TASK = 16;
+static constexpr uint32_t TILE_ROWS_PER_BAND = 2;
+static constexpr float    CLEAR_DEPTH = FLT_MAX;
+
+// --- 4-wide float helpers (SSE2, scalar fallback) ---
+
+#ifdef SOC_USE_SSE
+
+struct Float4 { __m128 v; };
+struct Mask4 { __m128 v; };
+
+static inline Float4 Splat(float f) { return { _mm_set1_ps(f) }; }
+static inline Float4 Make(float a, float b, float c, float d) { return { _mm_setr_ps(a, b, c, d) }; }
+static inline Float4 Load(const float* p) { return { _mm_loadu_ps(p) }; }
+static inline void   Store(float* p, Float4 a) { _mm_storeu_ps(p, a.v); }
+static inline Float4 operator+(Float4 a, Float4 b) { return { _mm_add_ps(a.v, b.v) }; }
+static inline Float4 operator*(Float4 a, Float4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+static inline Float4 Min(Float4 a, Float4 b) { return { _mm_min_ps(a.v, b.v) }; }
+static inline Float4 Max(Float4 a, Float4 b) { return { _mm_max_ps(a.v, b.v) }; }
+static inline Mask4  GreaterEqual(Float4 a, Float4 b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+static inline Mask4  operator&(Mask4 a, Mask4 b) { return { _mm_and_ps(a.v, b.v) }; }
+static inline int    MoveMask(Mask4 m) { return _mm_movemask_ps(m.v); }
+
+// m ? a : b
+static inline Float4 Select(Mask4 m, Float4 a, Float4 b)
+{
+    return { _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v)) };
+}
+
+static inline float HorizontalMax(Float4 a)
+{
+    __m128 m = _mm_max_ps(a.v, _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 3, 0, 1)));
+    m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(m);
+}
+
+#else
+
+struct Float4 { float v[4]; };
+struct Mask4 { bool v[4]; };
+
+static inline Float4 Splat(float f) { return { { f, f, f, f } }; }
+static inline Float4 Make(float a, float b, float c, float d) { return { { a, b, c, d } }; }
+static inline Float4 Load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+static inline void   Store(float* p, Float4 a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+
+static inline Float4 operator+(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+static inline Float4 operator*(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] *= b.v[i]; return a; }
+static inline Float4 Min(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] = std::min(a.v[i], b.v[i]); return a; }
+static inline Float4 Max(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] = std::max(a.v[i], b.v[i]); return a; }
+
+static inline Mask4 GreaterEqual(Float4 a, Float4 b)
+{
+    Mask4 m;
+    for (int i = 0; i < 4; i++) m.v[i] = a.v[i] >= b.v[i];
+    return m;
+}
+
+static inline Mask4 operator&(Mask4 a, Mask4 b) { for (int i = 0; i < 4; i++) a.v[i] = a.v[i] && b.v[i]; return a; }
+
+static inline int MoveMask(Mask4 m)
+{
+    int bits = 0;
+    for (int i = 0; i < 4; i++) bits |= m.v[i] ? (1 << i) : 0;
+    return bits;
+}
+
+static inline Float4 Select(Mask4 m, Float4 a, Float4 b)
+{
+    for (int i = 0; i < 4; i++) b.v[i] = m.v[i] ? a.v[i] : b.v[i];
+    return b;
+}
+
+static inline float HorizontalMax(Float4 a)
+{
+    return std::max(std::max(a.v[0], a.v[1]), std::max(a.v[2], a.v[3]));
+}
+
+#endif
+
+// --- Clipping ---
+
+// Clip volume with Vulkan depth (0 <= z <= w), matching Frustum:
+// left, right, bottom, top, near, far
+static constexpr uint32_t CLIP_PLANE_COUNT = 6;
+
+static inline float PlaneDistance(const glm::vec4& v, uint32_t plane)
+{
+    switch (plane)
+    {
+    case 0: return v.w + v.x;
+    case 1: return v.w - v.x;
+    case 2: return v.w + v.y;
+    case 3: return v.w - v.y;
+    case 4: return v.z;
+    default: return v.w - v.z;
+    }
+}
+
+static inline uint32_t OutCode(const glm::vec4& v)
+{
+    uint32_t code = 0;
+    for (uint32_t p = 0; p < CLIP_PLANE_COUNT; p++)
+    {
+        if (PlaneDistance(v, p) < 0.0f)
+            code |= 1u << p;
+    }
+    return code;
+}
+
+// --- OccluderMesh ---
+
+OccluderMesh OccluderMesh::FromAABB(const AABB& box)
+{
+    OccluderMesh mesh;
+
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        mesh.positions.push_back({
+            (i & 1) ? box.max.x : box.min.x,
+            (i & 2) ? box.max.y : box.min.y,
+            (i & 4) ? box.max.z : box.min.z
+        });
+    }
+
+    // Rasterized double-sided, so winding does not matter
+    mesh.indices = {
+        0, 1, 3,  0, 3, 2, // -z
+        4, 6, 7,  4, 7, 5, // +z
+        0, 4, 5,  0, 5, 1, // -y
+        2, 3, 7,  2, 7, 6, // +y
+        0, 2, 6,  0, 6, 4, // -x
+        1, 5, 7,  1, 7, 3  // +x
+    };
+
+    return mesh;
+}
+
+// --- SoftwareOcclusionCuller ---
+
+SoftwareOcclusionCuller::SoftwareOcclusionCuller(uint32_t width, uint32_t height, ThreadPool* pool)
+    : m_Pool(pool)
+{
+    m_TilesX = std::max(1u, (width + TILE_WIDTH - 1) / TILE_WIDTH);
+    m_TilesY = std::max(1u, (height + TILE_HEIGHT - 1) / TILE_HEIGHT);
+    m_Width = m_TilesX * TILE_WIDTH;
+    m_Height = m_TilesY * TILE_HEIGHT;
+
+    m_Depth.assign(size_t(m_TilesX) * m_TilesY * TILE_PIXELS, CLEAR_DEPTH);
+    m_TileMax.assign(size_t(m_TilesX) * m_TilesY, CLEAR_DEPTH);
+}
+
+void SoftwareOcclusionCuller::BeginFrame(const glm::mat4& viewProjection)
+{
+    m_ViewProjection = viewProjection;
+
+    std::fill(m_Depth.begin(), m_Depth.end(), CLEAR_DEPTH);
+    std::fill(m_TileMax.begin(), m_TileMax.end(), CLEAR_DEPTH);
+
+    m_Occluders.clear();
+    m_Stats = {};
+}
+
+void SoftwareOcclusionCuller::AddOccluder(const OccluderMesh* mesh, const glm::mat4& model)
+{
+    if (!mesh || mesh->indices.size() < 3)
+        return;
+
+    m_Occluders.push_back({ mesh, m_ViewProjection * model });
+
+    m_Stats.occluders++;
+    m_Stats.trianglesSubmitted += static_cast<uint32_t>(mesh->indices.size() / 3);
+}
+
+float SoftwareOcclusionCuller::GetDepth(uint32_t x, uint32_t y) const
+{
+    uint32_t tile = (y / TILE_HEIGHT) * m_TilesX + (x / TILE_WIDTH);
+    uint32_t texel = (y % TILE_HEIGHT) * TILE_WIDTH + (x % TILE_WIDTH);
+    return m_Depth[size_t(tile) * TILE_PIXELS + texel];
+}
+
+void SoftwareOcclusionCuller::Rasterize()
+{
+    auto parallelFor = [this](uint32_t count, const std::function<void(uint32_t, uint32_t)>& fn)
+    {
+        if (m_Pool)
+            m_Pool->ParallelFor(count, fn);
+        else
+            for (uint32_t i = 0; i < count; i++)
+                fn(i, 0);
+    };
+
+    // 1) Transform + clip + triangle setup, chunks of occluders per task
+    const uint32_t occluderCount = static_cast<uint32_t>(m_Occluders.size());
+    const uint32_t setupTasks = (occluderCount + OCCLUDERS_PER_TASK - 1) / OCCLUDERS_PER_TASK;
+
+    if (m_SetupBins.size() < setupTasks)
+        m_SetupBins.resize(setupTasks);
+
+    for (uint32_t i = 0; i < setupTasks; i++)
+        m_SetupBins[i].clear();
+
+    m_ActiveBins = setupTasks;
+
+    parallelFor(setupTasks, [this, occluderCount](uint32_t task, uint32_t)
+    {
+        uint32_t first = task * OCCLUDERS_PER_TASK;
+        uint32_t last = std::min(first + OCCLUDERS_PER_TASK, occluderCount);
+
+        for (uint32_t i = first; i < last; i++)
+            SetupOccluder(m_Occluders[i], m_SetupBins[task]);
+    });
+
+    for (uint32_t i = 0; i < setupTasks; i++)
+        m_Stats.trianglesRasterized += static_cast<uint32_t>(m_SetupBins[i].size());
+
+    // 2) Rasterize: each task owns a band of tile rows, so no two threads touch a tile
+    const uint32_t bandCount = (m_TilesY + TILE_ROWS_PER_BAND - 1) / TILE_ROWS_PER_BAND;
+
+    parallelFor(bandCount, [this](uint32_t band, uint32_t)
+    {
+        uint32_t firstRow = band * TILE_ROWS_PER_BAND;
+        uint32_t lastRow = std::min(firstRow + TILE_ROWS_PER_BAND, m_TilesY) - 1;
+        RasterizeBand(firstRow, lastRow);
+    });
+}
+
+void SoftwareOcclusionCuller::SetupOccluder(const OccluderInstance& occluder, std::vector<ScreenTriangle>& out) const
+{
+    thread_local std::vector<glm::vec4> clipPositions;
+
+    const OccluderMesh& mesh = *occluder.mesh;
+
+    clipPositions.resize(mesh.positions.size());
+    for (size_t i = 0; i < mesh.positions.size(); i++)
+        clipPositions[i] = occluder.mvp * glm::vec4(mesh.positions[i], 1.0f);
+
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+    {
+        glm::vec4 clip[3] = {
+            clipPositions[mesh.indices[i + 0]],
+            clipPositions[mesh.indices[i + 1]],
+            clipPositions[mesh.indices[i + 2]]
+        };
+        SetupTriangle(clip, out);
+    }
+}
+
+void SoftwareOcclusionCuller::SetupTriangle(const glm::vec4 clip[3], std::vector<ScreenTriangle>& out) const
+{
+    uint32_t code0 = OutCode(clip[0]);
+    uint32_t code1 = OutCode(clip[1]);
+    uint32_t code2 = OutCode(clip[2]);
+
+    // All three outside the same plane
+    if (code0 & code1 & code2)
+        return;
+
+    auto toScreen = [this](const glm::vec4& c)
+    {
+        float invW = 1.0f / c.w;
+        return glm::vec3(
+            (c.x * invW * 0.5f + 0.5f) * float(m_Width),
+            (c.y * invW * 0.5f + 0.5f) * float(m_Height),
+            c.z * invW
+        );
+    };
+
+    if ((code0 | code1 | code2) == 0)
+    {
+        glm::vec3 screen[3] = { toScreen(clip[0]), toScreen(clip[1]), toScreen(clip[2]) };
+        EmitTriangle(screen, out);
+        return;
+    }
+
+    // Sutherland-Hodgman against the planes that are actually crossed
+    glm::vec4 poly[3 + CLIP_PLANE_COUNT];
+    glm::vec4 next[3 + CLIP_PLANE_COUNT];
+    uint32_t count = 3;
+    poly[0] = clip[0];
+    poly[1] = clip[1];
+    poly[2] = clip[2];
+
+    uint32_t crossed = code0 | code1 | code2;
+
+    for (uint32_t p = 0; p < CLIP_PLANE_COUNT && count >= 3; p++)
+    {
+        if (!(crossed & (1u << p)))
+            continue;
+
+        uint32_t nextCount = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const glm::vec4& a = poly[i];
+            const glm::vec4& b = poly[(i + 1) % count];
+            float da = PlaneDistance(a, p);
+            float db = PlaneDistance(b, p);
+
+            if (da >= 0.0f)
+                next[nextCount++] = a;
+
+            if ((da >= 0.0f) != (db >= 0.0f))
+                next[nextCount++] = a + (b - a) * (da / (da - db));
+        }
+
+        count = nextCount;
+        for (uint32_t i = 0; i < count; i++)
+            poly[i] = next[i];
+    }
+
+    if (count < 3)
+        return;
+
+    glm::vec3 first = toScreen(poly[0]);
+    glm::vec3 prev = toScreen(poly[1]);
+
+    for (uint32_t i = 2; i < count; i++)
+    {
+        glm::vec3 cur = toScreen(poly[i]);
+        glm::vec3 screen[3] = { first, prev, cur };
+        EmitTriangle(screen, out);
+        prev = cur;
+    }
+}
+
+void SoftwareOcclusionCuller::EmitTriangle(const glm::vec3 s[3], std::vector<ScreenTriangle>& out) const
+{
+    glm::vec2 d1(s[1].x - s[0].x, s[1].y - s[0].y);
+    glm::vec2 d2(s[2].x - s[0].x, s[2].y - s[0].y);
+    float area = d1.x * d2.y - d2.x * d1.y;
+
+    if (std::fabs(area) < 1e-6f)
+        return;
+
+    // Pixel (x, y) is sampled at its center (x + 0.5, y + 0.5)
+    float minX = std::min({ s[0].x, s[1].x, s[2].x });
+    float maxX = std::max({ s[0].x, s[1].x, s[2].x });
+    float minY = std::min({ s[0].y, s[1].y, s[2].y });
+    float maxY = std::max({ s[0].y, s[1].y, s[2].y });
+
+    ScreenTriangle tri{};
+    tri.minX = std::max(0, (int)std::ceil(minX - 0.5f));
+    tri.maxX = std::min((int)m_Width - 1, (int)std::floor(maxX - 0.5f));
+    tri.minY = std::max(0, (int)std::ceil(minY - 0.5f));
+    tri.maxY = std::min((int)m_Height - 1, (int)std::floor(maxY - 0.5f));
+
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY)
+        return;
+
+    // Edge i runs from s[i] to s[i+1]; positive inside for counter-clockwise
+    const float sign = area > 0.0f ? 1.0f : -1.0f;
+    for (int i = 0; i < 3; i++)
+    {
+        const glm::vec3& a = s[i];
+        const glm::vec3& b = s[(i + 1) % 3];
+        tri.edgeA[i] = sign * (a.y - b.y);
+        tri.edgeB[i] = sign * (b.x - a.x);
+        tri.edgeC[i] = sign * (a.x * b.y - a.y * b.x);
+    }
+
+    float dz1 = s[1].z - s[0].z;
+    float dz2 = s[2].z - s[0].z;
+    tri.zA = (dz1 * d2.y - dz2 * d1.y) / area;
+    tri.zB = (dz2 * d1.x - dz1 * d2.x) / area;
+    tri.zC = s[0].z - tri.zA * s[0].x - tri.zB * s[0].y;
+    tri.zMin = std::min({ s[0].z, s[1].z, s[2].z });
+
+    out.push_back(tri);
+}
+
+void SoftwareOcclusionCuller::RasterizeBand(uint32_t firstTileRow, uint32_t lastTileRow)
+{
+    for (uint32_t bin = 0; bin < m_ActiveBins; bin++)
+    {
+        for (const ScreenTriangle& tri : m_SetupBins[bin])
+        {
+            uint32_t ty0 = std::max(firstTileRow, uint32_t(tri.minY) / TILE_HEIGHT);
+            uint32_t ty1 = std::min(lastTileRow, uint32_t(tri.maxY) / TILE_HEIGHT);
+            if (ty0 > ty1)
+                continue;
+
+            uint32_t tx0 = uint32_t(tri.minX) / TILE_WIDTH;
+            uint32_t tx1 = uint32_t(tri.maxX) / TILE_WIDTH;
+
+            for (uint32_t ty = ty0; ty <= ty1; ty++)
+            {
+                for (uint32_t tx = tx0; tx <= tx1; tx++)
+                {
+                    // Hierarchical reject: tile already closer everywhere
+                    if (tri.zMin >= m_TileMax[ty * m_TilesX + tx])
+                        continue;
+
+                    RasterizeTile(tri, tx, ty);
+                }
+            }
+        }
+    }
+}
+
+void SoftwareOcclusionCuller::RasterizeTile(const ScreenTriangle& tri, uint32_t tileX, uint32_t tileY)
+{
+    const float x0 = float(tileX * TILE_WIDTH) + 0.5f;
+    const float y0 = float(tileY * TILE_HEIGHT) + 0.5f;
+
+    const Float4 colLo = Make(0.0f, 1.0f, 2.0f, 3.0f);
+    const Float4 colHi = Make(4.0f, 5.0f, 6.0f, 7.0f);
+    const Float4 zero = Splat(0.0f);
+
+    // Trivial reject: some edge is negative at every pixel center of the tile
+    float edgeBase[3];
+    for (int i = 0; i < 3; i++)
+    {
+        edgeBase[i] = tri.edgeA[i] * x0 + tri.edgeB[i] * y0 + tri.edgeC[i];
+
+        float best = edgeBase[i] +
+            std::max(0.0f, tri.edgeA[i] * float(TILE_WIDTH - 1)) +
+            std::max(0.0f, tri.edgeB[i] * float(TILE_HEIGHT - 1));
+        if (best < 0.0f)
+            return;
+    }
+
+    // Edge + depth values for the first row, left/right half of the tile
+    Float4 edgeLo[3], edgeHi[3], edgeStep[3];
+    for (int i = 0; i < 3; i++)
+    {
+        float base = edgeBase[i];
+        Float4 a = Splat(tri.edgeA[i]);
+        edgeLo[i] = Splat(base) + a * colLo;
+        edgeHi[i] = Splat(base) + a * colHi;
+        edgeStep[i] = Splat(tri.edgeB[i]);
+    }
+
+    float zBase = tri.zA * x0 + tri.zB * y0 + tri.zC;
+    Float4 zA = Splat(tri.zA);
+    Float4 zLo = Splat(zBase) + zA * colLo;
+    Float4 zHi = Splat(zBase) + zA * colHi;
+    Float4 zStep = Splat(tri.zB);
+
+    const uint32_t tileIndex = tileY * m_TilesX + tileX;
+    float* depth = &m_Depth[size_t(tileIndex) * TILE_PIXELS];
+
+    Float4 farthest = Splat(-FLT_MAX);
+    int coverage = 0;
+
+    for (uint32_t row = 0; row < TILE_HEIGHT; row++)
+    {
+        float* rowDepth = depth + row * TILE_WIDTH;
+
+        Mask4 insideLo = GreaterEqual(edgeLo[0], zero) & GreaterEqual(edgeLo[1], zero) & GreaterEqual(edgeLo[2], zero);
+        Mask4 insideHi = GreaterEqual(edgeHi[0], zero) & GreaterEqual(edgeHi[1], zero) & GreaterEqual(edgeHi[2], zero);
+
+        int maskLo = MoveMask(insideLo);
+        int maskHi = MoveMask(insideHi);
+        coverage |= (maskLo | (maskHi << 4)) << (row * TILE_WIDTH);
+
+        Float4 dLo = Load(rowDepth);
+        Float4 dHi = Load(rowDepth + 4);
+
+        if (maskLo)
+        {
+            dLo = Select(insideLo, Min(dLo, zLo), dLo);
+            Store(rowDepth, dLo);
+        }
+        if (maskHi)
+        {
+            dHi = Select(insideHi, Min(dHi, zHi), dHi);
+            Store(rowDepth + 4, dHi);
+        }
+
+        farthest = Max(farthest, Max(dLo, dHi));
+
+        for (int i = 0; i < 3; i++)
+        {
+            edgeLo[i] = edgeLo[i] + edgeStep[i];
+            edgeHi[i] = edgeHi[i] + edgeStep[i];
+        }
+        zLo = zLo + zStep;
+        zHi = zHi + zStep;
+    }
+
+    if (coverage)
+        m_TileMax[tileIndex] = HorizontalMax(farthest);
+}
+
+bool SoftwareOcclusionCuller::IsVisible(const AABB& worldBox) const
+{
+    glm::vec2 ndcMin(FLT_MAX), ndcMax(-FLT_MAX);
+    float zMin = FLT_MAX;
+
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        glm::vec3 p(
+            (i & 1) ? worldBox.max.x : worldBox.min.x,
+            (i & 2) ? worldBox.max.y : worldBox.min.y,
+            (i & 4) ? worldBox.max.z : worldBox.min.z
+        );
+
+        glm::vec4 clip = m_ViewProjection * glm::vec4(p, 1.0f);
+
+        // Crosses the near plane: no usable screen bounds
+        if (clip.w <= 1e-6f || clip.z < 0.0f)
+            return true;
+
+        float invW = 1.0f / clip.w;
+        glm::vec2 ndc(clip.x * invW, clip.y * invW);
+        ndcMin = glm::min(ndcMin, ndc);
+        ndcMax = glm::max(ndcMax, ndc);
+        zMin = std::min(zMin, clip.z * invW);
+    }
+
+    // Every pixel the screen rect touches (conservative)
+    int x0 = std::max(0, (int)std::floor((ndcMin.x * 0.5f + 0.5f) * float(m_Width)));
+    int x1 = std::min((int)m_Width - 1, (int)std::floor((ndcMax.x * 0.5f + 0.5f) * float(m_Width)));
+    int y0 = std::max(0, (int)std::floor((ndcMin.y * 0.5f + 0.5f) * float(m_Height)));
+    int y1 = std::min((int)m_Height - 1, (int)std::floor((ndcMax.y * 0.5f + 0.5f) * float(m_Height)));
+
+    if (x0 > x1 || y0 > y1)
+        return true;
+
+    const Float4 z = Splat(zMin);
+
+    for (uint32_t ty = uint32_t(y0) / TILE_HEIGHT; ty <= uint32_t(y1) / TILE_HEIGHT; ty++)
+    {
+        for (uint32_t tx = uint32_t(x0) / TILE_WIDTH; tx <= uint32_t(x1) / TILE_WIDTH; tx++)
+        {
+            const uint32_t tileIndex = ty * m_TilesX + tx;
+
+            // Every occluder sample in the tile is closer than the box
+            if (m_TileMax[tileIndex] < zMin)
+                continue;
+
+            const int tileX = int(tx * TILE_WIDTH);
+            const int tileY = int(ty * TILE_HEIGHT);
+            const int px0 = std::max(x0, tileX) - tileX;
+            const int px1 = std::min(x1, tileX + int(TILE_WIDTH) - 1) - tileX;
+            const int py0 = std::max(y0, tileY) - tileY;
+            const int py1 = std::min(y1, tileY + int(TILE_HEIGHT) - 1) - tileY;
+
+            const int columns = (0xFF >> (7 - px1)) & (0xFF << px0);
+            const int colsLo = columns & 0xF;
+            const int colsHi = columns >> 4;
+
+            const float* depth = &m_Depth[size_t(tileIndex) * TILE_PIXELS];
+
+            for (int row = py0; row <= py1; row++)
+            {
+                const float* rowDepth = depth + row * TILE_WIDTH;
+
+                if (colsLo && (MoveMask(GreaterEqual(Load(rowDepth), z)) & colsLo))
+                    return true;
+                if (colsHi && (MoveMask(GreaterEqual(Load(rowDepth + 4), z)) & colsHi))
+                    return true;
+            }
+        }
+    }
+
+    return false;
+}
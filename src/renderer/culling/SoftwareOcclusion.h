@@ -0,0 +1,110 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+#include "renderer/Bounds.h"
+
+class ThreadPool;
+
+// Low-LOD occluder proxy in mesh-local space (triangle list).
+// Proxies must lie inside the visible surface they stand for, or they
+// will hide things the real mesh does not.
+struct OccluderMesh
+{
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t>  indices;
+
+    // 12-triangle box, e.g. for walls / buildings that fill their bounds
+    static OccluderMesh FromAABB(const AABB& box);
+};
+
+struct SoftwareOcclusionStats
+{
+    uint32_t occluders = 0;
+    uint32_t trianglesSubmitted = 0;
+    uint32_t trianglesRasterized = 0; // after clipping (a clipped triangle may count twice)
+};
+
+// CPU masked software occlusion culling.
+//  - occluder triangles are transformed/clipped on worker threads, then
+//    rasterized per screen band into a coarse depth buffer of 8x4 tiles
+//  - SIMD edge functions give a 32-bit coverage mask per tile; depth is
+//    min-updated under that mask and each tile keeps its farthest depth
+//  - IsVisible() rejects whole tiles with the tile max first, then checks
+//    the covered pixels of the remaining tiles
+// Depth is clip z / w of the given view-projection (smaller = closer), the
+// same value the GPU depth test sees.
+class SoftwareOcclusionCuller
+{
+public:
+    static constexpr uint32_t TILE_WIDTH = 8;
+    static constexpr uint32_t TILE_HEIGHT = 4;
+
+    // Resolution is rounded up to whole tiles. pool may be null (single thread).
+    SoftwareOcclusionCuller(uint32_t width, uint32_t height, ThreadPool* pool = nullptr);
+
+    void SetThreadPool(ThreadPool* pool) { m_Pool = pool; }
+
+    // Clears depth and the occluder list
+    void BeginFrame(const glm::mat4& viewProjection);
+
+    // Queued, rasterized by Rasterize(). The mesh must outlive the frame.
+    void AddOccluder(const OccluderMesh* mesh, const glm::mat4& model);
+
+    void Rasterize();
+
+    // True if any part of the box may be visible. Thread-safe after Rasterize().
+    // Boxes that cross the near plane or leave the screen are treated as visible
+    // (frustum culling is a separate step).
+    bool IsVisible(const AABB& worldBox) const;
+
+    uint32_t GetWidth() const { return m_Width; }
+    uint32_t GetHeight() const { return m_Height; }
+    float    GetDepth(uint32_t x, uint32_t y) const;
+
+    const SoftwareOcclusionStats& GetStats() const { return m_Stats; }
+
+private:
+    struct OccluderInstance
+    {
+        const OccluderMesh* mesh = nullptr;
+        glm::mat4 mvp;
+    };
+
+    // Setup result: E_i(x, y) = a*x + b*y + c >= 0 inside, z(x, y) = plane
+    struct ScreenTriangle
+    {
+        float edgeA[3];
+        float edgeB[3];
+        float edgeC[3];
+        float zA, zB, zC;
+        float zMin;                   // nearest vertex, for the tile-max reject
+        int   minX, minY, maxX, maxY; // pixel bounds, inclusive, on screen
+    };
+
+    void SetupOccluder(const OccluderInstance& occluder, std::vector<ScreenTriangle>& out) const;
+    void SetupTriangle(const glm::vec4 clip[3], std::vector<ScreenTriangle>& out) const;
+    void EmitTriangle(const glm::vec3 screen[3], std::vector<ScreenTriangle>& out) const;
+    void RasterizeBand(uint32_t firstTileRow, uint32_t lastTileRow);
+    void RasterizeTile(const ScreenTriangle& tri, uint32_t tileX, uint32_t tileY);
+
+private:
+    ThreadPool* m_Pool = nullptr;
+
+    uint32_t m_Width = 0;
+    uint32_t m_Height = 0;
+    uint32_t m_TilesX = 0;
+    uint32_t m_TilesY = 0;
+
+    glm::mat4 m_ViewProjection{ 1.0f };
+
+    std::vector<float> m_Depth;   // per tile: 8x4 floats, row-major
+    std::vector<float> m_TileMax; // farthest depth per tile
+
+    std::vector<OccluderInstance> m_Occluders;
+    std::vector<std::vector<ScreenTriangle>> m_SetupBins; // one per setup task
+    uint32_t m_ActiveBins = 0;
+
+    SoftwareOcclusionStats m_Stats;
+};
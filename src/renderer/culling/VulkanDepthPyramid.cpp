@@ -0,0 +1,386 @@
+#include "VulkanDepthPyramid.h"
+
+#include "renderer/VulkanDevice.h"
+#include "renderer/VulkanDescriptorAllocator.h"
+#include "renderer/VulkanProfiler.h"
+#include "renderer/VulkanFrameStats.h"
+#include "renderer/pipeline/VulkanStateCache.h"
+#include "renderer/VulkanDepthBuffer.h"
+#include "renderer/pipeline/VulkanComputePipeline.h"
+#include "core/Logger.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+static constexpr uint32_t HIZ_GROUP_SIZE = 8; // must match local_size in hiz_*.comp
+
+// Shared by hiz_copy.comp, hiz_copy_ms.comp and hiz_reduce.comp
+struct HiZPushConstants
+{
+    uint32_t dstWidth;
+    uint32_t dstHeight;
+    uint32_t srcWidth;
+    uint32_t srcHeight;
+    uint32_t sampleCount;
+    uint32_t padding[3];
+};
+
+static VkImageAspectFlags DepthBarrierAspect(VkFormat format)
+{
+    // Layout transitions of combined formats must name both aspects
+    if (format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT)
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    return VK_IMAGE_ASPECT_DEPTH_BIT;
+}
+
+VulkanDepthPyramid::VulkanDepthPyramid(VulkanDevice* device, VulkanDepthBuffer* depthBuffer)
+    : m_Device(device), m_DepthBuffer(depthBuffer)
+{
+    VkExtent2D extent = m_DepthBuffer->GetExtent();
+    m_Width = extent.width;
+    m_Height = extent.height;
+
+    m_MipCount = 1;
+    while ((std::max(m_Width, m_Height) >> m_MipCount) > 0)
+        m_MipCount++;
+
+    CreateImage();
+    CreateDescriptors();
+    TransitionToGeneral();
+
+    const bool msaa = m_DepthBuffer->GetSamples() != VK_SAMPLE_COUNT_1_BIT;
+
+    // Shared: a pyramid rebuilt on resize reuses the compiled pipelines
+    VulkanStateCache* states = m_Device->GetStateCache();
+
+    m_CopyPipeline = states->GetComputePipeline({
+        { m_Layout },
+        msaa ? "shaders/hiz_copy_ms.comp.spv" : "shaders/hiz_copy.comp.spv",
+        sizeof(HiZPushConstants)
+    });
+
+    m_ReducePipeline = states->GetComputePipeline({
+        { m_Layout },
+        "shaders/hiz_reduce.comp.spv",
+        sizeof(HiZPushConstants)
+    });
+
+    LOG_INFO("Depth pyramid created (" + std::to_string(m_Width) + "x" + std::to_string(m_Height) +
+        ", " + std::to_string(m_MipCount) + " mips).");
+}
+
+VulkanDepthPyramid::~VulkanDepthPyramid()
+{
+    VkDevice vkDevice = m_Device->GetHandle();
+
+    VulkanDescriptorAllocator* allocator = m_Device->GetDescriptorAllocator();
+    for (VkDescriptorSet set : m_Sets)
+        allocator->Free(m_Layout, set);
+
+    if (m_Sampler) vkDestroySampler(vkDevice, m_Sampler, nullptr);
+
+    for (VkImageView view : m_MipViews)
+        vkDestroyImageView(vkDevice, view, nullptr);
+
+    if (m_FullView) vkDestroyImageView(vkDevice, m_FullView, nullptr);
+    if (m_Image) vkDestroyImage(vkDevice, m_Image, nullptr);
+    if (m_Memory) vkFreeMemory(vkDevice, m_Memory, nullptr);
+}
+
+void VulkanDepthPyramid::CreateImage()
+{
+    VkDevice vkDevice = m_Device->GetHandle();
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = { m_Width, m_Height, 1 };
+    imageInfo.mipLevels = m_MipCount;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = VK_FORMAT_R32_SFLOAT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateImage(vkDevice, &imageInfo, nullptr, &m_Image) != VK_SUCCESS)
+        throw std::runtime_error("VulkanDepthPyramid: failed to create image");
+
+    VkMemoryRequirements memReq{};
+    vkGetImageMemoryRequirements(vkDevice, m_Image, &memReq);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memReq.size;
+    allocInfo.memoryTypeIndex = m_Device->FindMemoryType(
+        memReq.memoryTypeBits,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+    );
+
+    if (vkAllocateMemory(vkDevice, &allocInfo, nullptr, &m_Memory) != VK_SUCCESS)
+        throw std::runtime_error("VulkanDepthPyramid: failed to allocate image memory");
+
+    vkBindImageMemory(vkDevice, m_Image, m_Memory, 0);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = m_Image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R32_SFLOAT;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = m_MipCount;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(vkDevice, &viewInfo, nullptr, &m_FullView) != VK_SUCCESS)
+        throw std::runtime_error("VulkanDepthPyramid: failed to create view");
+
+    m_MipViews.resize(m_MipCount);
+    for (uint32_t i = 0; i < m_MipCount; i++)
+    {
+        viewInfo.subresourceRange.baseMipLevel = i;
+        viewInfo.subresourceRange.levelCount = 1;
+
+        if (vkCreateImageView(vkDevice, &viewInfo, nullptr, &m_MipViews[i]) != VK_SUCCESS)
+            throw std::runtime_error("VulkanDepthPyramid: failed to create mip view");
+    }
+
+    // Only texelFetch is used, so nearest + clamp
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = static_cast<float>(m_MipCount);
+
+    if (vkCreateSampler(vkDevice, &samplerInfo, nullptr, &m_Sampler) != VK_SUCCESS)
+        throw std::runtime_error("VulkanDepthPyramid: failed to create sampler");
+}
+
+void VulkanDepthPyramid::CreateDescriptors()
+{
+    VkDevice vkDevice = m_Device->GetHandle();
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings(2);
+
+    // binding 0 -> source (scene depth or previous mip)
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // binding 1 -> destination mip
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    m_Layout = m_Device->GetStateCache()->GetSetLayout(bindings);
+
+    // Recycled by the allocator when a resize recreates the pyramid
+    VulkanDescriptorAllocator* allocator = m_Device->GetDescriptorAllocator();
+
+    m_Sets.resize(m_MipCount);
+    for (uint32_t i = 0; i < m_MipCount; i++)
+        m_Sets[i] = allocator->Allocate(m_Layout);
+
+    for (uint32_t i = 0; i < m_MipCount; i++)
+    {
+        VkDescriptorImageInfo srcInfo{};
+        srcInfo.sampler = m_Sampler;
+        srcInfo.imageView = (i == 0) ? m_DepthBuffer->GetImageView() : m_MipViews[i - 1];
+        srcInfo.imageLayout = (i == 0)
+            ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+            : VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorImageInfo dstInfo{};
+        dstInfo.imageView = m_MipViews[i];
+        dstInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        std::array<VkWriteDescriptorSet, 2> writes{};
+
+        writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[0].dstSet = m_Sets[i];
+        writes[0].dstBinding = 0;
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        writes[0].descriptorCount = 1;
+        writes[0].pImageInfo = &srcInfo;
+
+        writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[1].dstSet = m_Sets[i];
+        writes[1].dstBinding = 1;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writes[1].descriptorCount = 1;
+        writes[1].pImageInfo = &dstInfo;
+
+        vkUpdateDescriptorSets(vkDevice, (uint32_t)writes.size(), writes.data(), 0, nullptr);
+    }
+}
+
+void VulkanDepthPyramid::TransitionToGeneral()
+{
+    VkCommandBuffer cmd = m_Device->BeginSingleTimeCommands();
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = m_Image;
+    barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipCount, 0, 1 };
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0,
+        0, nullptr,
+        0, nullptr,
+        1, &barrier
+    );
+
+    // No host wait: runs ahead of the first frame that builds into it, and a
+    // pyramid recreated on resize must not stall the frames in flight
+    m_Device->SubmitSingleTimeCommands(cmd);
+}
+
+void VulkanDepthPyramid::Build(VkCommandBuffer cmd)
+{
+    PROFILE_GPU_SCOPE(m_Device->GetProfiler(), cmd, "Depth pyramid");
+
+    VkImageAspectFlags depthAspect = DepthBarrierAspect(m_DepthBuffer->GetFormat());
+
+    // 1) Depth: attachment -> sampled. Pyramid: previous culling reads -> writes.
+    std::array<VkImageMemoryBarrier, 2> begin{};
+
+    begin[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    begin[0].oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    begin[0].newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    begin[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    begin[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    begin[0].image = m_DepthBuffer->GetImage();
+    begin[0].subresourceRange = { depthAspect, 0, 1, 0, 1 };
+    begin[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    begin[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    begin[1].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    begin[1].oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    begin[1].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    begin[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    begin[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    begin[1].image = m_Image;
+    begin[1].subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipCount, 0, 1 };
+    begin[1].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    begin[1].dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0,
+        0, nullptr,
+        0, nullptr,
+        (uint32_t)begin.size(), begin.data()
+    );
+
+    if (VulkanFrameStats* stats = m_Device->GetFrameStats())
+    {
+        stats->CountPipelineBinds(m_MipCount);
+        stats->CountDescriptorBinds(m_MipCount);
+        stats->CountPushConstants(m_MipCount);
+    }
+
+    // 2) Downsample chain
+    for (uint32_t i = 0; i < m_MipCount; i++)
+    {
+        VulkanComputePipeline* pipeline = (i == 0) ? m_CopyPipeline : m_ReducePipeline;
+
+        HiZPushConstants pc{};
+        pc.dstWidth = std::max(1u, m_Width >> i);
+        pc.dstHeight = std::max(1u, m_Height >> i);
+        pc.srcWidth = (i == 0) ? m_Width : std::max(1u, m_Width >> (i - 1));
+        pc.srcHeight = (i == 0) ? m_Height : std::max(1u, m_Height >> (i - 1));
+        pc.sampleCount = static_cast<uint32_t>(m_DepthBuffer->GetSamples());
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->GetHandle());
+        vkCmdBindDescriptorSets(
+            cmd,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            pipeline->GetLayout(),
+            0,
+            1,
+            &m_Sets[i],
+            0,
+            nullptr
+        );
+        vkCmdPushConstants(
+            cmd,
+            pipeline->GetLayout(),
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            0,
+            sizeof(HiZPushConstants),
+            &pc
+        );
+
+        vkCmdDispatch(
+            cmd,
+            (pc.dstWidth + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE,
+            (pc.dstHeight + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE,
+            1
+        );
+
+        // mip i written -> read by the next reduction (or by culling after the last one)
+        VkImageMemoryBarrier mipBarrier{};
+        mipBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        mipBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        mipBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        mipBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        mipBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        mipBarrier.image = m_Image;
+        mipBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1 };
+        mipBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        mipBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            cmd,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0,
+            0, nullptr,
+            0, nullptr,
+            1, &mipBarrier
+        );
+    }
+
+    // 3) Depth back to attachment for the late pass (LOAD)
+    VkImageMemoryBarrier end{};
+    end.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    end.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    end.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    end.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    end.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    end.image = m_DepthBuffer->GetImage();
+    end.subresourceRange = { depthAspect, 0, 1, 0, 1 };
+    end.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    end.dstAccessMask =
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    vkCmdPipelineBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        0,
+        0, nullptr,
+        0, nullptr,
+        1, &end
+    );
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <cstdint>
+
+class VulkanDevice;
+class VulkanDepthBuffer;
+class VulkanComputePipeline;
+
+// Hierarchical Z (max-depth) pyramid built from the scene depth buffer by a
+// compute downsample chain. Mip 0 is a full-resolution copy (max over MSAA
+// samples), each further mip keeps the farthest depth of its footprint.
+// The image stays in VK_IMAGE_LAYOUT_GENERAL for both writes and sampling.
+class VulkanDepthPyramid
+{
+public:
+    VulkanDepthPyramid(VulkanDevice* device, VulkanDepthBuffer* depthBuffer);
+    ~VulkanDepthPyramid();
+
+    // Records the build. Expects the depth buffer in DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+    // (after a render pass) and leaves it there.
+    void Build(VkCommandBuffer cmd);
+
+    VkImageView GetView() const { return m_FullView; }
+    VkSampler   GetSampler() const { return m_Sampler; }
+
+    uint32_t GetWidth() const { return m_Width; }
+    uint32_t GetHeight() const { return m_Height; }
+    uint32_t GetMipCount() const { return m_MipCount; }
+
+private:
+    void CreateImage();
+    void CreateDescriptors();
+    void TransitionToGeneral();
+
+private:
+    VulkanDevice* m_Device = nullptr;
+    VulkanDepthBuffer* m_DepthBuffer = nullptr;
+
+    uint32_t m_Width = 0;
+    uint32_t m_Height = 0;
+    uint32_t m_MipCount = 0;
+
+    VkImage        m_Image = VK_NULL_HANDLE;
+    VkDeviceMemory m_Memory = VK_NULL_HANDLE;
+    VkImageView    m_FullView = VK_NULL_HANDLE;   // all mips, sampled by culling
+    std::vector<VkImageView> m_MipViews;          // one per mip, storage + src of next mip
+    VkSampler      m_Sampler = VK_NULL_HANDLE;
+
+    VkDescriptorSetLayout m_Layout = VK_NULL_HANDLE; // shared (state cache)
+    std::vector<VkDescriptorSet> m_Sets;          // set i: src (depth or mip i-1) -> dst mip i
+
+    VulkanComputePipeline* m_CopyPipeline = nullptr;   // depth -> mip 0 (shared, state cache)
+    VulkanComputePipeline* m_ReducePipeline = nullptr; // mip i-1 -> mip i (shared, state cache)
+};
@@ -0,0 +1,951 @@
+#include "VulkanGpuCulling.h"
+
+#include "renderer/VulkanDevice.h"
+#include "renderer/VulkanDescriptorAllocator.h"
+#include "renderer/VulkanTimeline.h"
+#include "renderer/VulkanProfiler.h"
+#include "renderer/VulkanFrameStats.h"
+#include "renderer/pipeline/VulkanStateCache.h"
+#include "renderer/Scene.h"
+#include "renderer/Mesh.h"
+#include "renderer/MaterialInstance.h"
+#include "renderer/pipeline/VulkanPipeline.h"
+#include "renderer/pipeline/VulkanComputePipeline.h"
+#include "renderer/culling/VulkanDepthPyramid.h"
+#include "renderer/culling/LightCuller.h"
+#include "core/Logger.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+static constexpr uint32_t CULL_GROUP_SIZE = 64; // must match local_size_x in cull.comp
+static constexpr uint32_t CULL_PHASE_COUNT = 2;  // early + late draw ranges
+static constexpr uint32_t CULL_BINDING_COUNT = 7;
+
+static uint32_t NextCapacity(uint32_t needed, uint32_t current)
+{
+    uint32_t cap = current > 0 ? current : 256;
+    while (cap < needed)
+        cap *= 2;
+    return cap;
+}
+
+VulkanGpuCulling::VulkanGpuCulling(VulkanDevice* device, uint32_t framesInFlight, VulkanDepthPyramid* depthPyramid)
+    : m_Device(device), m_DepthPyramid(depthPyramid)
+{
+    if (!m_Device->GetEnabledFeatures().drawIndirectFirstInstance)
+        throw std::runtime_error("VulkanGpuCulling: drawIndirectFirstInstance not supported");
+
+    CreateLayout();
+
+    m_CullPipeline = m_Device->GetStateCache()->GetComputePipeline({
+        { m_Layout },
+        "shaders/cull.comp.spv",
+        sizeof(GpuCullPushConstants)
+    });
+
+    m_Frames.resize(framesInFlight);
+
+    EnsureInstanceCapacity(1);
+    EnsureVisibilityCapacity(1);
+
+    for (uint32_t i = 0; i < framesInFlight; i++)
+    {
+        CreateFixedBuffers(m_Frames[i]);
+        EnsureCapacity(m_Frames[i], 1, 1);
+    }
+
+    LOG_INFO("GPU culling initialized.");
+}
+
+VulkanGpuCulling::~VulkanGpuCulling()
+{
+    VkDevice vkDevice = m_Device->GetHandle();
+
+    for (FrameResources& frame : m_Frames)
+    {
+        DestroyBuffers(frame);
+
+        if (frame.stagingMapped) vkUnmapMemory(vkDevice, frame.stagingMemory);
+        if (frame.stagingBuffer) vkDestroyBuffer(vkDevice, frame.stagingBuffer, nullptr);
+        if (frame.stagingMemory) vkFreeMemory(vkDevice, frame.stagingMemory, nullptr);
+
+        if (frame.uniformMapped) vkUnmapMemory(vkDevice, frame.uniformMemory);
+        if (frame.statsMapped) vkUnmapMemory(vkDevice, frame.statsMemory);
+        if (frame.uniformBuffer) vkDestroyBuffer(vkDevice, frame.uniformBuffer, nullptr);
+        if (frame.statsBuffer) vkDestroyBuffer(vkDevice, frame.statsBuffer, nullptr);
+        if (frame.uniformMemory) vkFreeMemory(vkDevice, frame.uniformMemory, nullptr);
+        if (frame.statsMemory) vkFreeMemory(vkDevice, frame.statsMemory, nullptr);
+    }
+
+    if (m_InstanceBuffer) vkDestroyBuffer(vkDevice, m_InstanceBuffer, nullptr);
+    if (m_InstanceMemory) vkFreeMemory(vkDevice, m_InstanceMemory, nullptr);
+    if (m_VisibilityBuffer) vkDestroyBuffer(vkDevice, m_VisibilityBuffer, nullptr);
+    if (m_VisibilityMemory) vkFreeMemory(vkDevice, m_VisibilityMemory, nullptr);
+}
+
+void VulkanGpuCulling::CreateLayout()
+{
+    std::vector<VkDescriptorSetLayoutBinding> bindings(CULL_BINDING_COUNT);
+
+    // binding 0 -> instance data (read by cull + vertex)
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+
+    // binding 1 -> indirect draw commands (written by cull)
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // binding 2 -> compacted visible instance ids (written by cull, read by vertex)
+    bindings[2].binding = 2;
+    bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[2].descriptorCount = 1;
+    bindings[2].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+
+    // binding 3 -> cull uniforms (view, planes, projection terms)
+    bindings[3].binding = 3;
+    bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    bindings[3].descriptorCount = 1;
+    bindings[3].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // binding 4 -> Hi-Z depth pyramid
+    bindings[4].binding = 4;
+    bindings[4].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[4].descriptorCount = 1;
+    bindings[4].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // binding 5 -> per-instance visibility of the previous frame
+    bindings[5].binding = 5;
+    bindings[5].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[5].descriptorCount = 1;
+    bindings[5].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // binding 6 -> culling counters (read back by the CPU)
+    bindings[6].binding = 6;
+    bindings[6].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[6].descriptorCount = 1;
+    bindings[6].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    m_Layout = m_Device->GetStateCache()->GetSetLayout(bindings);
+}
+
+void VulkanGpuCulling::CreateFixedBuffers(FrameResources& frame)
+{
+    VkDevice vkDevice = m_Device->GetHandle();
+    const VkMemoryPropertyFlags hostVisible =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    m_Device->CreateBuffer(
+        sizeof(GpuCullUniforms),
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        hostVisible,
+        frame.uniformBuffer,
+        frame.uniformMemory
+    );
+    vkMapMemory(vkDevice, frame.uniformMemory, 0, sizeof(GpuCullUniforms), 0, &frame.uniformMapped);
+    std::memset(frame.uniformMapped, 0, sizeof(GpuCullUniforms));
+
+    m_Device->CreateBuffer(
+        sizeof(GpuCullingStats),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        hostVisible,
+        frame.statsBuffer,
+        frame.statsMemory
+    );
+    vkMapMemory(vkDevice, frame.statsMemory, 0, sizeof(GpuCullingStats), 0, &frame.statsMapped);
+    std::memset(frame.statsMapped, 0, sizeof(GpuCullingStats));
+}
+
+void VulkanGpuCulling::EnsureInstanceCapacity(uint32_t slotCount)
+{
+    if (slotCount <= m_InstanceCapacity)
+        return;
+
+    // Shared by every frame slot, like the visibility buffer
+    if (m_InstanceBuffer != VK_NULL_HANDLE)
+    {
+        VkDevice vkDevice = m_Device->GetHandle();
+        VkBuffer oldBuffer = m_InstanceBuffer;
+        VkDeviceMemory oldMemory = m_InstanceMemory;
+
+        VulkanTimeline* timeline = m_Device->GetTimeline();
+        timeline->Retire(timeline->GetSubmittedValue(), [vkDevice, oldBuffer, oldMemory]()
+            {
+                vkDestroyBuffer(vkDevice, oldBuffer, nullptr);
+                vkFreeMemory(vkDevice, oldMemory, nullptr);
+            });
+    }
+
+    m_InstanceCapacity = NextCapacity(slotCount, m_InstanceCapacity);
+
+    m_Device->CreateBuffer(
+        VkDeviceSize(m_InstanceCapacity) * sizeof(GpuInstanceData),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        m_InstanceBuffer,
+        m_InstanceMemory
+    );
+
+    // Starts undefined: the next frame uploads every record
+    m_UploadAll = true;
+}
+
+void VulkanGpuCulling::EnsureVisibilityCapacity(uint32_t slotCount)
+{
+    if (slotCount <= m_VisibilityCapacity)
+        return;
+
+    // Shared by every frame slot: frames in flight keep the old buffer
+    // until they complete
+    if (m_VisibilityBuffer != VK_NULL_HANDLE)
+    {
+        VkDevice vkDevice = m_Device->GetHandle();
+        VkBuffer oldBuffer = m_VisibilityBuffer;
+        VkDeviceMemory oldMemory = m_VisibilityMemory;
+
+        VulkanTimeline* timeline = m_Device->GetTimeline();
+        timeline->Retire(timeline->GetSubmittedValue(), [vkDevice, oldBuffer, oldMemory]()
+            {
+                vkDestroyBuffer(vkDevice, oldBuffer, nullptr);
+                vkFreeMemory(vkDevice, oldMemory, nullptr);
+            });
+    }
+
+    m_VisibilityCapacity = NextCapacity(slotCount, m_VisibilityCapacity);
+    VkDeviceSize bytes = VkDeviceSize(m_VisibilityCapacity) * sizeof(uint32_t);
+
+    m_Device->CreateBuffer(
+        bytes,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        m_VisibilityBuffer,
+        m_VisibilityMemory
+    );
+
+    // Start "not visible": the next early cull clears it in the frame's own
+    // command buffer, and the late phase sorts everything out
+    m_VisibilityClearPending = true;
+}
+
+void VulkanGpuCulling::SetDepthPyramid(VulkanDepthPyramid* depthPyramid)
+{
+    // Written into each slot's set from its next Prepare()
+    m_DepthPyramid = depthPyramid;
+}
+
+void VulkanGpuCulling::EnsureCapacity(FrameResources& frame, uint32_t instanceCount, uint32_t batchCount)
+{
+    if (instanceCount <= frame.instanceCapacity && batchCount <= frame.batchCapacity)
+        return;
+
+    // Only called for the current frame slot after it was waited on,
+    // so nothing on the GPU still references these buffers.
+    uint32_t newInstanceCap = NextCapacity(instanceCount, frame.instanceCapacity);
+    uint32_t newBatchCap = NextCapacity(batchCount, frame.batchCapacity);
+
+    DestroyBuffers(frame);
+
+    VkDevice vkDevice = m_Device->GetHandle();
+    const VkMemoryPropertyFlags hostVisible =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    VkDeviceSize drawBytes = VkDeviceSize(newBatchCap) * CULL_PHASE_COUNT * sizeof(VkDrawIndexedIndirectCommand);
+    VkDeviceSize visibleBytes = VkDeviceSize(newInstanceCap) * CULL_PHASE_COUNT * sizeof(uint32_t);
+
+    m_Device->CreateBuffer(
+        drawBytes,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+        hostVisible,
+        frame.drawBuffer,
+        frame.drawMemory
+    );
+    vkMapMemory(vkDevice, frame.drawMemory, 0, drawBytes, 0, &frame.drawMapped);
+
+    m_Device->CreateBuffer(
+        visibleBytes,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        frame.visibleBuffer,
+        frame.visibleMemory
+    );
+
+    frame.instanceCapacity = newInstanceCap;
+    frame.batchCapacity = newBatchCap;
+}
+
+void VulkanGpuCulling::EnsureStagingCapacity(FrameResources& frame, uint32_t recordCount)
+{
+    if (recordCount <= frame.stagingCapacity)
+        return;
+
+    // Current frame slot, after its wait: the old copy source is idle
+    VkDevice vkDevice = m_Device->GetHandle();
+
+    if (frame.stagingMapped) vkUnmapMemory(vkDevice, frame.stagingMemory);
+    if (frame.stagingBuffer) vkDestroyBuffer(vkDevice, frame.stagingBuffer, nullptr);
+    if (frame.stagingMemory) vkFreeMemory(vkDevice, frame.stagingMemory, nullptr);
+
+    frame.stagingCapacity = NextCapacity(recordCount, frame.stagingCapacity);
+    VkDeviceSize bytes = VkDeviceSize(frame.stagingCapacity) * sizeof(GpuInstanceData);
+
+    m_Device->CreateBuffer(
+        bytes,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        frame.stagingBuffer,
+        frame.stagingMemory
+    );
+    vkMapMemory(vkDevice, frame.stagingMemory, 0, bytes, 0, &frame.stagingMapped);
+}
+
+void VulkanGpuCulling::DestroyBuffers(FrameResources& frame)
+{
+    VkDevice vkDevice = m_Device->GetHandle();
+
+    if (frame.drawMapped) vkUnmapMemory(vkDevice, frame.drawMemory);
+
+    if (frame.drawBuffer) vkDestroyBuffer(vkDevice, frame.drawBuffer, nullptr);
+    if (frame.visibleBuffer) vkDestroyBuffer(vkDevice, frame.visibleBuffer, nullptr);
+
+    if (frame.drawMemory) vkFreeMemory(vkDevice, frame.drawMemory, nullptr);
+    if (frame.visibleMemory) vkFreeMemory(vkDevice, frame.visibleMemory, nullptr);
+
+    frame.drawBuffer = frame.visibleBuffer = VK_NULL_HANDLE;
+    frame.drawMemory = frame.visibleMemory = VK_NULL_HANDLE;
+    frame.drawMapped = nullptr;
+    frame.instanceCapacity = frame.batchCapacity = 0;
+}
+
+void VulkanGpuCulling::WriteDescriptorSet(FrameResources& frame)
+{
+    std::array<VkDescriptorBufferInfo, CULL_BINDING_COUNT> infos{};
+    infos[0] = { m_InstanceBuffer, 0, VK_WHOLE_SIZE };
+    infos[1] = { frame.drawBuffer, 0, VK_WHOLE_SIZE };
+    infos[2] = { frame.visibleBuffer, 0, VK_WHOLE_SIZE };
+    infos[3] = { frame.uniformBuffer, 0, sizeof(GpuCullUniforms) };
+    infos[5] = { m_VisibilityBuffer, 0, VK_WHOLE_SIZE };
+    infos[6] = { frame.statsBuffer, 0, sizeof(GpuCullingStats) };
+
+    VkDescriptorImageInfo pyramidInfo{};
+    pyramidInfo.sampler = m_DepthPyramid->GetSampler();
+    pyramidInfo.imageView = m_DepthPyramid->GetView();
+    pyramidInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    std::array<VkWriteDescriptorSet, CULL_BINDING_COUNT> writes{};
+    for (uint32_t i = 0; i < writes.size(); i++)
+    {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = frame.set;
+        writes[i].dstBinding = i;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &infos[i];
+    }
+
+    writes[3].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+    writes[4].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writes[4].pBufferInfo = nullptr;
+    writes[4].pImageInfo = &pyramidInfo;
+
+    vkUpdateDescriptorSets(m_Device->GetHandle(), (uint32_t)writes.size(), writes.data(), 0, nullptr);
+}
+
+// --- Batch table ---
+
+void VulkanGpuCulling::MarkSlotDirty(uint32_t slot)
+{
+    if (m_SlotDirty[slot])
+        return;
+
+    m_SlotDirty[slot] = 1;
+    m_DirtySlots.push_back(slot);
+}
+
+void VulkanGpuCulling::SetSlotBatch(uint32_t slot, uint32_t batchIndex)
+{
+    uint32_t& current = m_SlotBatches[slot];
+
+    if (current != GpuInstanceData::NO_BATCH)
+    {
+        m_InstanceCount--;
+        if (--m_Batches[current].instanceCount == 0)
+            m_EmptyBatches++;
+    }
+
+    if (batchIndex != GpuInstanceData::NO_BATCH)
+    {
+        m_InstanceCount++;
+        if (m_Batches[batchIndex].instanceCount++ == 0)
+            m_EmptyBatches--;
+    }
+
+    current = batchIndex;
+    MarkSlotDirty(slot);
+}
+
+void VulkanGpuCulling::AssignSlot(const Scene& scene, Entity entity, VulkanPipeline* pipeline, const ShaderFeatures& features)
+{
+    const uint32_t slot = entity.GetSlot();
+    if (slot >= m_SlotEntities.size())
+    {
+        m_SlotEntities.resize(slot + 1);
+        m_SlotBatches.resize(slot + 1, GpuInstanceData::NO_BATCH);
+        m_SlotDirty.resize(slot + 1, 0);
+    }
+    m_SlotCount = std::max(m_SlotCount, slot + 1);
+    m_SlotEntities[slot] = entity;
+
+    const uint32_t index = scene.GetIndex(entity);
+    Mesh* mesh = scene.GetMeshes()[index];
+    MaterialInstance* material = scene.GetMaterials()[index];
+
+    uint32_t batchIndex = GpuInstanceData::NO_BATCH;
+    if (mesh && material)
+    {
+        // The requested permutation, compiled or not: drawability is
+        // checked per frame, so the batch survives the compile finishing
+        VulkanPipeline* requested = material->GetPermutation(pipeline, features);
+        BatchKey key{ mesh, requested };
+        auto it = m_BatchLookup.find(key);
+
+        if (it == m_BatchLookup.end())
+        {
+            batchIndex = static_cast<uint32_t>(m_Batches.size());
+            m_BatchLookup.emplace(key, batchIndex);
+
+            CachedBatch batch{};
+            batch.mesh = mesh;
+            batch.requested = requested;
+            batch.alphaTest = material->GetFeatures().alphaTest == VK_TRUE;
+            m_Batches.push_back(batch);
+            m_EmptyBatches++; // until SetSlotBatch() below
+        }
+        else
+        {
+            batchIndex = it->second;
+        }
+    }
+
+    // Also for an object that only moved: its record is re-uploaded
+    SetSlotBatch(slot, batchIndex);
+}
+
+void VulkanGpuCulling::ReleaseSlot(Entity entity)
+{
+    // The slot may already hold a newer object (listed as a change too)
+    const uint32_t slot = entity.GetSlot();
+    if (slot >= m_SlotEntities.size() || m_SlotEntities[slot] != entity)
+        return;
+
+    m_SlotEntities[slot] = Entity{};
+    SetSlotBatch(slot, GpuInstanceData::NO_BATCH);
+}
+
+void VulkanGpuCulling::RebuildBatches(const Scene& scene, VulkanPipeline* pipeline, const ShaderFeatures& features)
+{
+    m_Batches.clear();
+    m_BatchLookup.clear();
+    m_SlotEntities.clear();
+    m_SlotBatches.clear();
+    m_SlotDirty.clear();
+    m_DirtySlots.clear();
+    m_SlotCount = 0;
+    m_InstanceCount = 0;
+    m_EmptyBatches = 0;
+
+    for (Entity entity : scene.GetEntities())
+        AssignSlot(scene, entity, pipeline, features);
+
+    m_BatchPipeline = pipeline;
+    m_BatchFeatures = features;
+    m_SceneEpoch = scene.GetRenderEpoch();
+    m_UploadAll = true;
+}
+
+void VulkanGpuCulling::WriteInstance(GpuInstanceData& inst, uint32_t slot, const Scene& scene, const LightCuller* lightCuller) const
+{
+    const uint32_t batchIndex = m_SlotBatches[slot];
+    if (batchIndex == GpuInstanceData::NO_BATCH)
+    {
+        inst = GpuInstanceData{};
+        inst.info.x = GpuInstanceData::NO_BATCH;
+        return;
+    }
+
+    const uint32_t index = scene.GetIndex(m_SlotEntities[slot]);
+    const AABB& local = scene.GetMeshes()[index]->GetLocalBounds();
+    const glm::mat3& normal = scene.GetNormalMatrices()[index];
+
+    inst.model = scene.GetWorldMatrices()[index];
+    for (int c = 0; c < 3; c++)
+        inst.normalMatrix[c] = glm::vec4(normal[c], 0.0f);
+
+    if (local.IsValid())
+    {
+        BoundingSphere s = BoundingSphere::FromAABB(local).Transformed(inst.model);
+        inst.sphere = glm::vec4(s.center, s.radius);
+    }
+    else
+    {
+        inst.sphere = glm::vec4(0.0f, 0.0f, 0.0f, -1.0f);
+    }
+
+    inst.info = glm::uvec4(batchIndex, scene.GetMaterials()[index]->GetIndex(), 0, 0);
+    inst.lights = lightCuller ? lightCuller->Select(scene.GetWorldBounds()[index]) : glm::uvec4(LightCuller::NO_LIGHT);
+}
+
+// --- Per frame ---
+
+void VulkanGpuCulling::Prepare(
+    uint32_t frameIndex,
+    Scene& scene,
+    VulkanPipeline* pipeline,
+    const ShaderFeatures& sceneFeatures,
+    const glm::mat4& view,
+    const glm::mat4& projection,
+    float zNear,
+    bool occlusion,
+    const LightCuller* lightCuller)
+{
+    PROFILE_CPU_ZONE(m_Device->GetProfiler(), "GPU cull prepare");
+
+    FrameResources& frame = m_Frames[frameIndex];
+
+    // 0) The slot's frame has completed and its counters were read
+    //    (ReadStats) before this: clear them for this frame
+    std::memset(frame.statsMapped, 0, sizeof(GpuCullingStats));
+
+    // 1) Batch table: rebuilt for another scene, pipeline or scene features,
+    //    otherwise patched with the objects the scene reports as changed
+    if (scene.GetRenderEpoch() != m_SceneEpoch || pipeline != m_BatchPipeline || sceneFeatures != m_BatchFeatures)
+    {
+        RebuildBatches(scene, pipeline, sceneFeatures);
+    }
+    else
+    {
+        for (Entity entity : scene.GetRenderChanges())
+        {
+            if (scene.IsAlive(entity))
+                AssignSlot(scene, entity, pipeline, sceneFeatures);
+            else
+                ReleaseSlot(entity);
+        }
+    }
+    scene.ClearRenderChanges();
+
+    // Emptied batches keep their index (records refer to it) and a draw
+    // command each: compact once they pile up
+    if (m_EmptyBatches > std::max<uint32_t>(64, static_cast<uint32_t>(m_Batches.size()) / 2))
+        RebuildBatches(scene, pipeline, sceneFeatures);
+
+    // Per-object light lists follow the camera: every record changes
+    if (lightCuller)
+        m_UploadAll = true;
+
+    const uint32_t drawCount = static_cast<uint32_t>(m_Batches.size());
+    frame.drawCount = drawCount;
+    frame.instanceCount = m_InstanceCount;
+    frame.slotCount = m_SlotCount;
+    frame.uploads.clear();
+
+    EnsureInstanceCapacity(m_SlotCount);
+    EnsureVisibilityCapacity(m_SlotCount);
+    EnsureCapacity(frame, m_InstanceCount, drawCount);
+
+    // A fresh set every frame (the slot's transient pools were reset after its
+    // frame wait), so buffer growth and pyramid changes need no tracking
+    frame.set = m_Device->GetDescriptorAllocator()->AllocateTransient(frameIndex, m_Layout);
+    WriteDescriptorSet(frame);
+
+    frame.occlusion = occlusion && m_DepthPyramid != nullptr;
+
+    // 2) Prefix sum -> each batch owns a contiguous range of the visible list,
+    //    and reset its indirect commands (the cull pass increments instanceCount).
+    //    Late draws use the second half of both buffers. Batches whose
+    //    pipeline is still compiling (and no fallback) are culled, not drawn.
+    auto* draws = static_cast<VkDrawIndexedIndirectCommand*>(frame.drawMapped);
+    uint32_t offset = 0;
+
+    frame.batches.clear();
+    m_OnFallback = false;
+
+    for (uint32_t b = 0; b < drawCount; b++)
+    {
+        const CachedBatch& cached = m_Batches[b];
+        const uint32_t firstInstance = offset;
+        offset += cached.instanceCount;
+
+        // An empty batch's mesh may be gone: never dereferenced
+        const uint32_t indexCount = cached.instanceCount > 0 ? cached.mesh->GetIndexCount() : 0;
+
+        for (uint32_t phase = 0; phase < CULL_PHASE_COUNT; phase++)
+        {
+            VkDrawIndexedIndirectCommand& draw = draws[phase * drawCount + b];
+            draw.indexCount = indexCount;
+            draw.instanceCount = 0;
+            draw.firstIndex = 0;
+            draw.vertexOffset = 0;
+            draw.firstInstance = firstInstance + phase * m_InstanceCount;
+        }
+
+        if (cached.instanceCount == 0)
+            continue;
+
+        VulkanPipeline* drawable = cached.requested->GetDrawable();
+        if (drawable != cached.requested)
+        {
+            m_OnFallback = true;
+            if (!drawable)
+                continue;
+        }
+
+        GpuDrawBatch batch{};
+        batch.mesh = cached.mesh;
+        batch.pipeline = drawable;
+        batch.alphaTest = cached.alphaTest;
+        batch.drawIndex = b;
+        batch.firstInstance = firstInstance;
+        batch.instanceCount = cached.instanceCount;
+        frame.batches.push_back(batch);
+    }
+
+    // 3) Changed instance records -> staging, copied into the instance buffer
+    //    by the early cull. Nothing to cull means no copy: the changes wait.
+    uint32_t uploaded = 0;
+
+    if (m_InstanceCount > 0)
+    {
+        const VkDeviceSize recordSize = sizeof(GpuInstanceData);
+
+        if (m_UploadAll)
+        {
+            EnsureStagingCapacity(frame, m_SlotCount);
+            auto* staging = static_cast<GpuInstanceData*>(frame.stagingMapped);
+
+            for (uint32_t slot = 0; slot < m_SlotCount; slot++)
+                WriteInstance(staging[slot], slot, scene, lightCuller);
+
+            frame.uploads.push_back({ 0, 0, m_SlotCount * recordSize });
+            uploaded = m_SlotCount;
+            m_UploadAll = false;
+        }
+        else if (!m_DirtySlots.empty())
+        {
+            // Sorted: runs of neighbouring slots share one copy region
+            std::sort(m_DirtySlots.begin(), m_DirtySlots.end());
+            EnsureStagingCapacity(frame, static_cast<uint32_t>(m_DirtySlots.size()));
+            auto* staging = static_cast<GpuInstanceData*>(frame.stagingMapped);
+
+            for (uint32_t slot : m_DirtySlots)
+            {
+                WriteInstance(staging[uploaded], slot, scene, lightCuller);
+
+                const VkDeviceSize dstOffset = slot * recordSize;
+                if (!frame.uploads.empty() && frame.uploads.back().dstOffset + frame.uploads.back().size == dstOffset)
+                    frame.uploads.back().size += recordSize;
+                else
+                    frame.uploads.push_back({ uploaded * recordSize, dstOffset, recordSize });
+
+                uploaded++;
+            }
+        }
+
+        for (uint32_t slot : m_DirtySlots)
+            m_SlotDirty[slot] = 0;
+        m_DirtySlots.clear();
+    }
+
+    // 4) Cull uniforms
+    Frustum frustum = Frustum::FromViewProjection(projection * view);
+
+    GpuCullUniforms uniforms{};
+    uniforms.view = view;
+    for (uint32_t i = 0; i < Frustum::Count; i++)
+        uniforms.planes[i] = frustum.planes[i];
+    uniforms.projParams = glm::vec4(projection[0][0], projection[1][1], zNear, 0.0f);
+    uniforms.depthParams = glm::vec4(projection[2][2], projection[3][2], 0.0f, 0.0f);
+
+    if (m_DepthPyramid)
+    {
+        uniforms.pyramid = glm::uvec4(
+            m_DepthPyramid->GetWidth(),
+            m_DepthPyramid->GetHeight(),
+            m_DepthPyramid->GetMipCount(),
+            frame.occlusion ? 1u : 0u
+        );
+    }
+
+    std::memcpy(frame.uniformMapped, &uniforms, sizeof(GpuCullUniforms));
+
+    if (VulkanFrameStats* stats = m_Device->GetFrameStats())
+    {
+        stats->CountUpload(
+            uploaded * sizeof(GpuInstanceData) +
+            CULL_PHASE_COUNT * drawCount * sizeof(VkDrawIndexedIndirectCommand) +
+            sizeof(GpuCullUniforms));
+    }
+}
+
+void VulkanGpuCulling::RecordCull(VkCommandBuffer cmd, uint32_t frameIndex, GpuCullPhase phase)
+{
+    const FrameResources& frame = m_Frames[frameIndex];
+    if (frame.instanceCount == 0)
+        return;
+
+    if (phase == GpuCullPhase::Late && !frame.occlusion)
+        return;
+
+    PROFILE_GPU_SCOPE(m_Device->GetProfiler(), cmd, phase == GpuCullPhase::Early ? "Cull (early)" : "Cull (late)");
+
+    GpuCullPushConstants pc{};
+    pc.slotCount = frame.slotCount;
+    pc.batchCount = frame.drawCount;
+    pc.phase = static_cast<uint32_t>(phase);
+
+    VkPipelineStageFlags priorStages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    VkAccessFlags priorAccess = VK_ACCESS_SHADER_WRITE_BIT;
+    VkPipelineStageFlags readStages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    // Changed instance records. Earlier frames may still read the shared
+    // buffer (cull + vertex) or copy into it: wait for them first.
+    if (!frame.uploads.empty() && phase == GpuCullPhase::Early)
+    {
+        VkMemoryBarrier before{};
+        before.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        before.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        before.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+        vkCmdPipelineBarrier(
+            cmd,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            1, &before,
+            0, nullptr,
+            0, nullptr
+        );
+
+        vkCmdCopyBuffer(cmd, frame.stagingBuffer, m_InstanceBuffer,
+            static_cast<uint32_t>(frame.uploads.size()), frame.uploads.data());
+
+        priorStages |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+        priorAccess |= VK_ACCESS_TRANSFER_WRITE_BIT;
+        readStages |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+    }
+
+    // A new visibility buffer starts zeroed (see EnsureVisibilityCapacity)
+    if (m_VisibilityClearPending && phase == GpuCullPhase::Early)
+    {
+        vkCmdFillBuffer(cmd, m_VisibilityBuffer, 0, VK_WHOLE_SIZE, 0);
+        m_VisibilityClearPending = false;
+
+        priorStages |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+        priorAccess |= VK_ACCESS_TRANSFER_WRITE_BIT;
+    }
+
+    // Visibility + counters were written by the previous cull dispatch
+    // (earlier phase, or the previous frame on this queue), the clear or
+    // the instance copy
+    VkMemoryBarrier prior{};
+    prior.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    prior.srcAccessMask = priorAccess;
+    prior.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(
+        cmd,
+        priorStages,
+        readStages,
+        0,
+        1, &prior,
+        0, nullptr,
+        0, nullptr
+    );
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_CullPipeline->GetHandle());
+
+    vkCmdBindDescriptorSets(
+        cmd,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        m_CullPipeline->GetLayout(),
+        0,
+        1,
+        &frame.set,
+        0,
+        nullptr
+    );
+
+    vkCmdPushConstants(
+        cmd,
+        m_CullPipeline->GetLayout(),
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(GpuCullPushConstants),
+        &pc
+    );
+
+    uint32_t groups = (frame.slotCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE;
+    vkCmdDispatch(cmd, groups, 1, 1);
+
+    if (VulkanFrameStats* stats = m_Device->GetFrameStats())
+    {
+        stats->CountPipelineBinds(1);
+        stats->CountDescriptorBinds(1);
+        stats->CountPushConstants(1);
+    }
+
+    // Cull writes -> indirect command read + vertex shader SSBO read + stats readback
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask =
+        VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        1, &barrier,
+        0, nullptr,
+        0, nullptr
+    );
+}
+
+void VulkanGpuCulling::RecordDraws(
+    VkCommandBuffer cmd,
+    uint32_t frameIndex,
+    GpuCullPhase phase,
+    VkDescriptorSet globalSet,
+    VkDescriptorSet materialSet) const
+{
+    const FrameResources& frame = m_Frames[frameIndex];
+    const VkDeviceSize stride = sizeof(VkDrawIndexedIndirectCommand);
+
+    if (phase == GpuCullPhase::Late && !frame.occlusion)
+        return;
+
+    PROFILE_GPU_SCOPE(m_Device->GetProfiler(), cmd, phase == GpuCullPhase::Early ? "Draws (early)" : "Draws (late)");
+
+    const uint32_t drawBase = (phase == GpuCullPhase::Late) ? frame.drawCount : 0;
+
+    VulkanPipeline* bound = nullptr;
+    uint32_t pipelineBinds = 0;
+
+    for (size_t b = 0; b < frame.batches.size(); b++)
+    {
+        const GpuDrawBatch& batch = frame.batches[b];
+
+        if (batch.pipeline != bound)
+        {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, batch.pipeline->GetHandle());
+            bound = batch.pipeline;
+            pipelineBinds++;
+
+            // set 0 = scene UBO, set 1 = material table, set 2 = instances + visible list
+            VkDescriptorSet sets[] = { globalSet, materialSet, frame.set };
+
+            vkCmdBindDescriptorSets(
+                cmd,
+                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                batch.pipeline->GetLayout(),
+                0,
+                3,
+                sets,
+                0,
+                nullptr
+            );
+        }
+
+        batch.mesh->Bind(cmd);
+        vkCmdDrawIndexedIndirect(cmd, frame.drawBuffer, (drawBase + batch.drawIndex) * stride, 1, (uint32_t)stride);
+    }
+
+    // Instances / triangles drawn are decided on the GPU: FrameStats fills them later
+    if (VulkanFrameStats* stats = m_Device->GetFrameStats())
+    {
+        const uint32_t batches = static_cast<uint32_t>(frame.batches.size());
+        stats->CountDraws(batches, 0, 0);
+        stats->CountPipelineBinds(pipelineBinds);
+        stats->CountDescriptorBinds(pipelineBinds);
+    }
+}
+
+void VulkanGpuCulling::RecordDepthDraws(
+    VkCommandBuffer cmd,
+    uint32_t frameIndex,
+    GpuCullPhase phase,
+    VkDescriptorSet globalSet,
+    VkDescriptorSet materialSet,
+    VulkanPipeline* depthPipeline,
+    VulkanPipeline* alphaPipeline) const
+{
+    const FrameResources& frame = m_Frames[frameIndex];
+    const VkDeviceSize stride = sizeof(VkDrawIndexedIndirectCommand);
+
+    if (phase == GpuCullPhase::Late && !frame.occlusion)
+        return;
+
+    PROFILE_GPU_SCOPE(m_Device->GetProfiler(), cmd, phase == GpuCullPhase::Early ? "Depth pre-pass (early)" : "Depth pre-pass (late)");
+
+    const uint32_t drawBase = (phase == GpuCullPhase::Late) ? frame.drawCount : 0;
+
+    VulkanPipeline* bound = nullptr;
+    uint32_t pipelineBinds = 0;
+
+    for (size_t b = 0; b < frame.batches.size(); b++)
+    {
+        const GpuDrawBatch& batch = frame.batches[b];
+        VulkanPipeline* pipeline = batch.alphaTest ? alphaPipeline : depthPipeline;
+
+        if (pipeline != bound)
+        {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->GetHandle());
+            bound = pipeline;
+            pipelineBinds++;
+
+            // Same layout as the lit pipelines: set 1 is bound but only read by alphaPipeline
+            VkDescriptorSet sets[] = { globalSet, materialSet, frame.set };
+
+            vkCmdBindDescriptorSets(
+                cmd,
+                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                pipeline->GetLayout(),
+                0,
+                3,
+                sets,
+                0,
+                nullptr
+            );
+        }
+
+        if (batch.alphaTest)
+            batch.mesh->Bind(cmd);
+        else
+            batch.mesh->BindPositions(cmd);
+
+        vkCmdDrawIndexedIndirect(cmd, frame.drawBuffer, (drawBase + batch.drawIndex) * stride, 1, (uint32_t)stride);
+    }
+
+    if (VulkanFrameStats* stats = m_Device->GetFrameStats())
+    {
+        const uint32_t batches = static_cast<uint32_t>(frame.batches.size());
+        stats->CountDraws(batches, 0, 0);
+        stats->CountPipelineBinds(pipelineBinds);
+        stats->CountDescriptorBinds(pipelineBinds);
+    }
+}
+
+GpuCullingStats VulkanGpuCulling::ReadStats(uint32_t frameIndex) const
+{
+    // The cull pass ends with a shader-write -> host-read barrier
+    GpuCullingStats stats;
+    std::memcpy(&stats, m_Frames[frameIndex].statsMapped, sizeof(GpuCullingStats));
+    return stats;
+}
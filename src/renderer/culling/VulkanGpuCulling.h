@@ -0,0 +1,283 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+
+#include "renderer/EntityStore.h"
+#include "renderer/Frustum.h"
+#include "renderer/ShaderFeatures.h"
+
+class VulkanDevice;
+class VulkanComputePipeline;
+class VulkanDepthPyramid;
+class VulkanPipeline;
+class Mesh;
+class MaterialInstance;
+class Scene;
+class LightCuller;
+
+// std430 mirror of InstanceData in cull.comp / lighting_indirect.vert (160 bytes).
+// One per entity slot; slots without a drawable object have batch NO_BATCH.
+struct GpuInstanceData
+{
+    static constexpr uint32_t NO_BATCH = UINT32_MAX;
+
+    glm::mat4  model;
+    glm::vec4  normalMatrix[3]; // inverse-transpose columns (w unused), std430 mat3 layout
+    glm::vec4  sphere;   // world-space center (xyz) + radius (w), radius < 0 = never culled
+    glm::uvec4 info;     // x = batch index (or NO_BATCH), y = material index (material table)
+    glm::uvec4 lights;   // LightCuller entries (OBJECT_LIGHT_LISTS only)
+};
+
+// std140 mirror of CullUniforms in cull.comp (208 bytes)
+struct GpuCullUniforms
+{
+    glm::mat4  view;
+    glm::vec4  planes[Frustum::Count];
+    glm::vec4  projParams;  // P00, P11, znear, -
+    glm::vec4  depthParams; // P22, P32
+    glm::uvec4 pyramid;     // width, height, mip count, occlusion enabled
+};
+
+// Push constants of cull.comp (16 bytes)
+struct GpuCullPushConstants
+{
+    uint32_t slotCount = 0;  // instance records to test
+    uint32_t batchCount = 0; // draw commands per phase
+    uint32_t phase = 0;
+    uint32_t padding = 0;
+};
+
+// Early: frustum + "visible last frame", drawn before the Hi-Z pyramid is built.
+// Late:  frustum + Hi-Z occlusion, draws what became visible this frame.
+enum class GpuCullPhase : uint32_t
+{
+    Early = 0,
+    Late = 1
+};
+
+// Written by cull.comp, read back once the frame slot has completed
+struct GpuCullingStats
+{
+    uint32_t frustumCulled = 0;
+    uint32_t occlusionCulled = 0;
+    uint32_t drawnEarly = 0;
+    uint32_t drawnLate = 0;
+};
+
+// One indirect draw = all instances of one mesh under one shader permutation,
+// whatever their materials (bindless: each instance carries its material index).
+// The compute pass fills instanceCount and the visible-instance list.
+struct GpuDrawBatch
+{
+    Mesh* mesh = nullptr;
+    VulkanPipeline* pipeline = nullptr;
+    bool alphaTest = false; // permutation discards (depth pre-pass needs albedo)
+
+    uint32_t drawIndex = 0;     // draw command of the batch within a phase
+    uint32_t firstInstance = 0; // offset into the visible-instance list
+    uint32_t instanceCount = 0; // instances submitted (before culling)
+};
+
+// GPU-driven frustum + two-phase Hi-Z occlusion culling:
+//  - instance records (transform, bounds, batch) live in a device-local SSBO
+//    indexed by entity slot; each frame copies in only the records of objects
+//    the scene reports as changed, and the batch table is kept up to date from
+//    the same changes, so the CPU cost follows what changed, not the scene size
+//  - cull.comp tests every slot and compacts survivors per batch with an atomic counter
+//  - the graphics pass draws each batch with vkCmdDrawIndexedIndirect
+//  - with occlusion on, a per-entity visibility buffer carries last frame's
+//    result into the early phase, so nothing pops when the camera moves
+class VulkanGpuCulling
+{
+public:
+    VulkanGpuCulling(VulkanDevice* device, uint32_t framesInFlight, VulkanDepthPyramid* depthPyramid);
+    ~VulkanGpuCulling();
+
+    // set = 2 of the indirect graphics pipeline (instances + visible list)
+    VkDescriptorSetLayout GetLayout() const { return m_Layout; }
+
+    // Re-points binding 4 at a (re)created pyramid. Each slot picks it up in
+    // its next Prepare(), so in-flight frames keep the old pyramid (retire it
+    // after them).
+    void SetDepthPyramid(VulkanDepthPyramid* depthPyramid);
+
+    // CPU side: applies the scene's render changes (and consumes them) to the
+    // batch table and instance records, stages the changed records, writes
+    // draw commands and cull uniforms for this frame slot. After Scene::Update().
+    // Clears the slot's stats and allocates its set from the slot's transient
+    // descriptor pools (reset them first, see VulkanDescriptorAllocator).
+    // Each batch draws with its material's permutation of pipeline; another
+    // pipeline or sceneFeatures rebuilds the batch table.
+    // lightCuller (optional, after its Cull()): fills each instance's light
+    // list. The lists follow the camera, so every record is uploaded each frame.
+    void Prepare(
+        uint32_t frameIndex,
+        Scene& scene,
+        VulkanPipeline* pipeline,
+        const ShaderFeatures& sceneFeatures,
+        const glm::mat4& view,
+        const glm::mat4& projection,
+        float zNear,
+        bool occlusion,
+        const LightCuller* lightCuller = nullptr);
+
+    // The last Prepare() drew some batches with a fallback, or skipped them (still compiling)
+    bool IsOnFallback() const { return m_OnFallback; }
+
+    // Outside the render pass: dispatch culling + barrier to indirect/vertex stages
+    void RecordCull(VkCommandBuffer cmd, uint32_t frameIndex, GpuCullPhase phase);
+
+    // Inside the render pass: one indirect draw per batch.
+    // materialSet: the bindless material table (set 1)
+    void RecordDraws(
+        VkCommandBuffer cmd,
+        uint32_t frameIndex,
+        GpuCullPhase phase,
+        VkDescriptorSet globalSet,
+        VkDescriptorSet materialSet) const;
+
+    // Inside the render pass, before RecordDraws(): the same indirect draws,
+    // depth only. Batches of alpha-tested materials use alphaPipeline (full
+    // vertex stream + material table), the rest depthPipeline (positions only).
+    void RecordDepthDraws(
+        VkCommandBuffer cmd,
+        uint32_t frameIndex,
+        GpuCullPhase phase,
+        VkDescriptorSet globalSet,
+        VkDescriptorSet materialSet,
+        VulkanPipeline* depthPipeline,
+        VulkanPipeline* alphaPipeline) const;
+
+    uint32_t GetInstanceCount(uint32_t frameIndex) const { return m_Frames[frameIndex].instanceCount; }
+    uint32_t GetBatchCount(uint32_t frameIndex) const { return static_cast<uint32_t>(m_Frames[frameIndex].batches.size()); }
+
+    // The slot's last frame, read straight from its counters: valid after the
+    // slot's frame wait and before Prepare() clears them
+    GpuCullingStats ReadStats(uint32_t frameIndex) const;
+
+private:
+    struct FrameResources
+    {
+        VkBuffer       stagingBuffer = VK_NULL_HANDLE; // changed instance records, copied by the early cull
+        VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+        void*          stagingMapped = nullptr;
+        uint32_t       stagingCapacity = 0;            // records
+        std::vector<VkBufferCopy> uploads;             // staging -> instance buffer
+
+        VkBuffer       drawBuffer = VK_NULL_HANDLE;   // VkDrawIndexedIndirectCommand per batch and phase
+        VkDeviceMemory drawMemory = VK_NULL_HANDLE;
+        void*          drawMapped = nullptr;
+
+        VkBuffer       visibleBuffer = VK_NULL_HANDLE; // compacted instance ids (GPU only), per phase
+        VkDeviceMemory visibleMemory = VK_NULL_HANDLE;
+
+        VkBuffer       uniformBuffer = VK_NULL_HANDLE;  // GpuCullUniforms
+        VkDeviceMemory uniformMemory = VK_NULL_HANDLE;
+        void*          uniformMapped = nullptr;
+
+        VkBuffer       statsBuffer = VK_NULL_HANDLE;    // GpuCullingStats
+        VkDeviceMemory statsMemory = VK_NULL_HANDLE;
+        void*          statsMapped = nullptr;
+
+        uint32_t instanceCapacity = 0;
+        uint32_t batchCapacity = 0;
+
+        VkDescriptorSet set = VK_NULL_HANDLE; // transient, allocated by Prepare()
+
+        std::vector<GpuDrawBatch> batches; // drawable this frame
+        uint32_t drawCount = 0;            // draw commands per phase (every cached batch)
+        uint32_t instanceCount = 0;
+        uint32_t slotCount = 0;
+        bool occlusion = false;
+    };
+
+    // Cached batch. Batch indices are stable until the table is rebuilt:
+    // instance records refer to them.
+    struct CachedBatch
+    {
+        Mesh* mesh = nullptr;
+        VulkanPipeline* requested = nullptr; // permutation, possibly still compiling
+        bool alphaTest = false;
+        uint32_t instanceCount = 0;
+    };
+
+    // Requested permutation, not the drawable one: instances whose
+    // permutations share a fallback still get their own batches
+    struct BatchKey
+    {
+        const Mesh* mesh;
+        const VulkanPipeline* pipeline;
+        bool operator==(const BatchKey& o) const { return mesh == o.mesh && pipeline == o.pipeline; }
+    };
+
+    struct BatchKeyHash
+    {
+        size_t operator()(const BatchKey& k) const
+        {
+            size_t h = std::hash<const void*>()(k.mesh);
+            return h ^ (std::hash<const void*>()(k.pipeline) + 0x9e3779b9 + (h << 6) + (h >> 2));
+        }
+    };
+
+    void CreateLayout();
+    void CreateFixedBuffers(FrameResources& frame);
+    void EnsureCapacity(FrameResources& frame, uint32_t instanceCount, uint32_t batchCount);
+    void EnsureStagingCapacity(FrameResources& frame, uint32_t recordCount);
+    void EnsureInstanceCapacity(uint32_t slotCount);
+    void EnsureVisibilityCapacity(uint32_t slotCount);
+    void DestroyBuffers(FrameResources& frame);
+    void WriteDescriptorSet(FrameResources& frame);
+
+    // Batch table upkeep; each marks the slot's record for upload
+    void RebuildBatches(const Scene& scene, VulkanPipeline* pipeline, const ShaderFeatures& features);
+    void AssignSlot(const Scene& scene, Entity entity, VulkanPipeline* pipeline, const ShaderFeatures& features);
+    void ReleaseSlot(Entity entity);
+    void SetSlotBatch(uint32_t slot, uint32_t batchIndex);
+    void MarkSlotDirty(uint32_t slot);
+
+    void WriteInstance(GpuInstanceData& inst, uint32_t slot, const Scene& scene, const LightCuller* lightCuller) const;
+
+private:
+    VulkanDevice* m_Device = nullptr;
+
+    VkDescriptorSetLayout m_Layout = VK_NULL_HANDLE; // shared (state cache)
+
+    VulkanComputePipeline* m_CullPipeline = nullptr; // shared (state cache)
+    bool m_OnFallback = false;
+
+    std::vector<FrameResources> m_Frames;
+
+    VulkanDepthPyramid* m_DepthPyramid = nullptr;
+
+    // Shared by all frame slots: the GPU consumes frames in submission order
+    VkBuffer       m_InstanceBuffer = VK_NULL_HANDLE; // GpuInstanceData by entity slot
+    VkDeviceMemory m_InstanceMemory = VK_NULL_HANDLE;
+    uint32_t       m_InstanceCapacity = 0; // entity slots
+    bool           m_UploadAll = true;     // next frame uploads every record
+
+    VkBuffer       m_VisibilityBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_VisibilityMemory = VK_NULL_HANDLE;
+    uint32_t       m_VisibilityCapacity = 0;  // entity slots
+    bool           m_VisibilityClearPending = false; // zero-filled by the next early cull
+
+
+    // Batch table and what it was built for
+    std::vector<CachedBatch> m_Batches;
+    std::unordered_map<BatchKey, uint32_t, BatchKeyHash> m_BatchLookup;
+    const VulkanPipeline* m_BatchPipeline = nullptr;
+    ShaderFeatures m_BatchFeatures{};
+    uint32_t m_SceneEpoch = UINT32_MAX;
+    uint32_t m_InstanceCount = 0; // slots with a batch
+    uint32_t m_EmptyBatches = 0;  // cached batches left without instances
+
+    // By entity slot
+    std::vector<Entity>   m_SlotEntities; // object the record was built from (null: none)
+    std::vector<uint32_t> m_SlotBatches;  // NO_BATCH: nothing drawn
+    std::vector<uint8_t>  m_SlotDirty;    // listed in m_DirtySlots
+    std::vector<uint32_t> m_DirtySlots;
+    uint32_t m_SlotCount = 0;             // highest slot in use + 1
+};
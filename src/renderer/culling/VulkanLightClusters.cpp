@@ -0,0 +1,145 @@
+#include "VulkanLightClusters.h"
+
+#include "renderer/VulkanDevice.h"
+#include "renderer/VulkanProfiler.h"
+#include "renderer/VulkanFrameStats.h"
+#include "renderer/pipeline/VulkanStateCache.h"
+#include "renderer/pipeline/VulkanComputePipeline.h"
+#include "core/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static constexpr uint32_t CLUSTER_GROUP_SIZE = 128; // must match local_size_x in light_cluster.comp
+
+VulkanLightClusters::VulkanLightClusters(VulkanDevice* device, uint32_t framesInFlight, VkDescriptorSetLayout globalLayout)
+    : m_Device(device)
+{
+    m_BuildPipeline = m_Device->GetStateCache()->GetComputePipeline({
+        { globalLayout },
+        "shaders/light_cluster.comp.spv",
+        0
+    });
+
+    VkDevice vkDevice = m_Device->GetHandle();
+    const VkMemoryPropertyFlags hostVisible =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    const VkDeviceSize clusterBytes = VkDeviceSize(CLUSTER_COUNT) * CLUSTER_STRIDE * sizeof(uint32_t);
+
+    m_Frames.resize(framesInFlight);
+    for (FrameResources& frame : m_Frames)
+    {
+        m_Device->CreateBuffer(
+            sizeof(GpuClusterUniforms),
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            hostVisible,
+            frame.uniformBuffer,
+            frame.uniformMemory
+        );
+        vkMapMemory(vkDevice, frame.uniformMemory, 0, sizeof(GpuClusterUniforms), 0, &frame.uniformMapped);
+        std::memset(frame.uniformMapped, 0, sizeof(GpuClusterUniforms));
+
+        m_Device->CreateBuffer(
+            clusterBytes,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            frame.clusterBuffer,
+            frame.clusterMemory
+        );
+    }
+
+    LOG_INFO("Light clusters initialized (" + std::to_string(TILES_X) + "x" + std::to_string(TILES_Y) +
+        "x" + std::to_string(DEPTH_SLICES) + ", up to " + std::to_string(MAX_LIGHTS_PER_CLUSTER) + " lights each).");
+}
+
+VulkanLightClusters::~VulkanLightClusters()
+{
+    VkDevice vkDevice = m_Device->GetHandle();
+
+    for (FrameResources& frame : m_Frames)
+    {
+        if (frame.uniformMapped) vkUnmapMemory(vkDevice, frame.uniformMemory);
+
+        if (frame.uniformBuffer) vkDestroyBuffer(vkDevice, frame.uniformBuffer, nullptr);
+        if (frame.clusterBuffer) vkDestroyBuffer(vkDevice, frame.clusterBuffer, nullptr);
+
+        if (frame.uniformMemory) vkFreeMemory(vkDevice, frame.uniformMemory, nullptr);
+        if (frame.clusterMemory) vkFreeMemory(vkDevice, frame.clusterMemory, nullptr);
+    }
+}
+
+void VulkanLightClusters::Prepare(
+    uint32_t frameIndex,
+    uint32_t pointLightCount,
+    const glm::mat4& view,
+    const glm::mat4& projection,
+    float zNear,
+    float zFar,
+    VkExtent2D extent)
+{
+    FrameResources& frame = m_Frames[frameIndex];
+
+    GpuClusterUniforms uniforms{};
+    uniforms.view = view;
+    uniforms.projParams = glm::vec4(projection[0][0], projection[1][1], zNear, zFar);
+    // Exact (fractional) tile size: light_cluster.comp builds tile c over
+    // NDC [c, c + 1] / TILES, so the fragment lookup must split the screen
+    // the same way
+    uniforms.sliceParams = glm::vec4(
+        float(DEPTH_SLICES) / std::log(zFar / zNear),
+        float(std::max(extent.width, 1u)) / float(TILES_X),
+        float(std::max(extent.height, 1u)) / float(TILES_Y),
+        0.0f);
+    uniforms.grid = glm::uvec4(TILES_X, TILES_Y, DEPTH_SLICES, pointLightCount);
+
+    std::memcpy(frame.uniformMapped, &uniforms, sizeof(uniforms));
+
+    if (VulkanFrameStats* stats = m_Device->GetFrameStats())
+        stats->CountUpload(sizeof(uniforms));
+}
+
+void VulkanLightClusters::RecordBuild(VkCommandBuffer cmd, VkDescriptorSet globalSet) const
+{
+    PROFILE_GPU_SCOPE(m_Device->GetProfiler(), cmd, "Light clusters");
+
+    // Per-slot buffers: the slot's previous frame has completed, nothing to wait for
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_BuildPipeline->GetHandle());
+
+    vkCmdBindDescriptorSets(
+        cmd,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        m_BuildPipeline->GetLayout(),
+        0,
+        1,
+        &globalSet,
+        0,
+        nullptr
+    );
+
+    const uint32_t groups = (CLUSTER_COUNT + CLUSTER_GROUP_SIZE - 1) / CLUSTER_GROUP_SIZE;
+    vkCmdDispatch(cmd, groups, 1, 1);
+
+    if (VulkanFrameStats* stats = m_Device->GetFrameStats())
+    {
+        stats->CountPipelineBinds(1);
+        stats->CountDescriptorBinds(1);
+    }
+
+    // Cluster lists -> fragment shader reads
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0,
+        1, &barrier,
+        0, nullptr,
+        0, nullptr
+    );
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+#include "lighting/LightingLimits.h"
+
+class VulkanDevice;
+class VulkanComputePipeline;
+
+// std140 mirror of ClusterUniforms in light_cluster.comp / lighting.frag (112 bytes)
+struct GpuClusterUniforms
+{
+    glm::mat4  view;
+    glm::vec4  projParams;  // P00, P11, znear, zfar
+    glm::vec4  sliceParams; // slices / log(zfar / znear), tile width px, tile height px, -
+    glm::uvec4 grid;        // tiles x, tiles y, depth slices, point light count
+};
+
+// Clustered forward light culling. The view frustum is split into froxels
+// (screen tiles x exponential depth slices); each frame light_cluster.comp
+// tests every point light's sphere against every froxel's view-space box and
+// writes per-froxel light index lists. lighting.frag finds its froxel from
+// gl_FragCoord + view depth and only shades the lights listed there, so the
+// per-fragment cost depends on local light density, not the light count.
+// Its buffers are bindings 1 + 3 of the global set 0 (VulkanDescriptors),
+// the point lights binding 2 (VulkanLightStorage); the compute pass binds
+// that same set.
+class VulkanLightClusters
+{
+public:
+    static constexpr uint32_t TILES_X = 16;
+    static constexpr uint32_t TILES_Y = 9;
+    static constexpr uint32_t DEPTH_SLICES = 24;
+    static constexpr uint32_t CLUSTER_COUNT = TILES_X * TILES_Y * DEPTH_SLICES;
+
+    // Per cluster: light count, then up to MAX_LIGHTS_PER_CLUSTER indices
+    static constexpr uint32_t CLUSTER_STRIDE = MAX_LIGHTS_PER_CLUSTER + 1;
+
+    // globalLayout: set 0 layout, the compute pipeline's only set
+    VulkanLightClusters(VulkanDevice* device, uint32_t framesInFlight, VkDescriptorSetLayout globalLayout);
+    ~VulkanLightClusters();
+
+    // CPU side: this slot's cluster uniforms (the slot's last frame has
+    // completed). pointLightCount: lights in the slot's point light buffer.
+    void Prepare(
+        uint32_t frameIndex,
+        uint32_t pointLightCount,
+        const glm::mat4& view,
+        const glm::mat4& projection,
+        float zNear,
+        float zFar,
+        VkExtent2D extent);
+
+    // Outside the render pass: bin lights into clusters + barrier to fragment reads.
+    // globalSet: this slot's set 0
+    void RecordBuild(VkCommandBuffer cmd, VkDescriptorSet globalSet) const;
+
+    // Bound as set 0 bindings 1 (uniforms) and 3 (cluster lists)
+    VkBuffer GetUniformBuffer(uint32_t frameIndex) const { return m_Frames[frameIndex].uniformBuffer; }
+    VkBuffer GetClusterBuffer(uint32_t frameIndex) const { return m_Frames[frameIndex].clusterBuffer; }
+
+private:
+    struct FrameResources
+    {
+        VkBuffer       uniformBuffer = VK_NULL_HANDLE; // GpuClusterUniforms
+        VkDeviceMemory uniformMemory = VK_NULL_HANDLE;
+        void*          uniformMapped = nullptr;
+
+        VkBuffer       clusterBuffer = VK_NULL_HANDLE; // counts + indices (GPU only)
+        VkDeviceMemory clusterMemory = VK_NULL_HANDLE;
+    };
+
+private:
+    VulkanDevice* m_Device = nullptr;
+
+    VulkanComputePipeline* m_BuildPipeline = nullptr; // shared (state cache)
+
+    std::vector<FrameResources> m_Frames;
+};
@@ -0,0 +1,83 @@
+#include "VulkanComputePipeline.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanStateCache.h"
+
+#include "renderer/VulkanDevice.h"
+#include "core/Logger.h"
+
+#include <stdexcept>
+
+size_t ComputePipelineDesc::Hash() const
+{
+    size_t hash = std::hash<std::string>()(compSpv);
+    for (VkDescriptorSetLayout layout : setLayouts)
+        HashCombine(hash, reinterpret_cast<uintptr_t>(layout));
+    HashCombine(hash, pushConstantSize);
+    return hash;
+}
+
+VulkanComputePipeline::VulkanComputePipeline(VulkanDevice* device, const ComputePipelineDesc& desc)
+    : m_Device(device)
+{
+    VkDevice vkDevice = m_Device->GetHandle();
+    VulkanStateCache* states = m_Device->GetStateCache();
+
+    VkShaderModule compModule = VK_NULL_HANDLE;
+
+    try
+    {
+        compModule = states->GetShaderModule(desc.compSpv);
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR(e.what());
+        throw;
+    }
+
+    // --- Push constants (optional) ---
+    std::vector<VkPushConstantRange> pushRanges;
+    if (desc.pushConstantSize > 0)
+    {
+        VkPushConstantRange pushRange{};
+        pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushRange.offset = 0;
+        pushRange.size = desc.pushConstantSize;
+        pushRanges.push_back(pushRange);
+    }
+
+    // --- Pipeline layout (shared) ---
+    m_PipelineLayout = states->GetPipelineLayout(desc.setLayouts, pushRanges);
+
+    // --- Compute pipeline ---
+    VkPipelineShaderStageCreateInfo stage{};
+    stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    stage.module = compModule;
+    stage.pName = "main";
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = stage;
+    pipelineInfo.layout = m_PipelineLayout;
+
+    VulkanPipelineCache* cache = m_Device->GetPipelineCache();
+    VkResult result = cache
+        ? cache->CreateComputePipeline(pipelineInfo, &m_Pipeline)
+        : vkCreateComputePipelines(vkDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline);
+
+    if (result != VK_SUCCESS)
+    {
+        LOG_ERROR("Failed to create compute pipeline!");
+        throw std::runtime_error("Compute pipeline creation failed.");
+    }
+
+    LOG_INFO("Compute pipeline created: " + desc.compSpv);
+}
+
+VulkanComputePipeline::~VulkanComputePipeline()
+{
+    VkDevice vkDevice = m_Device->GetHandle();
+
+    if (m_Pipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(vkDevice, m_Pipeline, nullptr);
+}
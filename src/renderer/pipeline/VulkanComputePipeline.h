@@ -0,0 +1,36 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class VulkanDevice;
+
+// Hashed by VulkanStateCache, like GraphicsPipelineDesc
+struct ComputePipelineDesc
+{
+    std::vector<VkDescriptorSetLayout> setLayouts;
+    std::string compSpv;
+    uint32_t pushConstantSize = 0;
+
+    bool operator==(const ComputePipelineDesc& other) const = default;
+    size_t Hash() const;
+};
+
+class VulkanComputePipeline
+{
+public:
+    // Prefer VulkanStateCache::GetComputePipeline(), which owns the result
+    VulkanComputePipeline(VulkanDevice* device, const ComputePipelineDesc& desc);
+
+    ~VulkanComputePipeline();
+
+    VkPipeline       GetHandle() const { return m_Pipeline; }
+    VkPipelineLayout GetLayout() const { return m_PipelineLayout; }
+
+private:
+    VulkanDevice* m_Device = nullptr;
+
+    VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE; // shared, owned by the state cache
+    VkPipeline       m_Pipeline = VK_NULL_HANDLE;
+};
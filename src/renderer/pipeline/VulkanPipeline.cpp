@@ -1,70 +1,71 @@
 #include "VulkanPipeline.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanStateCache.h"
 
 #include "renderer/VulkanDevice.h"
-#include "renderer/VulkanSwapchain.h"
-#include "renderer/VulkanRenderPass.h"
 #include "core/Logger.h"
 #include "renderer/PushConstants.h"
 
 #include "renderer/Vertex3D.h"
 
 #include <cstddef>   // offsetof
-#include <fstream>
 #include <vector>
 #include <stdexcept>
 #include <array>
 
-static std::vector<char> ReadFileBinary(const std::string& filename)
+size_t GraphicsPipelineDesc::Hash() const
 {
-    std::ifstream file(filename, std::ios::ate | std::ios::binary);
-    if (!file.is_open())
-        throw std::runtime_error("Failed to open file: " + filename);
-
-    size_t fileSize = (size_t)file.tellg();
-    std::vector<char> buffer(fileSize);
-
-    file.seekg(0);
-    file.read(buffer.data(), fileSize);
-    file.close();
-    return buffer;
+    size_t hash = std::hash<std::string>()(vertSpv);
+    HashCombine(hash, std::hash<std::string>()(fragSpv));
+    HashCombine(hash, reinterpret_cast<uintptr_t>(renderPass));
+    for (uint32_t constant : fragConstants)
+        HashCombine(hash, constant);
+    for (VkDescriptorSetLayout layout : setLayouts)
+        HashCombine(hash, reinterpret_cast<uintptr_t>(layout));
+    HashCombine(hash, cullMode);
+    HashCombine(hash, depthWrite);
+    HashCombine(hash, depthCompare);
+    HashCombine(hash, static_cast<uint32_t>(vertexInput));
+    HashCombine(hash, colorWrite);
+    return hash;
 }
 
-VkShaderModule VulkanPipeline::CreateShaderModule(VkDevice device, const std::string& spvPath)
+VulkanPipeline::VulkanPipeline(VulkanDevice* device, const GraphicsPipelineDesc& desc, bool deferCompile)
+    : m_Device(device), m_Desc(desc)
 {
-    std::vector<char> code = ReadFileBinary(spvPath);
+    VulkanStateCache* states = m_Device->GetStateCache();
 
-    VkShaderModuleCreateInfo createInfo{};
-    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = code.size();
-    createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+    // The layout exists right away: descriptor sets can be bound against it
+    // (and a fallback checked for compatibility) before the pipeline compiles
+
+    // --- Push constants ---
+    VkPushConstantRange pushRange{};
+    pushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushRange.offset = 0;
+    pushRange.size = sizeof(PushConstants);
 
-    VkShaderModule shaderModule = VK_NULL_HANDLE;
-    if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS)
-        throw std::runtime_error("Failed to create shader module: " + spvPath);
+    // --- Pipeline layout (shared) ---
+    m_PipelineLayout = states->GetPipelineLayout(desc.setLayouts, { pushRange });
 
-    return shaderModule;
+    if (!deferCompile)
+        Compile();
 }
 
-VulkanPipeline::VulkanPipeline(
-    VulkanDevice* device,
-    VulkanSwapchain* swapchain,
-    VulkanRenderPass* renderPass,
-    const std::vector<VkDescriptorSetLayout>& setLayouts,
-    //VkDescriptorSetLayout descriptorSetLayout,
-    const std::string& vertSpvPath,
-    const std::string& fragSpvPath)
-    : m_Device(device)
+void VulkanPipeline::Compile()
 {
+    const GraphicsPipelineDesc& desc = m_Desc;
     VkDevice vkDevice = m_Device->GetHandle();
-    VkExtent2D extent = swapchain->GetExtent();
+    VulkanStateCache* states = m_Device->GetStateCache();
 
+    // Shared modules: kept by the state cache for later pipelines
     VkShaderModule vertModule = VK_NULL_HANDLE;
     VkShaderModule fragModule = VK_NULL_HANDLE;
 
     try
     {
-        vertModule = CreateShaderModule(vkDevice, vertSpvPath);
-        fragModule = CreateShaderModule(vkDevice, fragSpvPath);
+        vertModule = states->GetShaderModule(desc.vertSpv);
+        if (!desc.fragSpv.empty())
+            fragModule = states->GetShaderModule(desc.fragSpv);
     }
     catch (const std::exception& e)
     {
@@ -84,20 +85,42 @@ VulkanPipeline::VulkanPipeline(
     fragStage.module = fragModule;
     fragStage.pName = "main";
 
+    // --- Specialization (shader permutation) ---
+    std::vector<VkSpecializationMapEntry> specEntries(desc.fragConstants.size());
+    for (uint32_t i = 0; i < specEntries.size(); i++)
+    {
+        specEntries[i].constantID = i;
+        specEntries[i].offset = i * sizeof(uint32_t);
+        specEntries[i].size = sizeof(uint32_t);
+    }
+
+    VkSpecializationInfo specInfo{};
+    specInfo.mapEntryCount = static_cast<uint32_t>(specEntries.size());
+    specInfo.pMapEntries = specEntries.data();
+    specInfo.dataSize = desc.fragConstants.size() * sizeof(uint32_t);
+    specInfo.pData = desc.fragConstants.data();
+
+    if (!desc.fragConstants.empty())
+        fragStage.pSpecializationInfo = &specInfo;
+
     VkPipelineShaderStageCreateInfo shaderStages[] = { vertStage, fragStage };
+    const uint32_t stageCount = desc.fragSpv.empty() ? 1 : 2;
 
     // ------------------------------------------------------------
-    // Vertex Input (Vertex3D)
+    // Vertex Input (Vertex3D, or its position-only stream)
     // ------------------------------------------------------------
-    auto binding = Vertex3D::GetBindingDescription();
-    auto attributes = Vertex3D::GetAttributeDescriptions();
+    const bool positionOnly = desc.vertexInput == VertexInput::PositionOnly;
 
+    auto binding = positionOnly ? Vertex3D::GetPositionBindingDescription() : Vertex3D::GetBindingDescription();
+    auto attributes = Vertex3D::GetAttributeDescriptions();
+    if (positionOnly)
+        attributes[0] = Vertex3D::GetPositionAttributeDescription();
 
     VkPipelineVertexInputStateCreateInfo vertexInput{};
     vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     vertexInput.vertexBindingDescriptionCount = 1;
     vertexInput.pVertexBindingDescriptions = &binding;
-    vertexInput.vertexAttributeDescriptionCount = (uint32_t)attributes.size();
+    vertexInput.vertexAttributeDescriptionCount = positionOnly ? 1 : (uint32_t)attributes.size();
     vertexInput.pVertexAttributeDescriptions = attributes.data();
 
     // --- Input assembly: triangle list ---
@@ -106,25 +129,20 @@ VulkanPipeline::VulkanPipeline(
     inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
     inputAssembly.primitiveRestartEnable = VK_FALSE;
 
-    // --- Viewport + scissor (baked into pipeline, not dynamic) ---
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = (float)extent.width;
-    viewport.height = (float)extent.height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
+    // --- Viewport + scissor ---
+    // Dynamic: set per render pass from the target's current extent, so
+    // resizes and offscreen targets do not need their own pipelines.
+    const VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
 
-    VkRect2D scissor{};
-    scissor.offset = { 0, 0 };
-    scissor.extent = extent;
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
 
     VkPipelineViewportStateCreateInfo viewportState{};
     viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
     viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
     viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
 
     // --- Rasterizer ---
     VkPipelineRasterizationStateCreateInfo rasterizer{};
@@ -133,7 +151,7 @@ VulkanPipeline::VulkanPipeline(
     rasterizer.rasterizerDiscardEnable = VK_FALSE;
     rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
     rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+    rasterizer.cullMode = desc.cullMode;
     //rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
     rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
 
@@ -149,16 +167,16 @@ VulkanPipeline::VulkanPipeline(
     VkPipelineDepthStencilStateCreateInfo depthStencil{};
     depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
     depthStencil.depthTestEnable = VK_TRUE;
-    depthStencil.depthWriteEnable = VK_TRUE;
-    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+    depthStencil.depthWriteEnable = desc.depthWrite;
+    depthStencil.depthCompareOp = desc.depthCompare;
     depthStencil.depthBoundsTestEnable = VK_FALSE;
     depthStencil.stencilTestEnable = VK_FALSE;
 
     // --- Color blending ---
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask =
-        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
-        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.colorWriteMask = desc.colorWrite
+        ? VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+        : 0;
     colorBlendAttachment.blendEnable = VK_FALSE;
 
     VkPipelineColorBlendStateCreateInfo colorBlending{};
@@ -167,33 +185,11 @@ VulkanPipeline::VulkanPipeline(
     colorBlending.attachmentCount = 1;
     colorBlending.pAttachments = &colorBlendAttachment;
 
-	// --- Push constants ---
-    VkPushConstantRange pushRange{};
-    pushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-    pushRange.offset = 0;
-    pushRange.size = sizeof(PushConstants);
-
-    // --- Pipeline layout ---
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
-    //pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
-    //pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = 1;
-    pipelineLayoutInfo.pPushConstantRanges = &pushRange;
-
-    if (vkCreatePipelineLayout(vkDevice, &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
-    {
-        LOG_ERROR("Failed to create pipeline layout!");
-        throw std::runtime_error("Pipeline layout creation failed.");
-    }
-
     // --- Graphics pipeline ---
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 
-    pipelineInfo.stageCount = 2;
+    pipelineInfo.stageCount = stageCount;
     pipelineInfo.pStages = shaderStages;
 
     pipelineInfo.pVertexInputState = &vertexInput;
@@ -203,21 +199,35 @@ VulkanPipeline::VulkanPipeline(
     pipelineInfo.pMultisampleState = &multisampling;
     pipelineInfo.pDepthStencilState = &depthStencil;
     pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
 
     pipelineInfo.layout = m_PipelineLayout;
-    pipelineInfo.renderPass = renderPass->GetHandle();
+    pipelineInfo.renderPass = desc.renderPass;
     pipelineInfo.subpass = 0;
 
-    if (vkCreateGraphicsPipelines(vkDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline) != VK_SUCCESS)
+    VulkanPipelineCache* cache = m_Device->GetPipelineCache();
+    VkResult result = cache
+        ? cache->CreateGraphicsPipeline(pipelineInfo, &m_Pipeline)
+        : vkCreateGraphicsPipelines(vkDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline);
+
+    if (result != VK_SUCCESS)
     {
         LOG_ERROR("Failed to create graphics pipeline!");
         throw std::runtime_error("Graphics pipeline creation failed.");
     }
 
-    vkDestroyShaderModule(vkDevice, vertModule, nullptr);
-    vkDestroyShaderModule(vkDevice, fragModule, nullptr);
+    m_Ready.store(true, std::memory_order_release);
 
-    LOG_INFO("Graphics pipeline created successfully.");
+    LOG_INFO("Graphics pipeline created: " + desc.vertSpv + " + " + (desc.fragSpv.empty() ? "depth only" : desc.fragSpv) +
+        (desc.fragConstants.empty() ? "" : " (specialized)"));
+}
+
+VulkanPipeline* VulkanPipeline::GetDrawable()
+{
+    if (m_Ready.load(std::memory_order_acquire))
+        return this;
+
+    return m_Fallback ? m_Fallback->GetDrawable() : nullptr;
 }
 
 VulkanPipeline::~VulkanPipeline()
@@ -226,7 +236,4 @@ VulkanPipeline::~VulkanPipeline()
 
     if (m_Pipeline != VK_NULL_HANDLE)
         vkDestroyPipeline(vkDevice, m_Pipeline, nullptr);
-
-    if (m_PipelineLayout != VK_NULL_HANDLE)
-        vkDestroyPipelineLayout(vkDevice, m_PipelineLayout, nullptr);
 }
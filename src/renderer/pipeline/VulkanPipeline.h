@@ -1,35 +1,79 @@
 #pragma once
 #include <vulkan/vulkan.h>
+#include <atomic>
 #include <string>
 #include <vector>
 
 class VulkanDevice;
-class VulkanSwapchain;
-class VulkanRenderPass;
+
+// Vertex streams a pipeline reads (see Mesh)
+enum class VertexInput : uint32_t
+{
+    Vertex3D = 0,    // the interleaved stream, every attribute
+    PositionOnly = 1 // the position-only stream: location 0 only
+};
+
+// Everything a graphics pipeline is built from; VulkanStateCache hashes it
+// so equal descriptions share one pipeline. Push constants (PushConstants)
+// and MSAA (device) are the same for all.
+struct GraphicsPipelineDesc
+{
+    VkRenderPass renderPass = VK_NULL_HANDLE; // compatible passes may share it
+    std::vector<VkDescriptorSetLayout> setLayouts;
+    std::string vertSpv;
+    std::string fragSpv; // empty: depth only, no fragment stage
+
+    // Fragment specialization constants: constant_id i = fragConstants[i]
+    // (4 bytes each; empty = the shader's defaults)
+    std::vector<uint32_t> fragConstants;
+
+    VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+    VkBool32 depthWrite = VK_TRUE;
+    VkCompareOp depthCompare = VK_COMPARE_OP_LESS;
+
+    VertexInput vertexInput = VertexInput::Vertex3D;
+    VkBool32 colorWrite = VK_TRUE; // off for depth-only passes
+
+    bool operator==(const GraphicsPipelineDesc& other) const = default;
+    size_t Hash() const;
+};
 
 class VulkanPipeline
 {
 public:
-    VulkanPipeline(VulkanDevice* device,
-        VulkanSwapchain* swapchain,
-        VulkanRenderPass* renderPass,
-        const std::vector<VkDescriptorSetLayout>& setLayouts,
-        //VkDescriptorSetLayout descriptorSetLayout,
-        const std::string& vertSpvPath,
-        const std::string& fragSpvPath);
-
+    // Viewport + scissor are dynamic: the pipeline does not depend on the
+    // target size (swapchain or offscreen).
+    // Prefer VulkanStateCache::GetGraphicsPipeline(), which owns the result.
+    // deferCompile: only the layout is created; Compile() builds the pipeline
+    // (the state cache's background threads).
+    VulkanPipeline(VulkanDevice* device, const GraphicsPipelineDesc& desc, bool deferCompile = false);
 
     ~VulkanPipeline();
 
     VkPipeline       GetHandle() const { return m_Pipeline; }
     VkPipelineLayout GetLayout() const { return m_PipelineLayout; }
 
+    const GraphicsPipelineDesc& GetDesc() const { return m_Desc; }
+
+    // Any thread, once. Throws on failure (the pipeline stays not ready).
+    void Compile();
+
+    bool IsReady() const { return m_Ready.load(std::memory_order_acquire); }
+
+    // Drawn instead while this one compiles. Must share the pipeline layout.
+    void SetFallback(VulkanPipeline* fallback) { m_Fallback = fallback; }
+
+    // What to bind now: this pipeline once compiled, else its (ready)
+    // fallback, else null - skip the draw
+    VulkanPipeline* GetDrawable();
+
 private:
     VulkanDevice* m_Device = nullptr;
+    GraphicsPipelineDesc m_Desc;
 
-    VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+    VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE; // shared, owned by the state cache
     VkPipeline       m_Pipeline = VK_NULL_HANDLE;
 
-private:
-    static VkShaderModule CreateShaderModule(VkDevice device, const std::string& spvPath);
+    std::atomic<bool> m_Ready{ false };
+    VulkanPipeline* m_Fallback = nullptr;
 };
@@ -0,0 +1,223 @@
+#include "VulkanPipelineCache.h"
+
+#include "renderer/VulkanDevice.h"
+#include "core/Logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+static int64_t SteadyNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint64_t Fnv1a(const char* data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+VulkanPipelineCache::VulkanPipelineCache(VulkanDevice* device, const std::string& path)
+    : m_Device(device), m_Path(path)
+{
+    vkGetPhysicalDeviceProperties(m_Device->GetPhysicalDevice(), &m_Properties);
+
+    std::vector<char> data;
+    m_Warm = !m_Path.empty() && Load(data);
+
+    VkPipelineCacheCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    info.initialDataSize = m_Warm ? data.size() : 0;
+    info.pInitialData = m_Warm ? data.data() : nullptr;
+
+    VkResult result = vkCreatePipelineCache(m_Device->GetHandle(), &info, nullptr, &m_Cache);
+
+    // Rejected by the driver after all: start empty
+    if (result != VK_SUCCESS && m_Warm)
+    {
+        LOG_WARN("PipelineCache: driver rejected " + m_Path + ", starting empty");
+        m_Warm = false;
+        info.initialDataSize = 0;
+        info.pInitialData = nullptr;
+        result = vkCreatePipelineCache(m_Device->GetHandle(), &info, nullptr, &m_Cache);
+    }
+
+    if (result != VK_SUCCESS)
+        throw std::runtime_error("VulkanPipelineCache: failed to create pipeline cache");
+
+    if (m_Warm)
+        LOG_INFO("PipelineCache: loaded " + std::to_string(data.size()) + " bytes from " + m_Path);
+}
+
+VulkanPipelineCache::~VulkanPipelineCache()
+{
+    if (m_Cache)
+        vkDestroyPipelineCache(m_Device->GetHandle(), m_Cache, nullptr);
+}
+
+VulkanPipelineCache::FileHeader VulkanPipelineCache::MakeHeader() const
+{
+    FileHeader header{};
+    std::memcpy(header.magic, "VXPC", 4);
+    header.version = FILE_VERSION;
+    header.vendorID = m_Properties.vendorID;
+    header.deviceID = m_Properties.deviceID;
+    header.driverVersion = m_Properties.driverVersion;
+    std::memcpy(header.uuid, m_Properties.pipelineCacheUUID, VK_UUID_SIZE);
+    return header;
+}
+
+bool VulkanPipelineCache::Load(std::vector<char>& data) const
+{
+    std::ifstream file(m_Path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        LOG_INFO("PipelineCache: no cache at " + m_Path + ", cold start");
+        return false;
+    }
+
+    const size_t fileSize = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    FileHeader header{};
+    if (fileSize < sizeof(FileHeader) || !file.read(reinterpret_cast<char*>(&header), sizeof(FileHeader)))
+    {
+        LOG_WARN("PipelineCache: " + m_Path + " is truncated, ignored");
+        return false;
+    }
+
+    // Written by another GPU / driver: the blob is useless here
+    const FileHeader expected = MakeHeader();
+    if (std::memcmp(header.magic, expected.magic, 4) != 0 ||
+        header.version != expected.version ||
+        header.vendorID != expected.vendorID ||
+        header.deviceID != expected.deviceID ||
+        header.driverVersion != expected.driverVersion ||
+        std::memcmp(header.uuid, expected.uuid, VK_UUID_SIZE) != 0)
+    {
+        LOG_INFO("PipelineCache: " + m_Path + " belongs to another device or driver, cold start");
+        return false;
+    }
+
+    if (header.dataSize != fileSize - sizeof(FileHeader))
+    {
+        LOG_WARN("PipelineCache: " + m_Path + " has the wrong size, ignored");
+        return false;
+    }
+
+    data.resize(static_cast<size_t>(header.dataSize));
+    if (!file.read(data.data(), static_cast<std::streamsize>(data.size())) ||
+        Fnv1a(data.data(), data.size()) != header.checksum)
+    {
+        LOG_WARN("PipelineCache: " + m_Path + " is corrupt, ignored");
+        return false;
+    }
+
+    // The driver's own header must agree too
+    VkPipelineCacheHeaderVersionOne blobHeader{};
+    if (data.size() < sizeof(blobHeader))
+        return false;
+
+    std::memcpy(&blobHeader, data.data(), sizeof(blobHeader));
+    if (blobHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        blobHeader.vendorID != expected.vendorID ||
+        blobHeader.deviceID != expected.deviceID ||
+        std::memcmp(blobHeader.pipelineCacheUUID, expected.uuid, VK_UUID_SIZE) != 0)
+    {
+        LOG_WARN("PipelineCache: " + m_Path + " holds a foreign driver blob, ignored");
+        return false;
+    }
+
+    return true;
+}
+
+bool VulkanPipelineCache::Save() const
+{
+    if (m_Path.empty())
+        return false;
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(m_Device->GetHandle(), m_Cache, &size, nullptr) != VK_SUCCESS || size == 0)
+        return false;
+
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(m_Device->GetHandle(), m_Cache, &size, data.data()) != VK_SUCCESS)
+        return false;
+    data.resize(size);
+
+    FileHeader header = MakeHeader();
+    header.dataSize = size;
+    header.checksum = Fnv1a(data.data(), data.size());
+
+    // Complete file under a temporary name, then rename over the old one
+    const std::string tempPath = m_Path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        file.flush();
+
+        if (!file)
+        {
+            LOG_ERROR("PipelineCache: cannot write " + tempPath);
+            file.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, m_Path, ec);
+    if (ec)
+    {
+        LOG_ERROR("PipelineCache: cannot replace " + m_Path + ": " + ec.message());
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    LOG_INFO("PipelineCache: saved " + std::to_string(size) + " bytes to " + m_Path);
+    return true;
+}
+
+// --- Creation ---
+
+void VulkanPipelineCache::AddCreation(int64_t ns)
+{
+    m_PipelineCount.fetch_add(1, std::memory_order_relaxed);
+    m_CreationNs.fetch_add(ns, std::memory_order_relaxed);
+}
+
+VkResult VulkanPipelineCache::CreateGraphicsPipeline(const VkGraphicsPipelineCreateInfo& info, VkPipeline* pipeline)
+{
+    const int64_t start = SteadyNs();
+    VkResult result = vkCreateGraphicsPipelines(m_Device->GetHandle(), m_Cache, 1, &info, nullptr, pipeline);
+    AddCreation(SteadyNs() - start);
+    return result;
+}
+
+VkResult VulkanPipelineCache::CreateComputePipeline(const VkComputePipelineCreateInfo& info, VkPipeline* pipeline)
+{
+    const int64_t start = SteadyNs();
+    VkResult result = vkCreateComputePipelines(m_Device->GetHandle(), m_Cache, 1, &info, nullptr, pipeline);
+    AddCreation(SteadyNs() - start);
+    return result;
+}
+
+void VulkanPipelineCache::LogCreationTime(const char* when) const
+{
+    char ms[32];
+    std::snprintf(ms, sizeof(ms), "%.2f", GetCreationMs());
+
+    LOG_INFO(std::string("PipelineCache: ") + when + ": " + std::to_string(GetPipelineCount()) +
+        " pipelines created in " + ms + " ms (" + (m_Warm ? "warm" : "cold") + " cache)");
+}
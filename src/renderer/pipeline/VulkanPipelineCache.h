@@ -0,0 +1,74 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class VulkanDevice;
+
+// Device-wide VkPipelineCache, persisted between runs. The file is only
+// accepted when it was written by the same vendor / device / driver version
+// with the same pipelineCacheUUID; anything else starts an empty cache (a
+// stale blob is at best ignored by the driver, at worst a crash). Save()
+// writes a temporary file and renames it over the old one, so an
+// interrupted run never leaves a truncated cache behind.
+// Every pipeline created through it is timed: GetCreationMs() after startup
+// shows the cold vs warm difference.
+// Reached through VulkanDevice::GetPipelineCache(); owned by Application.
+class VulkanPipelineCache
+{
+public:
+    // path empty: in-memory only (nothing loaded or saved)
+    VulkanPipelineCache(VulkanDevice* device, const std::string& path);
+    ~VulkanPipelineCache();
+
+    VkPipelineCache GetHandle() const { return m_Cache; }
+
+    // A valid file was found and fed to the cache
+    bool IsWarm() const { return m_Warm; }
+
+    // Thread-safe (the driver synchronizes the cache itself)
+    VkResult CreateGraphicsPipeline(const VkGraphicsPipelineCreateInfo& info, VkPipeline* pipeline);
+    VkResult CreateComputePipeline(const VkComputePipelineCreateInfo& info, VkPipeline* pipeline);
+
+    uint32_t GetPipelineCount() const { return m_PipelineCount.load(std::memory_order_relaxed); }
+    double GetCreationMs() const { return double(m_CreationNs.load(std::memory_order_relaxed)) * 1.0e-6; }
+
+    // Logs the pipelines created so far and how long they took
+    void LogCreationTime(const char* when) const;
+
+    // Atomically replaces the file with the current cache contents
+    bool Save() const;
+
+private:
+    // File header in front of the driver's blob
+    struct FileHeader
+    {
+        char     magic[4];
+        uint32_t version;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t  uuid[VK_UUID_SIZE];
+        uint64_t dataSize;
+        uint64_t checksum; // FNV-1a of the blob
+    };
+
+    static constexpr uint32_t FILE_VERSION = 1;
+
+    FileHeader MakeHeader() const;
+    bool Load(std::vector<char>& data) const;
+    void AddCreation(int64_t ns);
+
+private:
+    VulkanDevice* m_Device = nullptr;
+    std::string m_Path;
+
+    VkPipelineCache m_Cache = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties m_Properties{};
+    bool m_Warm = false;
+
+    std::atomic<uint32_t> m_PipelineCount{ 0 };
+    std::atomic<int64_t> m_CreationNs{ 0 };
+};
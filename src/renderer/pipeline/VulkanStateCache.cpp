@@ -0,0 +1,387 @@
+#include "VulkanStateCache.h"
+
+#include "renderer/VulkanDevice.h"
+#include "core/Logger.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+static std::string ReadFileBinary(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Failed to open file: " + filename);
+
+    size_t fileSize = (size_t)file.tellg();
+    std::string buffer(fileSize, '\0');
+
+    file.seekg(0);
+    file.read(buffer.data(), fileSize);
+    return buffer;
+}
+
+// --- Keys ---
+
+bool VulkanStateCache::SetLayoutKey::operator==(const SetLayoutKey& other) const
+{
+    if (flags != other.flags || bindings.size() != other.bindings.size() || bindingFlags != other.bindingFlags)
+        return false;
+
+    for (size_t i = 0; i < bindings.size(); i++)
+    {
+        const VkDescriptorSetLayoutBinding& a = bindings[i];
+        const VkDescriptorSetLayoutBinding& b = other.bindings[i];
+
+        if (a.binding != b.binding || a.descriptorType != b.descriptorType ||
+            a.descriptorCount != b.descriptorCount || a.stageFlags != b.stageFlags)
+            return false;
+    }
+    return true;
+}
+
+size_t VulkanStateCache::SetLayoutKey::Hash() const
+{
+    size_t hash = flags;
+    for (const VkDescriptorSetLayoutBinding& b : bindings)
+    {
+        HashCombine(hash, b.binding);
+        HashCombine(hash, b.descriptorType);
+        HashCombine(hash, b.descriptorCount);
+        HashCombine(hash, b.stageFlags);
+    }
+    for (VkDescriptorBindingFlags f : bindingFlags)
+        HashCombine(hash, f);
+    return hash;
+}
+
+bool VulkanStateCache::PipelineLayoutKey::operator==(const PipelineLayoutKey& other) const
+{
+    if (setLayouts != other.setLayouts || pushConstants.size() != other.pushConstants.size())
+        return false;
+
+    for (size_t i = 0; i < pushConstants.size(); i++)
+    {
+        const VkPushConstantRange& a = pushConstants[i];
+        const VkPushConstantRange& b = other.pushConstants[i];
+
+        if (a.stageFlags != b.stageFlags || a.offset != b.offset || a.size != b.size)
+            return false;
+    }
+    return true;
+}
+
+size_t VulkanStateCache::PipelineLayoutKey::Hash() const
+{
+    size_t hash = 0;
+    for (VkDescriptorSetLayout layout : setLayouts)
+        HashCombine(hash, reinterpret_cast<uintptr_t>(layout));
+    for (const VkPushConstantRange& range : pushConstants)
+    {
+        HashCombine(hash, range.stageFlags);
+        HashCombine(hash, range.offset);
+        HashCombine(hash, range.size);
+    }
+    return hash;
+}
+
+// --- Cache ---
+
+VulkanStateCache::VulkanStateCache(VulkanDevice* device)
+    : m_Device(device)
+{
+}
+
+VulkanStateCache::~VulkanStateCache()
+{
+    // Queued compiles are dropped; running ones finish first
+    {
+        std::lock_guard<std::mutex> lock(m_CompileMutex);
+        m_StopCompiling = true;
+    }
+    m_CompileCv.notify_all();
+
+    for (std::thread& thread : m_CompileThreads)
+        thread.join();
+
+    VkDevice vkDevice = m_Device->GetHandle();
+
+    // Pipelines first: they reference the layouts
+    for (auto& [desc, pipeline] : m_GraphicsPipelines)
+        delete pipeline;
+    for (auto& [desc, pipeline] : m_ComputePipelines)
+        delete pipeline;
+
+    for (auto& [key, layout] : m_PipelineLayouts)
+        vkDestroyPipelineLayout(vkDevice, layout, nullptr);
+    for (auto& [key, layout] : m_SetLayouts)
+        vkDestroyDescriptorSetLayout(vkDevice, layout, nullptr);
+    for (auto& [code, module] : m_ModulesByCode)
+        vkDestroyShaderModule(vkDevice, module, nullptr);
+
+    if (m_Misses > 0)
+    {
+        LOG_INFO("State cache: " + std::to_string(m_Misses) + " objects created, " +
+            std::to_string(m_Hits) + " requests shared");
+    }
+}
+
+VkShaderModule VulkanStateCache::GetShaderModule(const std::string& spvPath)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    auto byPath = m_ModulesByPath.find(spvPath);
+    if (byPath != m_ModulesByPath.end())
+    {
+        m_Hits++;
+        return byPath->second;
+    }
+
+    // Same bytes under another name: same module
+    std::string code = ReadFileBinary(spvPath);
+
+    auto byCode = m_ModulesByCode.find(code);
+    if (byCode != m_ModulesByCode.end())
+    {
+        m_Hits++;
+        m_ModulesByPath.emplace(spvPath, byCode->second);
+        return byCode->second;
+    }
+
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = code.size();
+    createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+    VkShaderModule module = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(m_Device->GetHandle(), &createInfo, nullptr, &module) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create shader module: " + spvPath);
+
+    m_Misses++;
+    m_ModulesByPath.emplace(spvPath, module);
+    m_ModulesByCode.emplace(std::move(code), module);
+    return module;
+}
+
+VkDescriptorSetLayout VulkanStateCache::GetSetLayout(
+    const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+    VkDescriptorSetLayoutCreateFlags flags,
+    const std::vector<VkDescriptorBindingFlags>& bindingFlags)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    if (!bindingFlags.empty() && bindingFlags.size() != bindings.size())
+        throw std::runtime_error("VulkanStateCache: one binding flag per binding expected");
+
+    SetLayoutKey key{ flags, bindings, bindingFlags };
+
+    auto it = m_SetLayouts.find(key);
+    if (it != m_SetLayouts.end())
+    {
+        m_Hits++;
+        return it->second;
+    }
+
+    for (const VkDescriptorSetLayoutBinding& binding : bindings)
+    {
+        if (binding.pImmutableSamplers)
+            throw std::runtime_error("VulkanStateCache: immutable samplers are not supported");
+    }
+
+    VkDescriptorSetLayoutCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    info.flags = flags;
+    info.bindingCount = static_cast<uint32_t>(bindings.size());
+    info.pBindings = bindings.data();
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+    flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    flagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+    flagsInfo.pBindingFlags = bindingFlags.data();
+
+    if (!bindingFlags.empty())
+        info.pNext = &flagsInfo;
+
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    if (vkCreateDescriptorSetLayout(m_Device->GetHandle(), &info, nullptr, &layout) != VK_SUCCESS)
+        throw std::runtime_error("VulkanStateCache: failed to create descriptor set layout");
+
+    m_Misses++;
+    m_SetLayouts.emplace(std::move(key), layout);
+    return layout;
+}
+
+VkPipelineLayout VulkanStateCache::GetPipelineLayout(
+    const std::vector<VkDescriptorSetLayout>& setLayouts,
+    const std::vector<VkPushConstantRange>& pushConstants)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    PipelineLayoutKey key{ setLayouts, pushConstants };
+
+    auto it = m_PipelineLayouts.find(key);
+    if (it != m_PipelineLayouts.end())
+    {
+        m_Hits++;
+        return it->second;
+    }
+
+    VkPipelineLayoutCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    info.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    info.pSetLayouts = setLayouts.data();
+    info.pushConstantRangeCount = static_cast<uint32_t>(pushConstants.size());
+    info.pPushConstantRanges = pushConstants.data();
+
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    if (vkCreatePipelineLayout(m_Device->GetHandle(), &info, nullptr, &layout) != VK_SUCCESS)
+        throw std::runtime_error("VulkanStateCache: failed to create pipeline layout");
+
+    m_Misses++;
+    m_PipelineLayouts.emplace(std::move(key), layout);
+    return layout;
+}
+
+VulkanPipeline* VulkanStateCache::GetGraphicsPipeline(const GraphicsPipelineDesc& desc)
+{
+    VulkanPipeline* pipeline = nullptr;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+        auto it = m_GraphicsPipelines.find(desc);
+        if (it == m_GraphicsPipelines.end())
+        {
+            pipeline = new VulkanPipeline(m_Device, desc);
+
+            m_Misses++;
+            m_GraphicsPipelines.emplace(desc, pipeline);
+            return pipeline;
+        }
+
+        m_Hits++;
+        pipeline = it->second;
+    }
+
+    // Requested async earlier: wait for its background compile
+    if (!pipeline->IsReady())
+    {
+        std::unique_lock<std::mutex> lock(m_CompileMutex);
+        m_CompiledCv.wait(lock, [&]() { return !m_Compiling.count(pipeline); });
+
+        if (m_Failed.count(pipeline))
+            throw std::runtime_error("VulkanStateCache: pipeline failed to compile: " + desc.vertSpv + " + " + desc.fragSpv);
+    }
+
+    return pipeline;
+}
+
+VulkanPipeline* VulkanStateCache::RequestGraphicsPipeline(const GraphicsPipelineDesc& desc, VulkanPipeline* fallback)
+{
+    VulkanPipeline* pipeline = nullptr;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+        auto it = m_GraphicsPipelines.find(desc);
+        if (it != m_GraphicsPipelines.end())
+        {
+            m_Hits++;
+            return it->second;
+        }
+
+        // Layout only; the compile happens on a background thread
+        pipeline = new VulkanPipeline(m_Device, desc, true);
+
+        m_Misses++;
+        m_GraphicsPipelines.emplace(desc, pipeline);
+
+        if (fallback && fallback->GetLayout() == pipeline->GetLayout() && fallback->GetDesc().renderPass == desc.renderPass)
+            pipeline->SetFallback(fallback);
+        else if (fallback)
+            LOG_WARN("State cache: fallback pipeline is not compatible, draws are skipped until " + desc.vertSpv + " + " + desc.fragSpv + " is ready");
+
+        // Queued before m_Mutex is released: GetGraphicsPipeline() never sees
+        // it unready without a pending compile to wait for
+        std::lock_guard<std::mutex> compileLock(m_CompileMutex);
+
+        if (m_CompileThreads.empty())
+            StartCompileThreads();
+
+        m_CompileQueue.push_back(pipeline);
+        m_Compiling.insert(pipeline);
+        m_PendingCompiles.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_CompileCv.notify_one();
+
+    return pipeline;
+}
+
+void VulkanStateCache::WaitForCompiles()
+{
+    std::unique_lock<std::mutex> lock(m_CompileMutex);
+    m_CompiledCv.wait(lock, [&]() { return m_Compiling.empty(); });
+}
+
+void VulkanStateCache::StartCompileThreads()
+{
+    // A few threads: the frame keeps its cores, drivers often serialize anyway
+    const uint32_t count = std::max(1u, std::min(2u, std::thread::hardware_concurrency() / 4));
+
+    for (uint32_t i = 0; i < count; i++)
+        m_CompileThreads.emplace_back(&VulkanStateCache::CompileLoop, this);
+}
+
+void VulkanStateCache::CompileLoop()
+{
+    while (true)
+    {
+        VulkanPipeline* pipeline = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_CompileMutex);
+            m_CompileCv.wait(lock, [&]() { return m_StopCompiling || !m_CompileQueue.empty(); });
+
+            if (m_StopCompiling)
+                return;
+
+            pipeline = m_CompileQueue.front();
+            m_CompileQueue.pop_front();
+        }
+
+        bool failed = false;
+        try
+        {
+            pipeline->Compile();
+        }
+        catch (const std::exception& e)
+        {
+            LOG_ERROR(std::string("State cache: background compile failed: ") + e.what());
+            failed = true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_CompileMutex);
+            m_Compiling.erase(pipeline);
+            if (failed)
+                m_Failed.insert(pipeline);
+            m_PendingCompiles.fetch_sub(1, std::memory_order_relaxed);
+        }
+        m_CompiledCv.notify_all();
+    }
+}
+
+VulkanComputePipeline* VulkanStateCache::GetComputePipeline(const ComputePipelineDesc& desc)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+
+    auto it = m_ComputePipelines.find(desc);
+    if (it != m_ComputePipelines.end())
+    {
+        m_Hits++;
+        return it->second;
+    }
+
+    VulkanComputePipeline* pipeline = new VulkanComputePipeline(m_Device, desc);
+
+    m_Misses++;
+    m_ComputePipelines.emplace(desc, pipeline);
+    return pipeline;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <cstdint>
+
+#include "VulkanPipeline.h"
+#include "VulkanComputePipeline.h"
+
+class VulkanDevice;
+
+inline void HashCombine(size_t& hash, uint64_t value)
+{
+    hash ^= std::hash<uint64_t>()(value) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+}
+
+// Deduplicates the immutable pipeline objects: shader modules (by SPIR-V
+// contents), descriptor set layouts (by bindings), pipeline layouts (by set
+// layouts + push constant ranges) and whole pipelines (by description).
+// Equal requests return the same handle, so a material or permutation that
+// matches an existing one never compiles again, and layouts created by
+// different owners are interchangeable. Everything lives until the device
+// is destroyed; callers never destroy what they get back.
+// Pipelines needed mid-session can be requested without blocking: they
+// compile on background threads and draw through VulkanPipeline::GetDrawable()
+// (a compatible fallback, or nothing, until they are ready).
+// Owned by VulkanDevice (GetStateCache()). Thread-safe.
+class VulkanStateCache
+{
+public:
+    explicit VulkanStateCache(VulkanDevice* device);
+    ~VulkanStateCache();
+
+    VkShaderModule GetShaderModule(const std::string& spvPath);
+
+    // Bindings without immutable samplers. bindingFlags: one per binding
+    // (descriptor indexing), or empty for none.
+    VkDescriptorSetLayout GetSetLayout(
+        const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+        VkDescriptorSetLayoutCreateFlags flags = 0,
+        const std::vector<VkDescriptorBindingFlags>& bindingFlags = {});
+
+    VkPipelineLayout GetPipelineLayout(
+        const std::vector<VkDescriptorSetLayout>& setLayouts,
+        const std::vector<VkPushConstantRange>& pushConstants);
+
+    // Blocks until the pipeline exists (also when it was requested async)
+    VulkanPipeline* GetGraphicsPipeline(const GraphicsPipelineDesc& desc);
+    VulkanComputePipeline* GetComputePipeline(const ComputePipelineDesc& desc);
+
+    // Returns at once; the pipeline compiles on a background thread.
+    // fallback: drawn meanwhile, ignored unless its layout matches.
+    VulkanPipeline* RequestGraphicsPipeline(const GraphicsPipelineDesc& desc, VulkanPipeline* fallback = nullptr);
+
+    // Background compiles queued or running
+    uint32_t GetPendingCompileCount() const { return m_PendingCompiles.load(std::memory_order_relaxed); }
+
+    // Blocks until every requested pipeline has finished compiling
+    void WaitForCompiles();
+
+    // Requests answered from the cache vs objects created
+    uint32_t GetHitCount() const { return m_Hits; }
+    uint32_t GetMissCount() const { return m_Misses; }
+
+private:
+    struct SetLayoutKey
+    {
+        VkDescriptorSetLayoutCreateFlags flags = 0;
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+        std::vector<VkDescriptorBindingFlags> bindingFlags;
+
+        bool operator==(const SetLayoutKey& other) const;
+        size_t Hash() const;
+    };
+
+    struct PipelineLayoutKey
+    {
+        std::vector<VkDescriptorSetLayout> setLayouts;
+        std::vector<VkPushConstantRange> pushConstants;
+
+        bool operator==(const PipelineLayoutKey& other) const;
+        size_t Hash() const;
+    };
+
+    template<typename Key>
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const { return key.Hash(); }
+    };
+
+    void StartCompileThreads(); // m_CompileMutex held
+    void CompileLoop();
+
+private:
+    VulkanDevice* m_Device = nullptr;
+
+    std::recursive_mutex m_Mutex; // pipelines request modules + layouts while it is held
+
+    std::unordered_map<std::string, VkShaderModule> m_ModulesByPath;
+    std::unordered_map<std::string, VkShaderModule> m_ModulesByCode; // key: SPIR-V bytes
+    std::unordered_map<SetLayoutKey, VkDescriptorSetLayout, KeyHash<SetLayoutKey>> m_SetLayouts;
+    std::unordered_map<PipelineLayoutKey, VkPipelineLayout, KeyHash<PipelineLayoutKey>> m_PipelineLayouts;
+    std::unordered_map<GraphicsPipelineDesc, VulkanPipeline*, KeyHash<GraphicsPipelineDesc>> m_GraphicsPipelines;
+    std::unordered_map<ComputePipelineDesc, VulkanComputePipeline*, KeyHash<ComputePipelineDesc>> m_ComputePipelines;
+
+    uint32_t m_Hits = 0;
+    uint32_t m_Misses = 0;
+
+    // Background compilation (started on the first request)
+    std::mutex m_CompileMutex;
+    std::condition_variable m_CompileCv;     // work queued / stop
+    std::condition_variable m_CompiledCv;    // a compile finished
+    std::deque<VulkanPipeline*> m_CompileQueue;
+    std::unordered_set<VulkanPipeline*> m_Compiling; // queued or running
+    std::unordered_set<VulkanPipeline*> m_Failed;
+    std::vector<std::thread> m_CompileThreads;
+    std::atomic<uint32_t> m_PendingCompiles{ 0 };
+    bool m_StopCompiling = false;
+};
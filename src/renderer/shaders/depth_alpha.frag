@@ -0,0 +1,33 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Depth pre-pass of alpha-tested materials: full vertex stream (for UVs),
+// no color output. Discards exactly where lighting.frag's ALPHA_TEST does,
+// so the lit pass finds the depth it expects.
+
+layout(location = 1) in vec2 vUV;
+layout(location = 4) flat in uint vMaterial;
+
+struct MaterialData
+{
+    uint albedoIndex;
+    uint normalIndex;
+    uint padding0;
+    uint padding1;
+};
+
+// ===== Material table (set = 1, see VulkanMaterialDescriptors) =====
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+layout(std430, set = 1, binding = 1) readonly buffer Materials
+{
+    MaterialData materials[];
+};
+
+void main()
+{
+    // Indirect batches mix materials: the index may differ per instance
+    uint albedoIndex = materials[vMaterial].albedoIndex;
+    if (texture(textures[nonuniformEXT(albedoIndex)], vUV).a < 0.5)
+        discard;
+}
@@ -0,0 +1,29 @@
+#version 450
+
+// Depth pre-pass: positions only (Mesh's position-only stream), no fragment
+// stage. gl_Position must come out bit-identical to lighting.vert's, or the
+// EQUAL depth test of the lit pass drops pixels: same expression, invariant.
+
+layout(location = 0) in vec3 inPosition;
+
+layout(set = 0, binding = 0) uniform SceneUBO
+{
+    mat4 view;
+    mat4 proj;
+} scene;
+
+// Same block as lighting.vert (shared pipeline layout); only model is read
+layout(push_constant) uniform PushConstants
+{
+    mat4 model;
+    mat3 normalMatrix;
+    uvec4 lights;
+} pc;
+
+invariant gl_Position;
+
+void main()
+{
+    vec4 worldPos = pc.model * vec4(inPosition, 1.0);
+    gl_Position = scene.proj * scene.view * worldPos;
+}
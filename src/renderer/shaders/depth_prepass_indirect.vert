@@ -0,0 +1,41 @@
+#version 450
+
+// depth_prepass.vert for the GPU-culled path: the model matrix comes from
+// the visible instance list, as in lighting_indirect.vert.
+
+layout(location = 0) in vec3 inPosition;
+
+layout(set = 0, binding = 0) uniform SceneUBO
+{
+    mat4 view;
+    mat4 proj;
+} scene;
+
+struct InstanceData
+{
+    mat4 model;
+    mat3 normalMatrix;
+    vec4 sphere;
+    uvec4 info;
+    uvec4 lights;
+};
+
+layout(std430, set = 2, binding = 0) readonly buffer Instances
+{
+    InstanceData instances[];
+};
+
+layout(std430, set = 2, binding = 2) readonly buffer VisibleInstances
+{
+    uint visibleIds[];
+};
+
+invariant gl_Position;
+
+void main()
+{
+    uint id = visibleIds[gl_InstanceIndex];
+
+    vec4 worldPos = instances[id].model * vec4(inPosition, 1.0);
+    gl_Position = scene.proj * scene.view * worldPos;
+}
@@ -1,11 +1,28 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
-#define MAX_POINT_LIGHTS 32
 #define MAX_SPOT_LIGHTS  16
+#define MAX_LIGHTS_PER_CLUSTER 128
+#define CLUSTER_STRIDE (MAX_LIGHTS_PER_CLUSTER + 1)
+#define MAX_OBJECT_LIGHTS 4
+
+// Object light list entries (see LightCuller.h)
+#define SPOT_LIGHT_BIT 0x80000000u
+#define NO_LIGHT 0xFFFFFFFFu
+
+// ===== Permutation (specialization constants, see ShaderFeatures.h) =====
+// Defaults: every light through the clusters, no normal map, no alpha test
+layout(constant_id = 0) const uint POINT_LIGHT_LIMIT = MAX_LIGHTS_PER_CLUSTER; // per cluster
+layout(constant_id = 1) const uint SPOT_LIGHT_LIMIT = MAX_SPOT_LIGHTS;
+layout(constant_id = 2) const bool NORMAL_MAPPING = false;
+layout(constant_id = 3) const bool ALPHA_TEST = false;
+layout(constant_id = 4) const bool OBJECT_LIGHT_LISTS = false; // vLights instead of clusters + all spots
 
 layout(location = 0) in vec3 vNormal;
 layout(location = 1) in vec2 vUV;
 layout(location = 2) in vec3 vWorldPos;
+layout(location = 3) flat in uvec4 vLights; // the draw's light list, strongest first
+layout(location = 4) flat in uint vMaterial; // material table entry
 
 layout(location = 0) out vec4 outColor;
 
@@ -35,52 +52,173 @@ struct SpotLight
     float outerCutoff;
 };
 
-layout(set = 0, binding = 0) uniform SceneUBO
+// ===== Sun + spot lights (set = 0, see VulkanLightStorage) =====
+layout(std430, set = 0, binding = 4) readonly buffer SceneLights
+{
+    DirectionalLight sun;
+    uint spotLightCount;
+    uint padding0;
+    uint padding1;
+    uint padding2;
+
+    SpotLight spotLights[];
+} lights;
+
+// ===== Light clusters (set = 0, see VulkanLightClusters) =====
+layout(std140, set = 0, binding = 1) uniform ClusterUniforms
 {
     mat4 view;
-    mat4 proj;
+    vec4 projParams;  // P00, P11, znear, zfar
+    vec4 sliceParams; // slices / log(zfar / znear), tile width px, tile height px, -
+    uvec4 grid;       // tiles x, tiles y, depth slices, point light count
+} clusters;
 
-    DirectionalLight sun;
+layout(std430, set = 0, binding = 2) readonly buffer PointLights
+{
+    PointLight pointLights[];
+};
 
-    uint pointLightCount;
-    uint spotLightCount;
-    vec2 padding;
+// Per cluster: light count, then its light indices
+layout(std430, set = 0, binding = 3) readonly buffer ClusterLights
+{
+    uint clusterLights[];
+};
 
-    PointLight pointLights[MAX_POINT_LIGHTS];
-    SpotLight  spotLights[MAX_SPOT_LIGHTS];
-} scene;
+struct MaterialData
+{
+    uint albedoIndex;
+    uint normalIndex;
+    uint padding0;
+    uint padding1;
+};
+
+// ===== Material table (set = 1, see VulkanMaterialDescriptors) =====
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+layout(std430, set = 1, binding = 1) readonly buffer Materials
+{
+    MaterialData materials[];
+};
+
+uint ClusterIndex(vec3 worldPos)
+{
+    float depth = -(clusters.view * vec4(worldPos, 1.0)).z;
+    float slice = log(max(depth, clusters.projParams.z) / clusters.projParams.z) * clusters.sliceParams.x;
 
-layout(set = 1, binding = 0) uniform sampler2D albedoTex;
+    uvec3 cell = uvec3(
+        min(uvec2(gl_FragCoord.xy / clusters.sliceParams.yz), clusters.grid.xy - 1u),
+        min(uint(slice), clusters.grid.z - 1u));
+
+    return cell.x + cell.y * clusters.grid.x + cell.z * clusters.grid.x * clusters.grid.y;
+}
+
+// Tangent frame from screen-space derivatives (Vertex3D has no tangents)
+mat3 CotangentFrame(vec3 N, vec3 p, vec2 uv)
+{
+    vec3 dp1 = dFdx(p);
+    vec3 dp2 = dFdy(p);
+    vec2 duv1 = dFdx(uv);
+    vec2 duv2 = dFdy(uv);
+
+    vec3 dp2perp = cross(dp2, N);
+    vec3 dp1perp = cross(N, dp1);
+    vec3 T = dp2perp * duv1.x + dp1perp * duv2.x;
+    vec3 B = dp2perp * duv1.y + dp1perp * duv2.y;
+
+    float invMax = inversesqrt(max(max(dot(T, T), dot(B, B)), 1e-12));
+    return mat3(T * invMax, B * invMax, N);
+}
+
+vec3 ShadePointLight(PointLight l, vec3 N)
+{
+    vec3 L = l.position - vWorldPos;
+    float dist = length(L);
+
+    if (dist >= l.radius)
+        return vec3(0.0);
+
+    L = normalize(L);
+    float diff = max(dot(N, L), 0.0);
+    float atten = 1.0 - (dist / l.radius);
+    return diff * l.color * l.intensity * atten;
+}
+
+// Cutoffs are cosines, inner > outer
+vec3 ShadeSpotLight(SpotLight l, vec3 N)
+{
+    vec3 L = l.position - vWorldPos;
+    float dist = length(L);
+
+    if (dist >= l.range)
+        return vec3(0.0);
+
+    L = normalize(L);
+    float theta = dot(-L, l.direction);
+    float cone = clamp((theta - l.outerCutoff) / max(l.innerCutoff - l.outerCutoff, 1e-4), 0.0, 1.0);
+    float diff = max(dot(N, L), 0.0);
+    float atten = 1.0 - (dist / l.range);
+    return diff * l.color * cone * atten;
+}
 
 void main()
 {
+    // Indirect batches mix materials: the indices may differ per instance
+    MaterialData material = materials[vMaterial];
+    vec4 albedoSample = texture(textures[nonuniformEXT(material.albedoIndex)], vUV);
+
+    if (ALPHA_TEST && albedoSample.a < 0.5)
+        discard;
+
+    vec3 albedo = albedoSample.rgb;
     vec3 N = normalize(vNormal);
-    vec3 albedo = texture(albedoTex, vUV).rgb;
+
+    // Uniform branch: the constant is known when the pipeline is built
+    if (NORMAL_MAPPING)
+    {
+        vec3 tangentN = texture(textures[nonuniformEXT(material.normalIndex)], vUV).xyz * 2.0 - 1.0;
+        N = normalize(CotangentFrame(N, vWorldPos, vUV) * tangentN);
+    }
 
     vec3 result = vec3(0.0);
 
     // Directional light
     {
-        vec3 L = normalize(-scene.sun.direction);
+        vec3 L = normalize(-lights.sun.direction);
         float diff = max(dot(N, L), 0.0);
-        result += diff * scene.sun.color * scene.sun.intensity;
+        result += diff * lights.sun.color * lights.sun.intensity;
     }
 
-    // Point lights
-    for (uint i = 0; i < scene.pointLightCount; i++)
+    if (OBJECT_LIGHT_LISTS)
     {
-        PointLight l = scene.pointLights[i];
-        vec3 L = l.position - vWorldPos;
-        float dist = length(L);
-
-        if (dist < l.radius)
+        // Point + spot lights picked for this object on the CPU
+        for (uint i = 0; i < MAX_OBJECT_LIGHTS; i++)
         {
-            L = normalize(L);
-            float diff = max(dot(N, L), 0.0);
-            float atten = 1.0 - (dist / l.radius);
-            result += diff * l.color * l.intensity * atten;
+            uint entry = vLights[i];
+            if (entry == NO_LIGHT)
+                break;
+
+            if ((entry & SPOT_LIGHT_BIT) != 0u)
+                result += ShadeSpotLight(lights.spotLights[entry & ~SPOT_LIGHT_BIT], N);
+            else
+                result += ShadePointLight(pointLights[entry], N);
         }
     }
+    else
+    {
+        // Point lights: only those listed by this fragment's cluster (no lookup
+        // at all when the limit is 0, or the clusters were not built this frame)
+        bool clustered = POINT_LIGHT_LIMIT > 0u && clusters.grid.w > 0u;
+        uint clusterBase = clustered ? ClusterIndex(vWorldPos) * CLUSTER_STRIDE : 0u;
+        uint pointCount = clustered ? min(clusterLights[clusterBase], POINT_LIGHT_LIMIT) : 0u;
+        for (uint i = 0; i < pointCount; i++)
+            result += ShadePointLight(pointLights[clusterLights[clusterBase + 1u + i]], N);
+
+        // Spot lights
+        uint spotCount = min(lights.spotLightCount, SPOT_LIGHT_LIMIT);
+        for (uint i = 0; i < spotCount; i++)
+            result += ShadeSpotLight(lights.spotLights[i], N);
+    }
+
     vec3 ambient = albedo * 0.15;
     outColor = vec4(ambient + albedo * result, 1.0);
 }
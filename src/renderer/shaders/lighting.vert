@@ -18,12 +18,19 @@ layout(set = 0, binding = 0) uniform SceneUBO
 layout(push_constant) uniform PushConstants
 {
     mat4 model;
+    mat3 normalMatrix; // inverse-transpose of model, precomputed on the CPU
+    uvec4 lights;      // LightCuller entries (OBJECT_LIGHT_LISTS only)
 } pc;
 
+// Bit-identical to the depth pre-pass (EQUAL depth test)
+invariant gl_Position;
+
 // ===== Outputs to Fragment Shader =====
 layout(location = 0) out vec3 vNormal;
 layout(location = 1) out vec2 vUV;
 layout(location = 2) out vec3 vWorldPos;
+layout(location = 3) flat out uvec4 vLights;
+layout(location = 4) flat out uint vMaterial; // material table entry
 
 void main()
 {
@@ -32,11 +39,12 @@ void main()
     vWorldPos = worldPos.xyz;
 
     // Normal matrix (correct for non-uniform scale)
-    mat3 normalMat = mat3(transpose(inverse(pc.model)));
-    vNormal = normalize(normalMat * inNormal);
+    vNormal = normalize(pc.normalMatrix * inNormal);
 
-    // UV passthrough
+    // UV + light list passthrough; the draw's firstInstance is its material
     vUV = inUV;
+    vLights = pc.lights;
+    vMaterial = uint(gl_InstanceIndex);
 
     // Final clip-space position
     gl_Position = scene.proj * scene.view * worldPos;
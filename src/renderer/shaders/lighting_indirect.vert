@@ -0,0 +1,63 @@
+#version 450
+
+// Same as lighting.vert, but the model and normal matrices come from the
+// GPU-culled instance list instead of push constants.
+
+// ===== Vertex Inputs =====
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inUV;
+
+// ===== Scene UBO (set = 0) =====
+layout(set = 0, binding = 0) uniform SceneUBO
+{
+    mat4 view;
+    mat4 proj;
+} scene;
+
+// ===== Instances (set = 2, written by cull.comp) =====
+struct InstanceData
+{
+    mat4 model;
+    mat3 normalMatrix; // precomputed on the CPU
+    vec4 sphere;
+    uvec4 info;   // x = batch index, y = material index
+    uvec4 lights; // LightCuller entries
+};
+
+layout(std430, set = 2, binding = 0) readonly buffer Instances
+{
+    InstanceData instances[];
+};
+
+layout(std430, set = 2, binding = 2) readonly buffer VisibleInstances
+{
+    uint visibleIds[];
+};
+
+// Bit-identical to the depth pre-pass (EQUAL depth test)
+invariant gl_Position;
+
+// ===== Outputs to Fragment Shader =====
+layout(location = 0) out vec3 vNormal;
+layout(location = 1) out vec2 vUV;
+layout(location = 2) out vec3 vWorldPos;
+layout(location = 3) flat out uvec4 vLights;
+layout(location = 4) flat out uint vMaterial; // material table entry
+
+void main()
+{
+    // gl_InstanceIndex already includes the batch's firstInstance
+    uint id = visibleIds[gl_InstanceIndex];
+
+    vec4 worldPos = instances[id].model * vec4(inPosition, 1.0);
+    vWorldPos = worldPos.xyz;
+
+    vNormal = normalize(instances[id].normalMatrix * inNormal);
+
+    vUV = inUV;
+    vLights = instances[id].lights;
+    vMaterial = instances[id].info.y;
+
+    gl_Position = scene.proj * scene.view * worldPos;
+}
@@ -0,0 +1,43 @@
+#version 450
+
+// Reference variant of lighting.vert for --bench-vertex only: rebuilds the
+// normal matrix per vertex with inverse(), as lighting.vert used to.
+// Same interface as lighting.vert so it can share its pipeline layout.
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inUV;
+
+layout(set = 0, binding = 0) uniform SceneUBO
+{
+    mat4 view;
+    mat4 proj;
+} scene;
+
+layout(push_constant) uniform PushConstants
+{
+    mat4 model;
+    mat3 normalMatrix; // unused here
+    uvec4 lights;
+} pc;
+
+layout(location = 0) out vec3 vNormal;
+layout(location = 1) out vec2 vUV;
+layout(location = 2) out vec3 vWorldPos;
+layout(location = 3) flat out uvec4 vLights;
+layout(location = 4) flat out uint vMaterial;
+
+void main()
+{
+    vec4 worldPos = pc.model * vec4(inPosition, 1.0);
+    vWorldPos = worldPos.xyz;
+
+    mat3 normalMat = mat3(transpose(inverse(pc.model)));
+    vNormal = normalize(normalMat * inNormal);
+
+    vUV = inUV;
+    vLights = pc.lights;
+    vMaterial = uint(gl_InstanceIndex);
+
+    gl_Position = scene.proj * scene.view * worldPos;
+}